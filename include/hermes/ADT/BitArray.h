@@ -11,6 +11,7 @@
 #include "llvh/Support/MathExtras.h"
 
 #include <array>
+#include <atomic>
 #include <bitset>
 
 #pragma GCC diagnostic push
@@ -142,6 +143,21 @@ class BitArray {
       allBits_[wordIdx] &= ~mask;
   }
 
+  /// Atomically set the bit at \p idx to 1.
+  /// \return the previous value of the bit. Concurrent calls to this function
+  /// on the same array are safe, but not concurrent calls to \c set.
+  inline bool atomicTestAndSet(size_t idx) {
+    static_assert(
+        sizeof(std::atomic<uintptr_t>) == sizeof(uintptr_t) &&
+            std::atomic<uintptr_t>::is_always_lock_free,
+        "Words must be usable as lock-free atomics");
+    assert(idx < N && "Index must be within the bitset");
+    const uintptr_t mask = 1ULL << (idx % kBitsPerWord);
+    const size_t wordIdx = idx / kBitsPerWord;
+    auto *word = reinterpret_cast<std::atomic<uintptr_t> *>(&allBits_[wordIdx]);
+    return word->fetch_or(mask, std::memory_order_relaxed) & mask;
+  }
+
   /// Set all bits to 0.
   inline void reset() {
     std::fill_n(allBits_.begin(), kNumWords, 0);
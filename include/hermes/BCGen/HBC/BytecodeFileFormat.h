@@ -33,6 +33,11 @@ const static uint64_t DELTA_MAGIC = ~MAGIC;
 /// Property cache index which indicates no caching.
 static constexpr uint8_t PROPERTY_CACHING_DISABLED = 0;
 
+/// Highest property cache index that fits in the UInt8 cache operand of most
+/// property access instructions. Only the Long variants of the *ById
+/// instructions can encode higher indices.
+static constexpr uint16_t PROPERTY_CACHE_SHORT_INDEX_MAX = UINT8_MAX;
+
 /// Alignment of data structures of in file.
 static constexpr size_t BYTECODE_ALIGNMENT = alignof(uint32_t);
 
@@ -267,8 +272,8 @@ static_assert(
   V(uint32_t, uint32_t, frameSize, 7)            \
   /* fourth word, with flags below */            \
   V(uint32_t, uint8_t, environmentSize, 8)       \
-  V(uint8_t, uint8_t, highestReadCacheIndex, 8)  \
-  V(uint8_t, uint8_t, highestWriteCacheIndex, 8)
+  V(uint16_t, uint8_t, highestReadCacheIndex, 8) \
+  V(uint16_t, uint8_t, highestWriteCacheIndex, 8)
 
 /**
  * Metadata of a function.
@@ -288,8 +293,8 @@ struct FunctionHeader {
       uint32_t frameSize,
       uint32_t envSize,
       uint32_t functionNameID,
-      uint8_t hiRCacheIndex,
-      uint8_t hiWCacheIndex)
+      uint16_t hiRCacheIndex,
+      uint16_t hiWCacheIndex)
       : offset(0),
         paramCount(paramCount),
         bytecodeSizeInBytes(size),
@@ -96,8 +96,8 @@ class BytecodeFunctionGenerator : public BytecodeInstructionGenerator {
   bool complete_{false};
 
   /// Highest accessed property cache indices in this function.
-  uint8_t highestReadCacheIndex_{0};
-  uint8_t highestWriteCacheIndex_{0};
+  uint16_t highestReadCacheIndex_{0};
+  uint16_t highestWriteCacheIndex_{0};
 
   /// The jump table for this function (if any)
   /// this vector consists of jump table for each SwitchImm instruction,
@@ -232,13 +232,13 @@ class BytecodeFunctionGenerator : public BytecodeInstructionGenerator {
     return frameSize_;
   }
 
-  void setHighestReadCacheIndex(uint8_t sz) {
+  void setHighestReadCacheIndex(uint16_t sz) {
     assert(
         !complete_ &&
         "Cannot modify BytecodeFunction after call to bytecodeGenerationComplete.");
     this->highestReadCacheIndex_ = sz;
   }
-  void setHighestWriteCacheIndex(uint8_t sz) {
+  void setHighestWriteCacheIndex(uint16_t sz) {
     assert(
         !complete_ &&
         "Cannot modify BytecodeFunction after call to bytecodeGenerationComplete.");
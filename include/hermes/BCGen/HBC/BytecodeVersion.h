@@ -19,8 +19,8 @@ namespace hermes {
 namespace hbc {
 
 // Bytecode version generated by this version of the compiler.
-// Updated: Aug 16, 2023
-const static uint32_t BYTECODE_VERSION = 96;
+// Updated: Oct 16, 2026
+const static uint32_t BYTECODE_VERSION = 99;
 
 } // namespace hbc
 } // namespace hermes
@@ -178,17 +178,42 @@ class HBCISel {
   void verifyCall(CallInst *Inst);
 
   /// The last emitted property cache index.
-  uint8_t lastPropertyReadCacheIndex_{0};
-  uint8_t lastPropertyWriteCacheIndex_{0};
+  uint16_t lastPropertyReadCacheIndex_{0};
+  uint16_t lastPropertyWriteCacheIndex_{0};
 
   /// Map from property name to the read/write cache index for that name.
-  llvh::DenseMap<unsigned /* name */, uint8_t> propertyReadCacheIndexForId_;
-  llvh::DenseMap<unsigned /* name */, uint8_t> propertyWriteCacheIndexForId_;
+  llvh::DenseMap<unsigned /* name */, uint16_t> propertyReadCacheIndexForId_;
+  llvh::DenseMap<unsigned /* name */, uint16_t> propertyWriteCacheIndexForId_;
+
+  /// Cache indices assigned up front by assignPropertyCacheIndices(), for
+  /// functions with more read or write caches than fit in a UInt8 operand.
+  /// Instructions not in this map are assigned an index on first use.
+  llvh::DenseMap<Instruction *, uint16_t> propertyCacheIndexForInst_;
+
+  /// If the function needs more than PROPERTY_CACHE_SHORT_INDEX_MAX read or
+  /// write caches, assign all of them ahead of code generation, giving the
+  /// short indices to the sites with the highest static access frequency.
+  /// Remaining named accesses get long indices (used by the *ByIdLong
+  /// instructions), and remaining keyed accesses are left uncached.
+  void assignPropertyCacheIndices(llvh::ArrayRef<BasicBlock *> order);
+
+  /// If \p inst was assigned a cache index by assignPropertyCacheIndices(),
+  /// store it in \p idx and \return true.
+  bool findAssignedPropertyCacheIndex(Instruction *inst, uint16_t &idx);
+
+  /// Compute and return the index to use for caching the read/write of a
+  /// property with the given identifier name by \p inst.
+  uint16_t acquirePropertyReadCacheIndex(Instruction *inst, unsigned id);
+  uint16_t acquirePropertyWriteCacheIndex(Instruction *inst, unsigned id);
 
   /// Compute and return the index to use for caching the read/write of a
-  /// property with the given identifier name.
-  uint8_t acquirePropertyReadCacheIndex(unsigned id);
-  uint8_t acquirePropertyWriteCacheIndex(unsigned id);
+  /// property whose name \p prop is only known at runtime. Such sites always
+  /// get a cache index of their own, since the names they observe are
+  /// unrelated to any other site. Keys known to be numbers are served by the
+  /// indexed fast path and don't consume a cache index. The result always
+  /// fits in a UInt8 operand.
+  uint8_t acquireKeyedPropertyReadCacheIndex(Instruction *inst, Value *prop);
+  uint8_t acquireKeyedPropertyWriteCacheIndex(Instruction *inst, Value *prop);
 
   /// A cache mapping from buffer ID to filelname+source map.
   FileAndSourceMapIdCache &fileAndSourceMapIdCache_;
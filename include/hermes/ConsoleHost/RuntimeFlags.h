@@ -119,6 +119,27 @@ static opt<bool> Intl(
     init(RuntimeConfig::getDefaultIntl()),
     cat(RuntimeCategory));
 
+static opt<hermes::vm::RegExpEngine> RegExpEngine(
+    "Xregex-engine",
+    desc("Choose the executor that runs regular expressions"),
+    llvh::cl::values(
+        clEnumValN(
+            hermes::vm::RegExpEngine::Auto,
+            "auto",
+            "Backtrack, switching to the linear-time executor when "
+            "backtracking gets excessive (default)"),
+        clEnumValN(
+            hermes::vm::RegExpEngine::Backtracking,
+            "backtracking",
+            "Always backtrack"),
+        clEnumValN(
+            hermes::vm::RegExpEngine::Linear,
+            "linear",
+            "Use the linear-time executor for regexes without backreferences "
+            "or lookarounds")),
+    init(RuntimeConfig::getDefaultRegExpEngine()),
+    cat(RuntimeCategory));
+
 static opt<bool> MicrotaskQueue(
     "Xmicrotask-queue",
     desc("Enable support for using microtasks"),
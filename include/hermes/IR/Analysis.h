@@ -99,12 +99,19 @@ class PostOrderAnalysis {
 class LoopAnalysis {
   template <typename T>
   using BlockMap = llvh::SmallDenseMap<const BasicBlock *, T, 16>;
+  /// A set of header blocks. It has a small inline size because we store one
+  /// for every block in a loop, and very deeply nested loops (leading to many
+  /// headers) are not that common.
+  using TinyBlockSet = llvh::SmallPtrSet<BasicBlock *, 2>;
 
   /// Mapping from each block to the header of the enclosing loop, or to null if
   /// the block is in a cycle but has no unique header.
   BlockMap<BasicBlock *> blockToHeader_{};
   /// Mapping from each header block to its preheader block.
   BlockMap<BasicBlock *> headerToPreheader_{};
+  /// Mapping from each block in a loop to the headers of all the loops that
+  /// enclose it, including headers that don't dominate their loop.
+  BlockMap<TinyBlockSet> blockToHeaders_{};
 
  public:
   explicit LoopAnalysis(Function *F, const DominanceInfo &dominanceInfo);
@@ -125,6 +132,9 @@ class LoopAnalysis {
   /// \returns The preheader block of the loop enclosing \p BB, or null if \p BB
   /// is not in a loop with a unique header and preheader.
   BasicBlock *getLoopPreheader(const BasicBlock *BB) const;
+  /// \returns True if \p BB is in the loop whose header is \p header, either
+  /// directly or in a nested loop.
+  bool isBlockInLoop(const BasicBlock *BB, BasicBlock *header) const;
 };
 
 /// This analysis generates the scope info for each function.
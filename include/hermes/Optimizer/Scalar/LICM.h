@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_OPTIMIZER_SCALAR_LICM_H
+#define HERMES_OPTIMIZER_SCALAR_LICM_H
+
+#include "hermes/IR/IR.h"
+#include "hermes/Optimizer/PassManager/Pass.h"
+
+namespace hermes {
+
+/// Hoists loop-invariant computations and loads of variables that the loop
+/// doesn't write into the preheader of the loop, so they are evaluated once
+/// instead of on every iteration.
+class LICM : public FunctionPass {
+ public:
+  explicit LICM() : FunctionPass("LICM") {}
+  ~LICM() override = default;
+
+  bool runOnFunction(Function *F) override;
+};
+
+} // namespace hermes
+
+#endif // HERMES_OPTIMIZER_SCALAR_LICM_H
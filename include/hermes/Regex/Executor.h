@@ -36,6 +36,12 @@ constexpr uint32_t kNotMatched = UINT32_MAX;
 /// The maximum number of times we will backtrack.
 constexpr uint32_t kBacktrackLimit = 1u << 30;
 
+/// The fewest times we will backtrack before giving up on the backtracking
+/// executor in favor of the linear-time executor, for regexes it can run. The
+/// budget grows with the size of the regex and of the input, so that the work
+/// wasted backtracking is bounded by the work of the linear-time executor.
+constexpr uint32_t kLinearFallbackMinBacktracks = 1u << 16;
+
 /// A CapturedRange represents a range of the input string captured by a capture
 /// group. A CaptureGroup may also not have matched, in which case its start is
 /// set to kNotMatched. Note that an unmatched capture group is different than a
@@ -66,6 +66,9 @@ class Regex {
   // Constraints on the type of strings that can match this regex.
   MatchConstraintSet matchConstraints_ = 0;
 
+  // Where matches of this regex can start.
+  MatchPrefilter prefilter_ = MatchPrefilter::none();
+
   // This holds the named capture groups in the order they were defined.
   std::deque<llvh::SmallVector<char16_t, 5>> orderedGroupNames_{};
 
@@ -144,7 +147,8 @@ class Regex {
         markedCount_,
         static_cast<uint16_t>(loopCount_),
         flags_.toByte(),
-        matchConstraints_};
+        matchConstraints_,
+        prefilter_};
     RegexBytecodeStream bcs(header);
     Node::compile(nodes_, bcs);
     return bcs.acquireBytecode();
@@ -358,6 +362,7 @@ constants::ErrorType Regex<Traits>::parseWithBackRefLimit(
 
   // Compute any match constraints.
   matchConstraints_ = Node::matchConstraintsForList(nodes_);
+  prefilter_ = Node::prefilterForList(nodes_);
 
   return result;
 }
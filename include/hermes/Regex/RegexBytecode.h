@@ -260,6 +260,72 @@ struct Width1LoopInsn : public Insn {
   JumpTarget32 notTakenTarget;
 };
 
+/// A conservative description of where matches of a regex can start, which
+/// lets the executor skip start positions without running the bytecode there.
+/// A position rejected by the prefilter can never start a match; one accepted
+/// by it still may not.
+struct MatchPrefilter {
+  /// Maximum number of code units in the literal prefix.
+  static constexpr uint32_t kMaxPrefixLength = 8;
+
+  /// Bitmap of the ASCII code units that a match can start with.
+  uint32_t asciiFirstChars[4];
+
+  /// Whether a match can start with a non-ASCII code unit.
+  bool nonASCIIFirstChar;
+
+  /// Number of valid code units in prefix.
+  uint8_t prefixLength;
+
+  /// Code units that every match starts with.
+  char16_t prefix[kMaxPrefixLength];
+
+  /// \return a prefilter which accepts no position, to be widened with the
+  /// add functions below.
+  static MatchPrefilter none() {
+    return MatchPrefilter{{0, 0, 0, 0}, false, 0, {}};
+  }
+
+  /// Accept any code unit as the start of a match.
+  void addAll() {
+    for (uint32_t &word : asciiFirstChars)
+      word = ~0u;
+    nonASCIIFirstChar = true;
+  }
+
+  /// Accept the code point \p cp, or the leading surrogate of it, as the start
+  /// of a match.
+  void addChar(uint32_t cp) {
+    if (cp < 128)
+      asciiFirstChars[cp / 32] |= 1u << (cp % 32);
+    else
+      nonASCIIFirstChar = true;
+  }
+
+  /// Accept the code points in [\p first, \p last] as the start of a match.
+  void addRange(uint32_t first, uint32_t last) {
+    for (uint32_t cp = first; cp <= last && cp < 128; ++cp)
+      addChar(cp);
+    if (last >= 128)
+      nonASCIIFirstChar = true;
+  }
+
+  /// \return whether every position is accepted, so that checking the
+  /// prefilter is pointless.
+  bool acceptsAll() const {
+    return nonASCIIFirstChar && asciiFirstChars[0] == ~0u &&
+        asciiFirstChars[1] == ~0u && asciiFirstChars[2] == ~0u &&
+        asciiFirstChars[3] == ~0u;
+  }
+
+  /// \return whether a match may start with the code unit \p c.
+  bool mayStartWith(uint32_t c) const {
+    if (c < 128)
+      return asciiFirstChars[c / 32] & (1u << (c % 32));
+    return nonASCIIFirstChar;
+  }
+};
+
 /// A header that appears at the beginning of a bytecode stream.
 struct RegexBytecodeHeader {
   /// Number of capture groups.
@@ -273,6 +339,9 @@ struct RegexBytecodeHeader {
 
   /// Constraints on what strings can match this regex.
   MatchConstraintSet constraints;
+
+  /// Where matches of this regex can start.
+  MatchPrefilter prefilter;
 };
 
 LLVM_PACKED_END;
@@ -82,6 +82,46 @@ class Node {
     return result;
   }
 
+  /// Add the code units that a match of the list of nodes \p nodes can start
+  /// with to \p prefilter. \return whether every match of the list consumes
+  /// at least one character.
+  static bool addFirstCharsForList(
+      const NodeList &nodes,
+      MatchPrefilter *prefilter) {
+    for (const auto &node : nodes) {
+      if (node->addFirstChars(prefilter))
+        return true;
+    }
+    return false;
+  }
+
+  /// Append the characters that every match of the list of nodes \p nodes
+  /// starts with to \p prefix. \return whether the list matches exactly the
+  /// characters appended, so that any following nodes continue the prefix.
+  static bool appendLiteralPrefixForList(
+      const NodeList &nodes,
+      CodePointList *prefix) {
+    for (const auto &node : nodes) {
+      if (!node->appendLiteralPrefix(prefix))
+        return false;
+    }
+    return true;
+  }
+
+  /// \return the prefilter for the start positions of matches of the list of
+  /// nodes \p nodes.
+  static MatchPrefilter prefilterForList(const NodeList &nodes) {
+    MatchPrefilter result = MatchPrefilter::none();
+    if (!addFirstCharsForList(nodes, &result))
+      result.addAll();
+    CodePointList prefix;
+    appendLiteralPrefixForList(nodes, &prefix);
+    result.prefixLength =
+        std::min<size_t>(prefix.size(), MatchPrefilter::kMaxPrefixLength);
+    std::copy_n(prefix.begin(), result.prefixLength, result.prefix);
+    return result;
+  }
+
   /// Reverse the order of the node list \p nodes, and recursively ask each node
   /// to reverse the order of its children.
   inline static void reverseNodeList(NodeList &nodes);
@@ -111,6 +151,23 @@ class Node {
     return 0;
   }
 
+  /// Add the code units that a match of this node can start with to \p
+  /// prefilter. \return whether every match of this node consumes at least one
+  /// character, in which case the nodes after it don't affect how a match
+  /// starts. The default matches the empty string, which adds nothing.
+  virtual bool addFirstChars(MatchPrefilter *prefilter) const {
+    return false;
+  }
+
+  /// Append the characters that every match of this node starts with to \p
+  /// prefix. Only case-sensitive BMP characters that aren't surrogates are
+  /// appended, so that each is one code unit. \return whether the node
+  /// matches exactly the characters appended. The default matches the empty
+  /// string.
+  virtual bool appendLiteralPrefix(CodePointList *prefix) const {
+    return true;
+  }
+
   /// \return whether this is a goal node.
   virtual bool isGoal() const {
     return false;
@@ -152,6 +209,16 @@ class GoalNode final : public Node {
   bool isGoal() const override {
     return true;
   }
+
+  /// Reaching the goal means the match may be empty, so it can start anywhere.
+  bool addFirstChars(MatchPrefilter *prefilter) const override {
+    prefilter->addAll();
+    return true;
+  }
+
+  bool appendLiteralPrefix(CodePointList *prefix) const override {
+    return false;
+  }
 };
 
 class LoopNode final : public Node {
@@ -231,6 +298,20 @@ class LoopNode final : public Node {
     reverseNodeList(loopee_);
   }
 
+  /// A match starts like the loopee, and only consumes a character if the
+  /// loopee must run and always does.
+  bool addFirstChars(MatchPrefilter *prefilter) const override {
+    return addFirstCharsForList(loopee_, prefilter) && min_ > 0;
+  }
+
+  /// A loop that must run at least once starts with the loopee's prefix, but
+  /// nothing after the first iteration is known.
+  bool appendLiteralPrefix(CodePointList *prefix) const override {
+    if (min_ > 0)
+      appendLiteralPrefixForList(loopee_, prefix);
+    return false;
+  }
+
  private:
   /// Override of emitStep() to compile our looped expression and add a jump
   /// back to the loop.
@@ -368,6 +449,20 @@ class AlternationNode final : public Node {
     }
   }
 
+ protected:
+  /// A match starts like any of the alternatives.
+  bool addFirstChars(MatchPrefilter *prefilter) const override {
+    bool consumes = true;
+    for (const auto &alternative : alternatives_) {
+      consumes &= addFirstCharsForList(alternative, prefilter);
+    }
+    return consumes;
+  }
+
+  bool appendLiteralPrefix(CodePointList *prefix) const override {
+    return false;
+  }
+
  private:
   virtual NodeList *emitStep(RegexBytecodeStream &bcs) override {
     // Instruction stream looks like:
@@ -448,6 +543,15 @@ class MarkedSubexpressionNode final : public Node {
     return contentsConstraints_ | Super::matchConstraints();
   }
 
+ protected:
+  bool addFirstChars(MatchPrefilter *prefilter) const override {
+    return addFirstCharsForList(contents_, prefilter);
+  }
+
+  bool appendLiteralPrefix(CodePointList *prefix) const override {
+    return appendLiteralPrefixForList(contents_, prefix);
+  }
+
  private:
   virtual NodeList *emitStep(RegexBytecodeStream &bcs) override {
     if (!emitEnd_) {
@@ -473,6 +577,17 @@ class BackRefNode final : public Node {
     mexp_ = mexp;
   }
 
+ protected:
+  /// The referenced text isn't known, and may be empty.
+  bool addFirstChars(MatchPrefilter *prefilter) const override {
+    prefilter->addAll();
+    return false;
+  }
+
+  bool appendLiteralPrefix(CodePointList *prefix) const override {
+    return false;
+  }
+
  private:
   virtual NodeList *emitStep(RegexBytecodeStream &bcs) override {
     bcs.emit<BackRefInsn>()->mexp = mexp_;
@@ -561,6 +676,16 @@ class MatchAnyNode final : public Node {
     return !unicode_;
   }
 
+ protected:
+  bool addFirstChars(MatchPrefilter *prefilter) const override {
+    prefilter->addAll();
+    return true;
+  }
+
+  bool appendLiteralPrefix(CodePointList *prefix) const override {
+    return false;
+  }
+
  private:
   virtual NodeList *emitStep(RegexBytecodeStream &bcs) override {
     if (unicode_) {
@@ -650,6 +775,35 @@ class MatchCharNode final : public Node {
         !mayRequireDecodingSurrogatePair(chars_.front());
   }
 
+  bool addFirstChars(MatchPrefilter *prefilter) const override {
+    assert(!chars_.empty() && "MatchCharNode should not be empty");
+    CodePoint c = chars_.front();
+    prefilter->addChar(c);
+    if (icase_) {
+      if (c >= 'a' && c <= 'z')
+        prefilter->addChar(c - 'a' + 'A');
+      else if (c >= 'A' && c <= 'Z')
+        prefilter->addChar(c - 'A' + 'a');
+      // Without the unicode flag, ASCII and non-ASCII characters never
+      // canonicalize to each other. With it, case folding maps e.g. U+212A
+      // KELVIN SIGN to 'k' and U+017F LATIN SMALL LETTER LONG S to 's'.
+      if (unicode_)
+        prefilter->addAll();
+    }
+    return true;
+  }
+
+  bool appendLiteralPrefix(CodePointList *prefix) const override {
+    if (icase_)
+      return false;
+    for (CodePoint c : chars_) {
+      if (!isMemberOfBMP(c) || isHighSurrogate(c) || isLowSurrogate(c))
+        return false;
+      prefix->push_back(c);
+    }
+    return true;
+  }
+
   /// Emit a list of ASCII characters into bytecode stream \p bcs.
   void emitASCIIList(llvh::ArrayRef<CodePoint> chars, RegexBytecodeStream &bcs)
       const {
@@ -849,6 +1003,51 @@ class BracketNode : public Node {
     return !unicode_;
   }
 
+ protected:
+  bool addFirstChars(MatchPrefilter *prefilter) const override {
+    // Don't bother computing the complement of a negated bracket.
+    if (negate_) {
+      prefilter->addAll();
+      return true;
+    }
+    for (CharacterClass cc : classes_) {
+      if (cc.inverted_) {
+        prefilter->addAll();
+        return true;
+      }
+      switch (cc.type_) {
+        case CharacterClass::Digits:
+          prefilter->addRange('0', '9');
+          break;
+        case CharacterClass::Words:
+          prefilter->addRange('0', '9');
+          prefilter->addRange('A', 'Z');
+          prefilter->addRange('a', 'z');
+          prefilter->addChar('_');
+          // Case folding makes \w match some non-ASCII characters.
+          if (icase_ && unicode_)
+            prefilter->nonASCIIFirstChar = true;
+          break;
+        case CharacterClass::Spaces:
+          prefilter->addRange('\t', '\r');
+          prefilter->addChar(' ');
+          prefilter->nonASCIIFirstChar = true;
+          break;
+      }
+    }
+    CodePointSet cps = icase_
+        ? makeCanonicallyEquivalent(codePointSet_, unicode_)
+        : codePointSet_;
+    for (const CodePointRange &range : cps.ranges()) {
+      prefilter->addRange(range.first, range.first + range.length - 1);
+    }
+    return true;
+  }
+
+  bool appendLiteralPrefix(CodePointList *prefix) const override {
+    return false;
+  }
+
  private:
   virtual NodeList *emitStep(RegexBytecodeStream &bcs) override {
     if (unicode_) {
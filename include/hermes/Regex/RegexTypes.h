@@ -45,6 +45,13 @@ enum MatchFlagType {
 
   /// Do not search for a match past the search start location.
   matchOnlyAtStart = 1 << 3,
+
+  /// Always use the backtracking executor, even if it backtracks excessively.
+  matchForceBacktracking = 1 << 4,
+
+  /// Use the linear-time executor from the start whenever the regex can run on
+  /// it, instead of only after the backtracking executor gives up.
+  matchForceLinear = 1 << 5,
 };
 
 inline constexpr MatchFlagType operator~(MatchFlagType x) {
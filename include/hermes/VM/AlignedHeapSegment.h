@@ -176,6 +176,11 @@ class AlignedHeapSegment {
   /// Mark the given \p cell.  Assumes the given address is a valid heap object.
   inline static void setCellMarkBit(const GCCell *cell);
 
+  /// Atomically mark a given \p cell, and return whether it was already
+  /// marked. Unlike \c setCellMarkBit, this may race with other threads
+  /// marking cells in the same segment.
+  inline static bool testAndSetCellMarkBit(const GCCell *cell);
+
   /// Return whether the given \p cell is marked.  Assumes the given address is
   /// a valid heap object.
   inline static bool getCellMarkBit(const GCCell *cell);
@@ -351,6 +356,13 @@ void AlignedHeapSegment::setCellMarkBit(const GCCell *cell) {
   markBits->mark(ind);
 }
 
+/*static*/
+bool AlignedHeapSegment::testAndSetCellMarkBit(const GCCell *cell) {
+  MarkBitArrayNC *markBits = markBitArrayCovering(cell);
+  size_t ind = markBits->addressToIndex(cell);
+  return markBits->testAndMark(ind);
+}
+
 /*static*/
 bool AlignedHeapSegment::getCellMarkBit(const GCCell *cell) {
   MarkBitArrayNC *markBits = markBitArrayCovering(cell);
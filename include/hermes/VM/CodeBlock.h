@@ -17,6 +17,7 @@
 #include "hermes/VM/Profiler.h"
 #include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/SerializedLiteralParser.h"
+#include "llvh/ADT/DenseMap.h"
 #include "llvh/ADT/DenseSet.h"
 #include "llvh/ADT/Optional.h"
 #include "llvh/Support/TrailingObjects.h"
@@ -57,11 +58,28 @@ class CodeBlock final
 #endif
 
   /// Total size of the property cache.
-  const uint32_t propertyCacheSize_;
+  uint32_t propertyCacheSize_;
 
   /// Offset of the write property cache, which occurs after the read property
   /// cache.
-  const uint32_t writePropCacheOffset_;
+  uint32_t writePropCacheOffset_;
+
+  /// The property cache. It is allocated with the CodeBlock, except for lazy
+  /// CodeBlocks, which allocate it once they have been compiled and the number
+  /// of cache indices is known.
+  PropertyCacheEntry *propertyCache_;
+
+#ifndef HERMESVM_LEAN
+  /// The property cache of a lazy CodeBlock that has been compiled.
+  std::unique_ptr<PropertyCacheEntry[]> lazyPropertyCache_{};
+#endif
+
+  /// The out-of-line caches of the property access sites that have needed
+  /// one, indexed by the position of the site's entry in the property cache.
+  /// Most sites only ever observe a single class, so these are only allocated
+  /// on demand.
+  llvh::DenseMap<uint32_t, std::unique_ptr<PolymorphicPropertyCacheEntry>>
+      polymorphicCaches_{};
 
 #ifndef HERMESVM_LEAN
   /// Compiles a lazy CodeBlock. Intended to be called from lazyCompile.
@@ -75,13 +93,20 @@ class CodeBlock final
 
   /// \return the base pointer of the property cache.
   PropertyCacheEntry *propertyCache() {
-    return getTrailingObjects<PropertyCacheEntry>();
+    return propertyCache_;
   }
 
   PropertyCacheEntry *writePropertyCache() {
-    return getTrailingObjects<PropertyCacheEntry>() + writePropCacheOffset_;
+    return propertyCache_ + writePropCacheOffset_;
   }
 
+  /// Compute the size of the property cache needed by the function described
+  /// by \p header, and set \p readCacheSize to the size of its read cache.
+  /// \return the total size of the cache.
+  static uint32_t computePropertyCacheSize(
+      const hbc::RuntimeFunctionHeader &header,
+      uint32_t &readCacheSize);
+
   CodeBlock(
       RuntimeModule *runtimeModule,
       hbc::RuntimeFunctionHeader header,
@@ -94,7 +119,8 @@ class CodeBlock final
         bytecode_(bytecode),
         functionID_(functionID),
         propertyCacheSize_(cacheSize),
-        writePropCacheOffset_(writePropCacheOffset) {
+        writePropCacheOffset_(writePropCacheOffset),
+        propertyCache_(getTrailingObjects<PropertyCacheEntry>()) {
     std::uninitialized_fill_n(propertyCache(), cacheSize, PropertyCacheEntry{});
   }
 
@@ -267,18 +293,42 @@ class CodeBlock final
     return getLazyFunctionLoc(false);
   }
 
-  inline PropertyCacheEntry *getReadCacheEntry(uint8_t idx) {
+  inline PropertyCacheEntry *getReadCacheEntry(uint16_t idx) {
     assert(idx < writePropCacheOffset_ && "idx out of ReadCache bound");
     return &propertyCache()[idx];
   }
 
-  inline PropertyCacheEntry *getWriteCacheEntry(uint8_t idx) {
+  inline PropertyCacheEntry *getWriteCacheEntry(uint16_t idx) {
     assert(
         writePropCacheOffset_ + idx < propertyCacheSize_ &&
         "idx out of WriteCache bound");
     return &propertyCache()[writePropCacheOffset_ + idx];
   }
 
+  /// \return the out-of-line cache of the site whose entry is \p entry, or
+  /// nullptr if the site hasn't needed one yet.
+  PolymorphicPropertyCacheEntry *findPolymorphicCacheEntry(
+      const PropertyCacheEntry *entry) {
+    if (LLVM_LIKELY(polymorphicCaches_.empty()))
+      return nullptr;
+    auto it = polymorphicCaches_.find(entry - propertyCache());
+    return it != polymorphicCaches_.end() ? it->second.get() : nullptr;
+  }
+
+  /// \return the out-of-line cache of the site whose entry is \p entry,
+  /// allocating it if needed.
+  PolymorphicPropertyCacheEntry &getPolymorphicCacheEntry(
+      const PropertyCacheEntry *entry);
+
+  /// Record at the GetById/PutById site whose entry is \p entry that objects
+  /// of class \p clazz have the property at \p slot. The first class is
+  /// cached in \p entry itself, later ones out of line.
+  /// \return true if the pair was cached, false if the site is megamorphic.
+  bool insertCacheEntry(
+      PropertyCacheEntry *entry,
+      CompressedPointer clazz,
+      SlotIndex slot);
+
   // Mark all hidden classes in the property cache as roots.
   void markCachedHiddenClasses(Runtime &runtime, WeakRootAcceptor &acceptor);
 
@@ -291,7 +341,9 @@ class CodeBlock final
   /// \return an estimate of the size of additional memory used by this
   /// CodeBlock.
   size_t additionalMemorySize() const {
-    return propertyCacheSize_ * sizeof(PropertyCacheEntry);
+    return propertyCacheSize_ * sizeof(PropertyCacheEntry) +
+        polymorphicCaches_.getMemorySize() +
+        polymorphicCaches_.size() * sizeof(PolymorphicPropertyCacheEntry);
   }
 
 #ifdef HERMES_ENABLE_DEBUGGER
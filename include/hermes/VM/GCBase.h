@@ -69,6 +69,7 @@ enum XorPtrKeyID {
   ArrayBufferData,
   JSFunctionCodeBlock,
   DummyObjectFinalizerCallback,
+  OrderedHashMapIndex,
   _NumKeys
 };
 
@@ -14,9 +14,11 @@
 #include "hermes/VM/HeapAlign.h"
 #include "hermes/VM/VTable.h"
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #pragma GCC diagnostic push
 
 #ifdef HERMES_COMPILER_SUPPORTS_WSHORTEN_64_TO_32
@@ -106,6 +108,18 @@ class GCCell {
   uint32_t _debugAllocationId_;
 #endif
 
+  /// \return the header of this cell, viewed as an atomic so that it can be
+  /// read and forwarded by several threads at once.
+  std::atomic<CompressedPointer::RawType> &atomicHeader() const {
+    static_assert(
+        sizeof(std::atomic<CompressedPointer::RawType>) ==
+                sizeof(KindAndSize) &&
+            std::atomic<CompressedPointer::RawType>::is_always_lock_free,
+        "The header must be accessible as a lock-free atomic");
+    return *reinterpret_cast<std::atomic<CompressedPointer::RawType> *>(
+        const_cast<KindAndSize *>(&kindAndSize_));
+  }
+
  public:
   GCCell() = default;
 
@@ -218,6 +232,40 @@ class GCCell {
     return isMarked();
   }
 
+  /// The next two functions implement marked forwarding pointers that several
+  /// threads may try to set at once. Only one of them succeeds, and the others
+  /// must use the forwarding pointer it set.
+
+  /// Read the header of this cell atomically.
+  /// \return the marked forwarding pointer if one has been set. Otherwise,
+  ///   store the header in \p kindAndSize and return a null pointer.
+  /// NOTE: this should only be used by the GC.
+  CompressedPointer loadHeaderAtomic(KindAndSize &kindAndSize) const {
+    const auto raw = atomicHeader().load(std::memory_order_acquire);
+    if (raw & 0x1)
+      return CompressedPointer::fromRaw(raw - 0x1);
+    std::memcpy(&kindAndSize, &raw, sizeof(raw));
+    return CompressedPointer{nullptr};
+  }
+
+  /// Atomically replace the header \p kindAndSize of this cell with a marked
+  /// forwarding pointer to \p cell, unless another thread forwarded this cell
+  /// first.
+  /// \return the forwarding pointer that is now set, which is \p cell if this
+  ///   call set it.
+  /// NOTE: this should only be used by the GC.
+  CompressedPointer casMarkedForwardingPointer(
+      KindAndSize kindAndSize,
+      CompressedPointer cell) {
+    CompressedPointer::RawType expected;
+    std::memcpy(&expected, &kindAndSize, sizeof(expected));
+    if (atomicHeader().compare_exchange_strong(
+            expected, cell.getRaw() | 0x1, std::memory_order_acq_rel))
+      return cell;
+    assert((expected & 0x1) && "Header changed without being forwarded");
+    return CompressedPointer::fromRaw(expected - 0x1);
+  }
+
   const GCCell *nextCell() const {
     return reinterpret_cast<const GCCell *>(
         reinterpret_cast<const char *>(this) + getAllocatedSize());
@@ -322,6 +322,10 @@ class HadesGC final : public GCBase {
     return calledByBackgroundThread() || inGC();
   }
 
+  /// \return true if this thread holds gcMutex_, or is a helper thread running
+  /// part of a collection for the thread that holds it.
+  bool holdsGCMutex() const;
+
   /// Return true if \p ptr is currently pointing at valid accessable memory,
   /// allocated to an object.
   bool validPointer(const void *ptr) const override;
@@ -347,6 +351,10 @@ class HadesGC final : public GCBase {
   class MarkWeakRootsAcceptor;
   class OldGen;
   class Executor;
+  class WorkerPool;
+  class SharedWorklist;
+  class ParallelMarker;
+  class ParallelEvacuator;
 
   struct CopyListCell final : public GCCell {
     // Linked list of cells pointing to the next cell that was copied.
@@ -408,6 +416,10 @@ class HadesGC final : public GCBase {
     /// \post This function either successfully allocates, or reports OOM.
     GCCell *alloc(uint32_t sz);
 
+    /// Give the \p sz bytes at \p addr, which are the unused end of a region
+    /// returned by alloc(), back to the free list.
+    void freeUnusedBytes(void *addr, uint32_t sz);
+
     /// \return the total number of bytes that are in use by the OG section of
     /// the JS heap, including any bytes allocated in a pending compactee, and
     /// excluding free list entries.
@@ -732,6 +744,18 @@ class HadesGC final : public GCBase {
   /// concurrently with the mutator.
   std::unique_ptr<Executor> backgroundExecutor_;
 
+  /// Helper threads used to parallelize parts of a collection. Null if
+  /// parallel collection is disabled.
+  std::unique_ptr<WorkerPool> workerPool_;
+
+  /// Shares old gen marking work between whichever thread drains
+  /// oldGenMarker_ and workerPool_. Null if parallel marking is disabled.
+  std::unique_ptr<ParallelMarker> parallelMarker_;
+
+  /// Evacuates the YG using workerPool_. Null if parallel YG collection is
+  /// disabled.
+  std::unique_ptr<ParallelEvacuator> parallelEvacuator_;
+
   /// True from the time the background task is created, to the time it exits
   /// the collection loop. False otherwise. Protected by gcMutex_.
   bool backgroundTaskActive_{false};
@@ -876,6 +900,11 @@ class HadesGC final : public GCBase {
   template <typename Acceptor>
   void youngGenEvacuateImpl(Acceptor &acceptor, bool doCompaction);
 
+  /// Evacuate the cells directly reachable from the roots, including the
+  /// values of WeakMap entries, as part of a YG collection.
+  template <typename Acceptor>
+  void youngGenEvacuateRoots(Acceptor &acceptor, bool doCompaction);
+
   /// In the "no GC before TTI" mode, move the Young Gen heap segment to the
   /// Old Gen without scanning for garbage.
   /// \return true if a promotion occurred, false if it did not.
@@ -965,10 +994,11 @@ class HadesGC final : public GCBase {
   void finalizeCompactee();
 
   /// Search a single segment for pointers that may need to be updated as the
-  /// YG/compactee are evacuated.
-  template <bool CompactionEnabled>
+  /// YG/compactee are evacuated. \p visitor either updates them, or records
+  /// them to be updated later by a ParallelEvacuator.
+  template <typename Acceptor>
   void scanDirtyCardsForSegment(
-      SlotVisitor<EvacAcceptor<CompactionEnabled>> &visitor,
+      SlotVisitor<Acceptor> &visitor,
       HeapSegment &segment);
 
   /// Find all pointers from OG into the YG/compactee during a YG collection.
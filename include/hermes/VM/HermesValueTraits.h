@@ -39,7 +39,7 @@ HERMES_VM_GCOBJECT(Domain);
 HERMES_VM_GCOBJECT(Environment);
 HERMES_VM_GCOBJECT(FinalizableNativeFunction);
 HERMES_VM_GCOBJECT(GeneratorInnerFunction);
-HERMES_VM_GCOBJECT(HashMapEntry);
+HERMES_VM_GCOBJECT(HashMapGeneration);
 HERMES_VM_GCOBJECT(HiddenClass);
 HERMES_VM_GCOBJECT(HostObject);
 HERMES_VM_GCOBJECT(JSArray);
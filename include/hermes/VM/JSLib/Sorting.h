@@ -10,6 +10,7 @@
 
 #include <cstdint>
 
+#include "hermes/Support/OptValue.h"
 #include "hermes/VM/CallResult.h"
 
 /// Defines custom sorting routines used in cases that we can't use std::sort.
@@ -26,6 +27,8 @@ namespace vm {
 /// implementation of \c swap and \c less can call property accessors
 /// which evaluate JavaScript.  For now, we don't rename these
 /// methods.
+/// A model can optionally provide temporary slots and a copy operation, which
+/// allow runs to be merged with far fewer element moves than with swaps alone.
 class SortModel {
  public:
   // Swap elements at indices a and b.
@@ -35,12 +38,25 @@ class SortModel {
   // Return negative if [a] < [b], positive if [a] > [b], 0 if [a] = [b]
   virtual CallResult<int> compare(uint32_t a, uint32_t b) = 0;
 
+  // Reserve count temporary slots, which may then be used as indices in
+  // compare and copy. Return the index of the first slot, or None if the
+  // model doesn't support temporary slots, in which case copy is never called.
+  virtual CallResult<OptValue<uint32_t>> reserveTemp(uint32_t count);
+
+  // Copy the element at index from over the element at index to.
+  virtual ExecutionStatus copy(uint32_t from, uint32_t to);
+
   virtual ~SortModel() = 0;
 };
 
-/// QuickSort to sort elements in the range [begin, end). Returns immediately
-/// with ExecutionStatus::EXCEPTION if any compare or swap operations fail.
-ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end);
+/// Stable sort of the elements in the range [begin, end). This is a TimSort
+/// that finds the runs already present in the input and merges them, so that
+/// sorted and reversed inputs take linear time and partially sorted inputs
+/// need fewer comparisons. Runs are merged through temporary slots if the
+/// model provides them, and in place with swaps otherwise.
+/// Returns immediately with ExecutionStatus::EXCEPTION if any model operation
+/// fails. Always terminates, even if the comparison is inconsistent.
+ExecutionStatus timSort(SortModel *sm, uint32_t begin, uint32_t end);
 
 } // namespace vm
 } // namespace hermes
@@ -51,9 +51,34 @@ class JSMapImpl final : public JSObject {
     return ExecutionStatus::RETURNED;
   }
 
-  /// Advance iterator and return the next.
-  HashMapEntry *iteratorNext(Runtime &runtime, HashMapEntry *entry) {
-    return storage_.getNonNull(runtime)->iteratorNext(runtime, entry);
+  /// \return the generation of the storage that a new iteration starts in,
+  /// at index 0.
+  static HashMapGeneration *iteratorBegin(
+      Handle<JSMapImpl> self,
+      Runtime &runtime) {
+    self->assertInitialized();
+    return OrderedHashMap::getGeneration(
+        runtime.makeHandle<OrderedHashMap>(self->storage_), runtime);
+  }
+
+  /// Advance the iteration position (\p generation, \p index) to the next
+  /// element, \return false if there is none.
+  bool iteratorNext(
+      Runtime &runtime,
+      HashMapGeneration *&generation,
+      uint32_t &index) {
+    return storage_.getNonNull(runtime)->iteratorNext(
+        runtime, generation, index);
+  }
+
+  /// \return the key of the element at iteration index \p index.
+  HermesValue iteratorKey(Runtime &runtime, uint32_t index) {
+    return storage_.getNonNull(runtime)->getKeyAt(runtime, index);
+  }
+
+  /// \return the value of the element at iteration index \p index.
+  HermesValue iteratorValue(Runtime &runtime, uint32_t index) {
+    return storage_.getNonNull(runtime)->getValueAt(runtime, index);
   }
 
   /// Add a value.
@@ -101,7 +126,8 @@ class JSMapImpl final : public JSObject {
   /// Clear all elements from the storage.
   static void clear(Handle<JSMapImpl> self, Runtime &runtime) {
     self->assertInitialized();
-    self->storage_.getNonNull(runtime)->clear(runtime);
+    OrderedHashMap::clear(
+        runtime.makeHandle<OrderedHashMap>(self->storage_), runtime);
   }
 
   /// Call \p callbackfn for each entry, with \p thisArg as this.
@@ -111,15 +137,18 @@ class JSMapImpl final : public JSObject {
       Handle<Callable> callbackfn,
       Handle<> thisArg) {
     self->assertInitialized();
-    MutableHandle<HashMapEntry> entry{runtime};
+    MutableHandle<HashMapGeneration> generation{
+        runtime, iteratorBegin(self, runtime)};
+    uint32_t index = 0;
     GCScopeMarkerRAII marker{runtime};
-    for (entry = self->storage_.getNonNull(runtime)->iteratorNext(runtime);
-         entry;
-         entry = self->storage_.getNonNull(runtime)->iteratorNext(
-             runtime, entry.get())) {
+    for (;; ++index) {
       marker.flush();
-      HermesValue key = entry->key;
-      HermesValue value = entry->value;
+      HashMapGeneration *gen = *generation;
+      if (!self->iteratorNext(runtime, gen, index))
+        break;
+      generation = gen;
+      HermesValue key = self->iteratorKey(runtime, index);
+      HermesValue value = self->iteratorValue(runtime, index);
       assert(!key.isEmpty() && "Invalid key encountered");
       assert(!value.isEmpty() && "Invalid value encountered");
       if (LLVM_UNLIKELY(
@@ -169,6 +198,7 @@ struct JSMapTypeTraits<CellKind::JSMapIteratorKind> {
 template <CellKind C>
 class JSMapIteratorImpl final : public JSObject {
   using Super = JSObject;
+  using ContainerType = JSMapImpl<JSMapTypeTraits<C>::ContainerKind>;
 
  public:
   static const ObjectVTable vt;
@@ -212,31 +242,37 @@ class JSMapIteratorImpl final : public JSObject {
     if (!self->iterationFinished_) {
       // Iteration has not yet reached the end previously.
       assert(self->data_ && "Storage uninitialized");
+      auto data = runtime.makeHandle<ContainerType>(self->data_);
+      if (!self->itrGeneration_) {
+        // Starting the iteration.
+        HashMapGeneration *gen = ContainerType::iteratorBegin(data, runtime);
+        self->itrGeneration_.setNonNull(runtime, gen, runtime.getHeap());
+      }
       // Advance the iterator.
-      self->itr_.set(
-          runtime,
-          self->data_.getNonNull(runtime)->iteratorNext(
-              runtime, self->itr_.get(runtime)),
-          runtime.getHeap());
-      if (self->itr_) {
+      HashMapGeneration *gen = self->itrGeneration_.getNonNull(runtime);
+      uint32_t index = self->itrIndex_;
+      bool found = data->iteratorNext(runtime, gen, index);
+      self->itrGeneration_.setNonNull(runtime, gen, runtime.getHeap());
+      if (found) {
+        self->itrIndex_ = index + 1;
         switch (self->iterationKind_) {
           case IterationKind::Key:
-            value = self->itr_.getNonNull(runtime)->key;
+            value = data->iteratorKey(runtime, index);
             break;
           case IterationKind::Value:
-            value = self->itr_.getNonNull(runtime)->value;
+            value = data->iteratorValue(runtime, index);
             break;
           case IterationKind::Entry: {
             // If we are iterating both key and value, we need to create an
-            // array.
+            // array. Read the entry first, the allocation may move it.
+            MutableHandle<> key{runtime, data->iteratorKey(runtime, index)};
+            value = data->iteratorValue(runtime, index);
             auto arrRes = JSArray::create(runtime, 2, 2);
             if (arrRes == ExecutionStatus::EXCEPTION) {
               return ExecutionStatus::EXCEPTION;
             }
             auto arrHandle = *arrRes;
-            value = self->itr_.getNonNull(runtime)->key;
-            JSArray::setElementAt(arrHandle, runtime, 0, value);
-            value = self->itr_.getNonNull(runtime)->value;
+            JSArray::setElementAt(arrHandle, runtime, 0, key);
             JSArray::setElementAt(arrHandle, runtime, 1, value);
             value = arrHandle.getHermesValue();
             break;
@@ -250,6 +286,7 @@ class JSMapIteratorImpl final : public JSObject {
         // reached the end.
         self->iterationFinished_ = true;
         self->data_.setNull(runtime.getHeap());
+        self->itrGeneration_.setNull(runtime.getHeap());
       }
     }
     return createIterResultObject(runtime, value, self->iterationFinished_)
@@ -272,8 +309,12 @@ class JSMapIteratorImpl final : public JSObject {
   /// initialized or the iteration has ended.
   GCPointer<JSMapImpl<JSMapTypeTraits<C>::ContainerKind>> data_{nullptr};
 
-  /// Iteration pointer to the element storage in the Map.
-  GCPointer<HashMapEntry> itr_{nullptr};
+  /// The generation of the Map's element storage that itrIndex_ refers to.
+  /// nullptr if the iteration has not started or has ended.
+  GCPointer<HashMapGeneration> itrGeneration_{nullptr};
+
+  /// Index of the next element to visit.
+  uint32_t itrIndex_{0};
 
   IterationKind iterationKind_;
 
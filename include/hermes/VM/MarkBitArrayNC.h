@@ -55,6 +55,10 @@ class MarkBitArrayNC {
   /// range of the array.
   inline void mark(size_t ind);
 
+  /// Atomically marks the bit for the given index, and returns whether it was
+  /// already marked. Safe to call from several threads at once.
+  inline bool testAndMark(size_t ind);
+
   /// Clears the bit array.
   inline void clear();
 
@@ -140,6 +144,11 @@ void MarkBitArrayNC::mark(size_t ind) {
   bitArray_.set(ind, true);
 }
 
+bool MarkBitArrayNC::testAndMark(size_t ind) {
+  assert(ind < kNumBits && "precondition: ind must be within the index range");
+  return bitArray_.atomicTestAndSet(ind);
+}
+
 void MarkBitArrayNC::clear() {
   bitArray_.reset();
 }
@@ -9,74 +9,71 @@
 #define HERMES_VM_ORDERED_HASHMAP_H
 
 #include "hermes/Support/ErrorHandling.h"
-#include "hermes/VM/ArrayStorage.h"
+#include "hermes/Support/OptValue.h"
 #include "hermes/VM/Runtime.h"
-
-#include <vector>
+#include "hermes/VM/SegmentedArray.h"
 
 namespace hermes {
 namespace vm {
 
-/// HashMapEntry is a gc-managed entry in the OrderedHashMap.
-/// We use HashMapEntry to form two separate linked lists,
-/// one that tracks the insertion order for iteration purpose, one
-/// tracks the list of entries in a hash table bucket for hash operations.
-class HashMapEntry final : public GCCell {
+/// HashMapGeneration identifies one incarnation of the entry storage of an
+/// OrderedHashMap, and is what iterators hold on to. Iteration positions are
+/// indices into the entry storage, which are only stable until the map
+/// compacts away its deleted entries or is cleared. When that happens, the
+/// current generation is retired: it is linked to the generation that replaces
+/// it, and keeps enough information to translate positions into it.
+class HashMapGeneration final : public GCCell {
+  friend void HashMapGenerationBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+  friend class OrderedHashMap;
+
  public:
   static const VTable vt;
 
-  /// The key.
-  GCHermesValue key;
-
-  /// The value.
-  GCHermesValue value;
-
-  /// Previous entry in insertion order.
-  GCPointer<HashMapEntry> prevIterationEntry{nullptr};
-
-  /// Next entry in insertion order.
-  GCPointer<HashMapEntry> nextIterationEntry{nullptr};
-
-  /// Next entry in the hash table bucket.
-  GCPointer<HashMapEntry> nextEntryInBucket{nullptr};
-
   static constexpr CellKind getCellKind() {
-    return CellKind::HashMapEntryKind;
+    return CellKind::HashMapGenerationKind;
   }
   static bool classof(const GCCell *cell) {
-    return cell->getKind() == CellKind::HashMapEntryKind;
+    return cell->getKind() == CellKind::HashMapGenerationKind;
   }
 
-  static CallResult<PseudoHandle<HashMapEntry>> create(Runtime &runtime);
+  static PseudoHandle<HashMapGeneration> create(Runtime &runtime);
 
-  /// Indicates whether this entry has been deleted.
-  bool isDeleted() const {
-    assert(key.isEmpty() == value.isEmpty() && "Inconsistent deleted status");
-    return value.isEmpty();
+  /// \return the generation that replaced this one, or nullptr if this is
+  /// still the current generation of its map.
+  HashMapGeneration *getNext(Runtime &runtime) const {
+    return next_.get(runtime);
   }
 
-  /// Mark this entry as deleted.
-  void markDeleted(Runtime &runtime) {
-    key.setNonPtr(HermesValue::encodeEmptyValue(), runtime.getHeap());
-    value.setNonPtr(HermesValue::encodeEmptyValue(), runtime.getHeap());
-  }
-}; // HashMapEntry
+  /// Translate the iteration position \p index in this retired generation to
+  /// the corresponding position in the next generation.
+  uint32_t translateIndex(Runtime &runtime, uint32_t index) const;
+
+ private:
+  /// The generation that replaced this one.
+  GCPointer<HashMapGeneration> next_{nullptr};
+
+  /// The entry storage as it was when this generation was retired by a
+  /// compaction. Only the deleted (empty) keys matter: every live entry before
+  /// a position moves to the next generation in order. This is nullptr if the
+  /// generation was retired by clearing the map, in which case all positions
+  /// translate to the beginning.
+  GCPointer<SegmentedArraySmall> entries_{nullptr};
+}; // HashMapGeneration
 
 /// OrderedHashMap is a gc-managed hash map that maintains insertion order.
-/// The map contains two conceptual parts: a standard chained hash table,
-/// to store and lookup HermesValue; a linked list to maintain the insertion
-/// order.
-/// When an element is added, it's always appended to the end of the linked
-/// list. When an element is deleted, we mark it as deleted and remove it
-/// from the linked list, unless it's the last element.
-/// Iterators are pointers to the entries, which are always linked according
-/// to insertion order.
-/// When the size of the hash table becomes unreasonably large or small
-/// comparing to the number of alive elements, we will rehash the table.
-/// We always make sure that any entry at any moment can successfully find
-/// the next entry according to insertion order, and rely on GC to manage
-/// the "deleted" entries", free them when no more iterators are before
-/// that entry.
+/// It is laid out as a deterministic hash table with two parts:
+///  - A dense array of entries in insertion order, each occupying a key slot
+///    followed by a value slot. Deleting an entry turns both slots into empty
+///    values (a tombstone) and leaves it in place.
+///  - An open-addressing index from hash codes to entry positions. It only
+///    contains plain integers, so it lives in malloc memory owned by the map
+///    and is not scanned by the GC.
+/// Deleted entries are dropped when the index is rebuilt, at which point the
+/// entries array is compacted into a new one and the current
+/// HashMapGeneration is retired, allowing iterators that were positioned in
+/// the old array to find their way to the corresponding entry in the new one.
 class OrderedHashMap final : public GCCell {
   friend void OrderedHashMapBuildMeta(
       const GCCell *cell,
@@ -102,11 +99,6 @@ class OrderedHashMap final : public GCCell {
   static HermesValue
   get(Handle<OrderedHashMap> self, Runtime &runtime, Handle<> key);
 
-  /// Lookup \p key in the table and \return the value if exists.
-  /// Otherwise \return nullptr.
-  static HashMapEntry *
-  find(Handle<OrderedHashMap> self, Runtime &runtime, Handle<> key);
-
   /// Insert a key/value pair into the map, if not already existing.
   static ExecutionStatus insert(
       Handle<OrderedHashMap> self,
@@ -118,74 +110,135 @@ class OrderedHashMap final : public GCCell {
   static bool
   erase(Handle<OrderedHashMap> self, Runtime &runtime, Handle<> key);
 
-  /// Clear the map.  The \p gc parameter is necessary for write barriers.
-  void clear(Runtime &runtime);
+  /// Clear the map.
+  static void clear(Handle<OrderedHashMap> self, Runtime &runtime);
 
   /// \return the size of the map.
   uint32_t size() const {
     return size_;
   }
 
-  /// \return the next element in insertion order.
-  /// If \p entry is nullptr, we are starting the iteration from the first
-  /// entry that is not deleted.
-  /// Otherwise, we look for the next element after \p entry that is not
-  /// deleted.
-  HashMapEntry *iteratorNext(Runtime &runtime, HashMapEntry *entry = nullptr)
-      const;
+  /// \return the current generation of the entry storage, creating it if this
+  /// is the first iteration over the map. A new iteration starts at position 0
+  /// of this generation.
+  static HashMapGeneration *getGeneration(
+      Handle<OrderedHashMap> self,
+      Runtime &runtime);
 
-  OrderedHashMap(Runtime &runtime, Handle<ArrayStorageSmall> hashTableStorage);
+  /// Advance the iteration position (\p generation, \p index) to the next live
+  /// entry at or after it in insertion order, first following \p generation to
+  /// the current generation if it has been retired.
+  /// \return true if such an entry exists. Its key and value can then be read
+  /// with getKeyAt() and getValueAt(), and the caller moves past it by
+  /// incrementing \p index. Otherwise \return false.
+  bool iteratorNext(
+      Runtime &runtime,
+      HashMapGeneration *&generation,
+      uint32_t &index) const;
+
+  /// \return the key of the live entry at \p index.
+  HermesValue getKeyAt(Runtime &runtime, uint32_t index) const {
+    assert(index < numEntries_ && "Entry index out of range");
+    return entries_.getNonNull(runtime)
+        ->at(runtime, keySlot(index))
+        .unboxToHV(runtime);
+  }
+
+  /// \return the value of the live entry at \p index.
+  HermesValue getValueAt(Runtime &runtime, uint32_t index) const {
+    assert(index < numEntries_ && "Entry index out of range");
+    return entries_.getNonNull(runtime)
+        ->at(runtime, valueSlot(index))
+        .unboxToHV(runtime);
+  }
+
+  OrderedHashMap(Runtime &runtime, Handle<SegmentedArraySmall> entries);
 
  private:
-  /// The hashtable, with size always equal to capacity_. The number of
-  /// reachable entries from hashTable_ should be equal to size_.
-  GCPointer<ArrayStorageSmall> hashTable_{nullptr};
+  /// A slot in the index. Records the hash of the key, to avoid unboxing and
+  /// comparing keys on collisions and to rebuild the index without hashing
+  /// the keys again.
+  struct Bucket {
+    uint32_t hash;
+    /// The entry position plus one, or 0 if the bucket is empty.
+    uint32_t entry;
+  };
 
-  /// The first entry ever inserted. We need this entry to begin an iteration.
-  GCPointer<HashMapEntry> firstIterationEntry_{nullptr};
+  /// The entries, two slots per entry. Contains numEntries_ entries including
+  /// deleted ones.
+  GCPointer<SegmentedArraySmall> entries_;
 
-  /// The last entry inserted. We need it to add new elements afterwards.
-  GCPointer<HashMapEntry> lastIterationEntry_{nullptr};
+  /// The current generation of entries_, or nullptr if the map was never
+  /// iterated since it was last compacted or cleared.
+  GCPointer<HashMapGeneration> generation_{nullptr};
 
-  /// Initial capacity of the hash table.
-  static constexpr uint32_t INITIAL_CAPACITY = 16;
+  /// The index, with capacity_ buckets. nullptr until the first insertion.
+  XorPtr<Bucket, XorPtrKeyID::OrderedHashMapIndex> index_;
 
-  /// Maximum capacity cannot exceed the maximum capacity of the underlying
-  /// ArrayStorage.
-  // It needs to be less than 1/4th the max 32-bit integer in order to use an
-  // integer-based load factor check of 0.75.
-  static constexpr uint32_t MAX_CAPACITY =
-      std::min(ArrayStorageSmall::maxElements(), UINT32_MAX / 4);
+  /// Initial number of buckets in the index.
+  static constexpr uint32_t INITIAL_CAPACITY = 8;
 
-  /// Capacity of the hash table.
-  uint32_t capacity_{INITIAL_CAPACITY};
+  /// Maximum number of buckets in the index. Entry positions plus one must be
+  /// representable in a bucket, and the allocation size must fit in 32 bits.
+  static constexpr uint32_t MAX_CAPACITY = 1u << 28;
+
+  /// Number of buckets in the index, always 0 or a power of 2. At most half of
+  /// them are used, counting deleted entries.
+  uint32_t capacity_{0};
+
+  /// Number of entries in entries_, including deleted ones.
+  uint32_t numEntries_{0};
 
   /// Number of alive entries in the storage.
   uint32_t size_{0};
 
-  /// Hash a HermesValue to an index to our hash table.
-  static uint32_t
-  hashToBucket(Handle<OrderedHashMap> self, Runtime &runtime, Handle<> key) {
-    auto hash = runtime.gcStableHashHermesValue(key);
-    assert(
-        (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-        "capacity_ must be power of 2");
-    return hash & (self->capacity_ - 1);
+  static constexpr uint32_t keySlot(uint32_t index) {
+    return index * 2;
+  }
+  static constexpr uint32_t valueSlot(uint32_t index) {
+    return index * 2 + 1;
   }
 
-  /// Remove a node from the linked list.
-  void removeLinkedListNode(Runtime &runtime, HashMapEntry *entry, GC &gc);
+  /// Hash a key. Must be called before taking any raw pointers, since hashing
+  /// an object may allocate its ID.
+  static uint32_t hashKey(Runtime &runtime, Handle<> key) {
+    return static_cast<uint32_t>(runtime.gcStableHashHermesValue(key));
+  }
 
-  /// Lookup an entry with key as \p key in a given \p bucket.
-  HashMapEntry *
-  lookupInBucket(Runtime &runtime, uint32_t bucket, HermesValue key);
+  /// Search the index for an entry with \p key, whose hash is \p hash.
+  /// \return its position if found.
+  OptValue<uint32_t> lookup(Runtime &runtime, uint32_t hash, HermesValue key)
+      const;
 
-  /// Adjust the capacity of the hashtable and rehash if necessary.
-  /// We make decisions based on the Load Factor (size / capacity).
-  /// Rehash if load factor is outside of the range of [0.25, 0.75].
-  static ExecutionStatus rehashIfNecessary(
+  /// Record the entry at position \p index with hash \p hash in the first
+  /// empty bucket of \p buckets (of which there are \p capacity) along its
+  /// probe sequence.
+  static void
+  addToIndex(Bucket *buckets, uint32_t capacity, uint32_t hash, uint32_t index);
+
+  /// Rebuild the index with \p newCapacity buckets, dropping deleted entries
+  /// from it. If \p compact is true, also move the live entries to a new
+  /// entries array and retire the current generation. The map is unchanged if
+  /// this fails.
+  static ExecutionStatus rehash(
       Handle<OrderedHashMap> self,
-      Runtime &runtime);
+      Runtime &runtime,
+      uint32_t newCapacity,
+      bool compact);
+
+  /// Retire the current generation, if any, in favor of a new one. \p
+  /// oldEntries is the compacted entries array, or nullptr if the map was
+  /// cleared.
+  static void retireGeneration(
+      Handle<OrderedHashMap> self,
+      Runtime &runtime,
+      Handle<SegmentedArraySmall> oldEntries);
+
+  /// Release the index.
+  void freeIndex(GC &gc);
+
+  static void _finalizeImpl(GCCell *cell, GC &gc);
+  static size_t _mallocSizeImpl(GCCell *cell);
 }; // OrderedHashMap
 } // namespace vm
 } // namespace hermes
@@ -45,18 +45,27 @@ class InlineCacheProfiler {
   /// is uniquely identified by code block and instruction offset.
   struct ICMiss {
     /// Increment the inline caching miss count for a pair of hidden classes.
-    void insertMiss(ICMissKey icRecord) {
+    /// \p megamorphic indicates that the site had already run out of
+    /// polymorphic entries.
+    void insertMiss(ICMissKey icRecord, bool megamorphic) {
       auto ret =
           hiddenClasses.insert(std::pair<ICMissKey, uint32_t>(icRecord, 1));
       if (!ret.second) {
         ++(ret.first->second);
       }
       ++missCount;
+      if (megamorphic) {
+        ++megamorphicCount;
+      }
     }
 
     /// Increment the inline caching hit count for a pair of hidden classes.
-    void incrementHit() {
+    /// \p polymorphic indicates that the hit was not in the primary entry.
+    void incrementHit(bool polymorphic) {
       ++hitCount;
+      if (polymorphic) {
+        ++polymorphicHitCount;
+      }
     }
 
     /// Total number of inline caching misses at the source location.
@@ -65,6 +74,12 @@ class InlineCacheProfiler {
     /// Total number of inline caching hits at the source location.
     uint64_t hitCount{0};
 
+    /// Number of hits that were found in a non-primary polymorphic entry.
+    uint64_t polymorphicHitCount{0};
+
+    /// Number of misses that happened after the site became megamorphic.
+    uint64_t megamorphicCount{0};
+
     /// Internal map that keeps track of the mapping between
     /// <property, object hidden class, cached hidden class> and its frequency.
     llvh::DenseMap<ICMissKey, uint64_t> hiddenClasses;
@@ -82,16 +97,33 @@ class InlineCacheProfiler {
       uint32_t instOffset,
       SymbolID &propertyID,
       ClassId objectHiddenClassId,
-      ClassId cachedHiddenClassId);
+      ClassId cachedHiddenClassId,
+      bool megamorphic);
 
-  /// Record an inline caching hit.
-  bool insertICHit(CodeBlock *codeblock, uint32_t instOffset);
+  /// Record an inline caching hit. \p polymorphic is true if the hit was in a
+  /// non-primary entry of a polymorphic cache.
+  bool insertICHit(CodeBlock *codeblock, uint32_t instOffset, bool polymorphic);
 
   /// Get the total number of inline caching misses.
   uint32_t getTotalMisses() {
     return totalMisses_;
   }
 
+  /// Get the total number of inline caching hits.
+  uint64_t getTotalHits() {
+    return totalHits_;
+  }
+
+  /// Get the total number of hits in non-primary polymorphic entries.
+  uint64_t getTotalPolymorphicHits() {
+    return totalPolymorphicHits_;
+  }
+
+  /// Get the total number of misses at megamorphic sites.
+  uint64_t getTotalMegamorphicMisses() {
+    return totalMegamorphicMisses_;
+  }
+
   /// Get a JS array containing all hidden classes that shouldn't be
   /// garbage collected.
   JSArray *&getHiddenClassArray();
@@ -163,6 +195,12 @@ class InlineCacheProfiler {
   /// Total number of inline caching hits during the program execution.
   uint64_t totalHits_{0};
 
+  /// Total number of hits in non-primary polymorphic entries.
+  uint64_t totalPolymorphicHits_{0};
+
+  /// Total number of misses at sites that have become megamorphic.
+  uint64_t totalMegamorphicMisses_{0};
+
   /// Store the data structure of all inline caching misses information.
   /// The map is keyed by pairs <instruction offset, CodeBlock> and maps
   /// to ICMiss objects, which keeps track of hidden classes and frequency.
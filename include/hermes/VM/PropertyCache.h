@@ -30,6 +30,152 @@ struct PropertyCacheEntry {
   SlotIndex slot{0};
 };
 
+/// The out-of-line part of the property cache of a single access site, which
+/// its CodeBlock only allocates for the sites that need it. A GetById/PutById
+/// site keeps the first class it observes in its inline \c PropertyCacheEntry,
+/// and the up to \c kMaxEntries classes it observes after that here. A
+/// GetByVal/PutByVal site keeps all its entries here, because they also record
+/// the property name. Once a site runs out of entries, it becomes megamorphic:
+/// the existing entries are still consulted, but new classes are recorded in
+/// the runtime-wide \c MegamorphicPropertyCache instead of churning the
+/// per-site entries.
+struct PolymorphicPropertyCacheEntry {
+  /// Maximum number of classes cached out of line at a single site.
+  static constexpr uint32_t kMaxEntries = 4;
+
+  struct Entry {
+    /// Cached class.
+    WeakRoot<HiddenClass> clazz{nullptr};
+
+    /// Cached property index.
+    SlotIndex slot{0};
+
+    /// Name of the cached property at GetByVal/PutByVal sites, where the name
+    /// is not fixed by the instruction; empty everywhere else.
+    SymbolID name{};
+  };
+
+  /// The cached entries. Only the first \c size entries are valid.
+  Entry entries[kMaxEntries];
+
+  /// Number of valid entries.
+  uint8_t size{0};
+
+  /// Whether the site has observed more classes than it can cache.
+  bool megamorphic{false};
+
+  /// Look for the pair (\p clazz, \p name) among the entries.
+  /// \return the matching entry, or nullptr if there is none.
+  const Entry *find(CompressedPointer clazz, SymbolID name = SymbolID{}) const {
+    for (uint32_t i = 0; i < size; ++i) {
+      if (entries[i].clazz == clazz && entries[i].name == name)
+        return &entries[i];
+    }
+    return nullptr;
+  }
+
+  /// Record that objects of class \p clazz have the property \p name at
+  /// \p slot. \p name must be left empty by sites whose property name is
+  /// fixed by the instruction. Entries whose class has been collected are
+  /// reused before the site is declared megamorphic.
+  /// \return true if the pair was cached, false if the site is megamorphic and
+  ///   the caller should fall back to the megamorphic cache.
+  bool
+  insert(CompressedPointer clazz, SlotIndex slot, SymbolID name = SymbolID{}) {
+    for (uint32_t i = 0; i < size; ++i) {
+      if (!entries[i].clazz ||
+          (entries[i].clazz == clazz && entries[i].name == name)) {
+        entries[i].clazz = clazz;
+        entries[i].slot = slot;
+        entries[i].name = name;
+        return true;
+      }
+    }
+    if (size < kMaxEntries) {
+      entries[size].clazz = clazz;
+      entries[size].slot = slot;
+      entries[size].name = name;
+      ++size;
+      return true;
+    }
+    megamorphic = true;
+    return false;
+  }
+
+  /// Mark all cached hidden classes as weak roots.
+  template <typename Acceptor>
+  void markWeakRoots(Acceptor &acceptor) {
+    for (uint32_t i = 0; i < size; ++i) {
+      if (entries[i].clazz)
+        acceptor.acceptWeak(entries[i].clazz);
+    }
+  }
+};
+
+/// A direct-mapped cache keyed by (class, property name), shared by all the
+/// megamorphic property access sites in a Runtime. It is only populated with
+/// own, non-accessor properties of non-dictionary classes, so a hit means the
+/// property lives at the cached slot of the object itself.
+class MegamorphicPropertyCache {
+ public:
+  /// Number of entries in the cache. Must be a power of two.
+  static constexpr uint32_t kNumEntries = 512;
+
+  struct Entry {
+    /// Cached class.
+    WeakRoot<HiddenClass> clazz{nullptr};
+
+    /// Name of the cached property.
+    SymbolID name{};
+
+    /// Cached property index.
+    SlotIndex slot{0};
+  };
+
+  /// \return the entry for (\p clazz, \p name), or nullptr if it isn't cached.
+  const Entry *find(CompressedPointer clazz, SymbolID name) const {
+    const Entry &entry = entries_[index(clazz, name)];
+    if (entry.clazz == clazz && entry.name == name)
+      return &entry;
+    return nullptr;
+  }
+
+  /// Cache \p slot as the location of \p name in objects of class \p clazz,
+  /// replacing any conflicting entry.
+  void insert(CompressedPointer clazz, SymbolID name, SlotIndex slot) {
+    Entry &entry = entries_[index(clazz, name)];
+    entry.clazz = clazz;
+    entry.name = name;
+    entry.slot = slot;
+  }
+
+  /// Mark all cached hidden classes as weak roots.
+  template <typename Acceptor>
+  void markWeakRoots(Acceptor &acceptor) {
+    for (Entry &entry : entries_) {
+      if (entry.clazz)
+        acceptor.acceptWeak(entry.clazz);
+    }
+  }
+
+ private:
+  static_assert(
+      (kNumEntries & (kNumEntries - 1)) == 0,
+      "kNumEntries must be a power of two");
+
+  static uint32_t index(CompressedPointer clazz, SymbolID name) {
+    // Hidden classes are at least 8-byte aligned, so drop the low bits before
+    // mixing in the symbol.
+    auto raw = static_cast<uint64_t>(clazz.getRaw());
+    uint32_t h = static_cast<uint32_t>(raw >> 3) ^
+        static_cast<uint32_t>(raw >> 35) ^
+        (name.unsafeGetRaw() * 0x9E3779B1u);
+    return (h ^ (h >> 16)) & (kNumEntries - 1);
+  }
+
+  Entry entries_[kNumEntries];
+};
+
 } // namespace vm
 } // namespace hermes
 #endif // PROJECT_PROPERTYCACHE_H
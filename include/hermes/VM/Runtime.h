@@ -888,6 +888,10 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
     return hasIntl_;
   }
 
+  RegExpEngine getRegExpEngine() const {
+    return regExpEngine_;
+  }
+
   bool hasArrayBuffer() const {
     return hasArrayBuffer_;
   }
@@ -974,13 +978,16 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// collected.
   void preventHCGC(HiddenClass *hc);
 
-  /// Inserts Hidden Classes into InlineCacheProfiler
+  /// Inserts Hidden Classes into InlineCacheProfiler. The access counts as a
+  /// hit if \p objectHiddenClass is cached in \p cacheEntry or in the
+  /// out-of-line entries of its site, and as a megamorphic access if the site
+  /// has overflowed its per-site entries.
   void recordHiddenClass(
       CodeBlock *codeBlock,
       const Inst *cacheMissInst,
       SymbolID symbolID,
       HiddenClass *objectHiddenClass,
-      HiddenClass *cachedHiddenClass);
+      PropertyCacheEntry *cacheEntry);
 
   /// Resolve HiddenClass pointers from its hidden class Id.
   HiddenClass *resolveHiddenClassId(ClassId classId);
@@ -1163,6 +1170,9 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// Set to true if we should enable ECMA-402 Intl APIs.
   const bool hasIntl_;
 
+  /// The executor that runs regular expressions.
+  const RegExpEngine regExpEngine_;
+
   /// Set to true if we should enable ArrayBuffer, DataView and typed arrays.
   const bool hasArrayBuffer_;
 
@@ -1276,6 +1286,13 @@ class HERMES_EMPTY_BASES Runtime : public PointerBase,
   /// Cache for property lookups in non-JS code.
   PropertyCacheEntry fixedPropCache_[(size_t)PropCacheID::_COUNT];
 
+  /// Fallback caches for GetById and PutById sites that have observed more
+  /// hidden classes than their per-site cache can hold. Reads and writes are
+  /// kept separate because a slot that is valid for reading may not be
+  /// writable.
+  MegamorphicPropertyCache megamorphicReadPropCache_;
+  MegamorphicPropertyCache megamorphicWritePropCache_;
+
   /// StringPrimitive representation of the first 256 characters.
   /// These are allocated as "long-lived" objects, so they don't need
   /// to be scanned as roots in young-gen collections.
@@ -231,6 +231,15 @@ class StringPrimitive : public VariableSizeRuntimeCell {
     return (lengthAndUniquedFlag_ & LENGTH_FLAG_UNIQUED) != 0;
   }
 
+  /// \return the unique id if the string is uniqued, or an invalid SymbolID
+  /// otherwise. This performs no read barrier, so the result may only be used
+  /// for comparisons and lookups while the string is alive; use
+  /// IdentifierTable::getSymbolHandleFromPrimitive to obtain a SymbolID that
+  /// can be kept.
+  SymbolID getUniqueIDIfUniqued() const {
+    return isUniqued() ? getUniqueID() : SymbolID::empty();
+  }
+
   /// Compare a part of this string to \p other for equality.
   /// \return true if the section of this string from \p start of length \p
   /// length is equal to the string \p other.
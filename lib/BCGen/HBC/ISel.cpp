@@ -15,6 +15,7 @@
 #include "hermes/Support/BigIntSupport.h"
 #include "hermes/Support/Statistic.h"
 
+#include "llvh/ADT/MapVector.h"
 #include "llvh/ADT/Optional.h"
 
 #define DEBUG_TYPE "hbc-backend-isel"
@@ -615,17 +616,20 @@ void HBCISel::generateStorePropertyInst(
   if (auto *Lit = llvh::dyn_cast<LiteralString>(prop)) {
     // Property is a string
     auto id = BCFGen_->getIdentifierID(Lit);
-    if (id <= UINT16_MAX)
-      BCFGen_->emitPutById(
-          objReg, valueReg, acquirePropertyWriteCacheIndex(id), id);
+    auto cacheIdx = acquirePropertyWriteCacheIndex(Inst, id);
+    if (id <= UINT16_MAX && cacheIdx <= PROPERTY_CACHE_SHORT_INDEX_MAX)
+      BCFGen_->emitPutById(objReg, valueReg, cacheIdx, id);
     else
-      BCFGen_->emitPutByIdLong(
-          objReg, valueReg, acquirePropertyWriteCacheIndex(id), id);
+      BCFGen_->emitPutByIdLong(objReg, valueReg, cacheIdx, id);
     return;
   }
 
   auto propReg = encodeValue(prop);
-  BCFGen_->emitPutByVal(objReg, propReg, valueReg);
+  BCFGen_->emitPutByVal(
+      objReg,
+      propReg,
+      valueReg,
+      acquireKeyedPropertyWriteCacheIndex(Inst, prop));
 }
 
 void HBCISel::generateTryStoreGlobalPropertyInst(
@@ -638,12 +642,11 @@ void HBCISel::generateTryStoreGlobalPropertyInst(
   auto *Lit = cast<LiteralString>(prop);
 
   auto id = BCFGen_->getIdentifierID(Lit);
-  if (id <= UINT16_MAX) {
-    BCFGen_->emitTryPutById(
-        objReg, valueReg, acquirePropertyWriteCacheIndex(id), id);
+  auto cacheIdx = acquirePropertyWriteCacheIndex(Inst, id);
+  if (id <= UINT16_MAX && cacheIdx <= PROPERTY_CACHE_SHORT_INDEX_MAX) {
+    BCFGen_->emitTryPutById(objReg, valueReg, cacheIdx, id);
   } else {
-    BCFGen_->emitTryPutByIdLong(
-        objReg, valueReg, acquirePropertyWriteCacheIndex(id), id);
+    BCFGen_->emitTryPutByIdLong(objReg, valueReg, cacheIdx, id);
   }
 }
 
@@ -758,21 +761,23 @@ void HBCISel::generateLoadPropertyInst(
 
   if (auto *Lit = llvh::dyn_cast<LiteralString>(prop)) {
     auto id = BCFGen_->getIdentifierID(Lit);
-    if (id > UINT16_MAX) {
-      BCFGen_->emitGetByIdLong(
-          resultReg, objReg, acquirePropertyReadCacheIndex(id), id);
+    auto cacheIdx = acquirePropertyReadCacheIndex(Inst, id);
+    if (id > UINT16_MAX || cacheIdx > PROPERTY_CACHE_SHORT_INDEX_MAX) {
+      BCFGen_->emitGetByIdLong(resultReg, objReg, cacheIdx, id);
     } else if (id > UINT8_MAX) {
-      BCFGen_->emitGetById(
-          resultReg, objReg, acquirePropertyReadCacheIndex(id), id);
+      BCFGen_->emitGetById(resultReg, objReg, cacheIdx, id);
     } else {
-      BCFGen_->emitGetByIdShort(
-          resultReg, objReg, acquirePropertyReadCacheIndex(id), id);
+      BCFGen_->emitGetByIdShort(resultReg, objReg, cacheIdx, id);
     }
     return;
   }
 
   auto propReg = encodeValue(prop);
-  BCFGen_->emitGetByVal(resultReg, objReg, propReg);
+  BCFGen_->emitGetByVal(
+      resultReg,
+      objReg,
+      propReg,
+      acquireKeyedPropertyReadCacheIndex(Inst, prop));
 }
 
 void HBCISel::generateTryLoadGlobalPropertyInst(
@@ -785,12 +790,11 @@ void HBCISel::generateTryLoadGlobalPropertyInst(
   auto *Lit = cast<LiteralString>(prop);
 
   auto id = BCFGen_->getIdentifierID(Lit);
-  if (id > UINT16_MAX) {
-    BCFGen_->emitTryGetByIdLong(
-        resultReg, objReg, acquirePropertyReadCacheIndex(id), id);
+  auto cacheIdx = acquirePropertyReadCacheIndex(Inst, id);
+  if (id > UINT16_MAX || cacheIdx > PROPERTY_CACHE_SHORT_INDEX_MAX) {
+    BCFGen_->emitTryGetByIdLong(resultReg, objReg, cacheIdx, id);
   } else {
-    BCFGen_->emitTryGetById(
-        resultReg, objReg, acquirePropertyReadCacheIndex(id), id);
+    BCFGen_->emitTryGetById(resultReg, objReg, cacheIdx, id);
   }
 }
 
@@ -1793,6 +1797,8 @@ void HBCISel::generate(SourceMapGenerator *outSourceMap) {
     asyncBreakChecks_.insert(order.front());
   }
 
+  assignPropertyCacheIndices(order);
+
   for (int i = 0, e = order.size(); i < e; ++i) {
     BasicBlock *BB = order[i];
     BasicBlock *next = ((i + 1) == e) ? nullptr : order[i + 1];
@@ -1809,10 +1815,146 @@ void HBCISel::generate(SourceMapGenerator *outSourceMap) {
   BCFGen_->bytecodeGenerationComplete();
 }
 
-uint8_t HBCISel::acquirePropertyReadCacheIndex(unsigned id) {
+/// \return true if \p inst accesses a property through a property cache,
+/// setting \p isWrite if it is a store and \p name to the literal name of the
+/// property, or nullptr if the name is only known at runtime.
+static bool getPropertyCacheSite(
+    Instruction *inst,
+    bool &isWrite,
+    LiteralString *&name) {
+  Value *prop;
+  if (auto *LPI = llvh::dyn_cast<LoadPropertyInst>(inst)) {
+    isWrite = false;
+    prop = LPI->getProperty();
+  } else if (auto *SPI = llvh::dyn_cast<StorePropertyInst>(inst)) {
+    isWrite = true;
+    prop = SPI->getProperty();
+  } else {
+    return false;
+  }
+  name = llvh::dyn_cast<LiteralString>(prop);
+  // Number keys don't use a cache, see acquireKeyedPropertyReadCacheIndex().
+  return name || !prop->getType().isNumberType();
+}
+
+/// \return the estimated relative execution frequency of \p BB, based on the
+/// depth of the loops it is nested in.
+static uint64_t getStaticBlockWeight(
+    const LoopAnalysis &loops,
+    const BasicBlock *BB) {
+  // Beyond this depth the estimate is meaningless anyway.
+  constexpr unsigned kMaxLoopDepth = 6;
+  unsigned depth = 0;
+  while (BB && depth < kMaxLoopDepth && loops.isBlockInLoop(BB)) {
+    ++depth;
+    // The preheader is outside the current loop, but may be in an outer one.
+    BB = loops.getLoopPreheader(BB);
+  }
+  return uint64_t(1) << (3 * depth);
+}
+
+void HBCISel::assignPropertyCacheIndices(llvh::ArrayRef<BasicBlock *> order) {
+  /// A set of sites which share a cache.
+  struct SiteGroup {
+    /// Sum of the static weights of all sites.
+    uint64_t weight = 0;
+    /// Whether all sites are *ById instructions, which have Long variants.
+    bool allowsLongIndex = true;
+    llvh::SmallVector<Instruction *, 2> sites{};
+  };
+
+  const bool reuse = F_->getContext().getOptimizationSettings().reusePropCache;
+  // Sites with the same property name share a cache when reuse is enabled, so
+  // they are grouped by name. Every other site forms a group of its own.
+  // Index 0 is for reads, 1 for writes.
+  llvh::MapVector<const Value *, SiteGroup> groups[2];
+  for (BasicBlock *BB : order) {
+    for (auto &I : *BB) {
+      bool isWrite;
+      LiteralString *name;
+      if (!getPropertyCacheSite(&I, isWrite, name))
+        continue;
+      const Value *key = reuse && name ? static_cast<Value *>(name) : &I;
+      SiteGroup &group = groups[isWrite][key];
+      group.allowsLongIndex &= name != nullptr;
+      group.sites.push_back(&I);
+    }
+  }
+
+  // Most functions fit, and get their indices assigned in emission order.
+  if (groups[0].size() <= PROPERTY_CACHE_SHORT_INDEX_MAX &&
+      groups[1].size() <= PROPERTY_CACHE_SHORT_INDEX_MAX)
+    return;
+
+  DominanceInfo dominance(F_);
+  LoopAnalysis loops(F_, dominance);
+  // Lazily compiled functions get a cache of a fixed size, which only covers
+  // the short indices.
+  const uint32_t maxIndex = F_->getContext().isLazyCompilation()
+      ? PROPERTY_CACHE_SHORT_INDEX_MAX
+      : std::numeric_limits<uint16_t>::max();
+
+  for (unsigned isWrite = 0; isWrite < 2; ++isWrite) {
+    if (groups[isWrite].size() <= PROPERTY_CACHE_SHORT_INDEX_MAX)
+      continue;
+
+    llvh::SmallVector<SiteGroup *, 0> sorted;
+    sorted.reserve(groups[isWrite].size());
+    for (auto &entry : groups[isWrite]) {
+      SiteGroup &group = entry.second;
+      for (Instruction *I : group.sites)
+        group.weight += getStaticBlockWeight(loops, I->getParent());
+      sorted.push_back(&group);
+    }
+    // Ties keep emission order, like the on-demand assignment.
+    std::stable_sort(
+        sorted.begin(), sorted.end(), [](SiteGroup *a, SiteGroup *b) {
+          return a->weight > b->weight;
+        });
+
+    uint32_t nextShortIndex = 1;
+    uint32_t nextLongIndex = PROPERTY_CACHE_SHORT_INDEX_MAX + 1;
+    for (SiteGroup *group : sorted) {
+      uint16_t idx = PROPERTY_CACHING_DISABLED;
+      if (nextShortIndex <= PROPERTY_CACHE_SHORT_INDEX_MAX) {
+        idx = nextShortIndex++;
+      } else if (group->allowsLongIndex && nextLongIndex <= maxIndex) {
+        idx = nextLongIndex++;
+      }
+      if (idx != PROPERTY_CACHING_DISABLED)
+        ++NumCacheSlots;
+      for (Instruction *I : group->sites)
+        propertyCacheIndexForInst_[I] = idx;
+    }
+    (isWrite ? lastPropertyWriteCacheIndex_ : lastPropertyReadCacheIndex_) =
+        nextLongIndex - 1;
+  }
+}
+
+bool HBCISel::findAssignedPropertyCacheIndex(
+    Instruction *inst,
+    uint16_t &idx) {
+  auto it = propertyCacheIndexForInst_.find(inst);
+  if (it == propertyCacheIndexForInst_.end())
+    return false;
+  idx = it->second;
+  if (idx == PROPERTY_CACHING_DISABLED)
+    ++NumUncachedNodes;
+  else
+    ++NumCachedNodes;
+  return true;
+}
+
+uint16_t HBCISel::acquirePropertyReadCacheIndex(
+    Instruction *inst,
+    unsigned id) {
+  uint16_t assigned;
+  if (findAssignedPropertyCacheIndex(inst, assigned))
+    return assigned;
+
   const bool reuse = F_->getContext().getOptimizationSettings().reusePropCache;
   // Zero is reserved for indicating no-cache, so cannot be a value in the map.
-  uint8_t dummyZero = 0;
+  uint16_t dummyZero = 0;
   auto &idx = reuse ? propertyReadCacheIndexForId_[id] : dummyZero;
   if (idx) {
     ++NumCachedNodes;
@@ -1820,7 +1962,7 @@ uint8_t HBCISel::acquirePropertyReadCacheIndex(unsigned id) {
   }
 
   if (LLVM_UNLIKELY(
-          lastPropertyReadCacheIndex_ == std::numeric_limits<uint8_t>::max())) {
+          lastPropertyReadCacheIndex_ >= PROPERTY_CACHE_SHORT_INDEX_MAX)) {
     ++NumUncachedNodes;
     return PROPERTY_CACHING_DISABLED;
   }
@@ -1831,10 +1973,16 @@ uint8_t HBCISel::acquirePropertyReadCacheIndex(unsigned id) {
   return idx;
 }
 
-uint8_t HBCISel::acquirePropertyWriteCacheIndex(unsigned id) {
+uint16_t HBCISel::acquirePropertyWriteCacheIndex(
+    Instruction *inst,
+    unsigned id) {
+  uint16_t assigned;
+  if (findAssignedPropertyCacheIndex(inst, assigned))
+    return assigned;
+
   const bool reuse = F_->getContext().getOptimizationSettings().reusePropCache;
   // Zero is reserved for indicating no-cache, so cannot be a value in the map.
-  uint8_t dummyZero = 0;
+  uint16_t dummyZero = 0;
   auto &idx = reuse ? propertyWriteCacheIndexForId_[id] : dummyZero;
   if (idx) {
     ++NumCachedNodes;
@@ -1842,8 +1990,7 @@ uint8_t HBCISel::acquirePropertyWriteCacheIndex(unsigned id) {
   }
 
   if (LLVM_UNLIKELY(
-          lastPropertyWriteCacheIndex_ ==
-          std::numeric_limits<uint8_t>::max())) {
+          lastPropertyWriteCacheIndex_ >= PROPERTY_CACHE_SHORT_INDEX_MAX)) {
     ++NumUncachedNodes;
     return PROPERTY_CACHING_DISABLED;
   }
@@ -1854,4 +2001,54 @@ uint8_t HBCISel::acquirePropertyWriteCacheIndex(unsigned id) {
   return idx;
 }
 
+uint8_t HBCISel::acquireKeyedPropertyReadCacheIndex(
+    Instruction *inst,
+    Value *prop) {
+  if (prop->getType().isNumberType())
+    return PROPERTY_CACHING_DISABLED;
+
+  uint16_t assigned;
+  if (findAssignedPropertyCacheIndex(inst, assigned)) {
+    assert(
+        assigned <= PROPERTY_CACHE_SHORT_INDEX_MAX &&
+        "keyed access assigned a long cache index");
+    return assigned;
+  }
+
+  if (LLVM_UNLIKELY(
+          lastPropertyReadCacheIndex_ >= PROPERTY_CACHE_SHORT_INDEX_MAX)) {
+    ++NumUncachedNodes;
+    return PROPERTY_CACHING_DISABLED;
+  }
+
+  ++NumCachedNodes;
+  ++NumCacheSlots;
+  return ++lastPropertyReadCacheIndex_;
+}
+
+uint8_t HBCISel::acquireKeyedPropertyWriteCacheIndex(
+    Instruction *inst,
+    Value *prop) {
+  if (prop->getType().isNumberType())
+    return PROPERTY_CACHING_DISABLED;
+
+  uint16_t assigned;
+  if (findAssignedPropertyCacheIndex(inst, assigned)) {
+    assert(
+        assigned <= PROPERTY_CACHE_SHORT_INDEX_MAX &&
+        "keyed access assigned a long cache index");
+    return assigned;
+  }
+
+  if (LLVM_UNLIKELY(
+          lastPropertyWriteCacheIndex_ >= PROPERTY_CACHE_SHORT_INDEX_MAX)) {
+    ++NumUncachedNodes;
+    return PROPERTY_CACHING_DISABLED;
+  }
+
+  ++NumCachedNodes;
+  ++NumCacheSlots;
+  return ++lastPropertyWriteCacheIndex_;
+}
+
 #undef DEBUG_TYPE
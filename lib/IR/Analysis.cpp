@@ -83,12 +83,9 @@ void PostOrderAnalysis::dump() {
 // DominanceInfo to ensure that preheaders dominate headers and headers dominate
 // all blocks in the loop.
 LoopAnalysis::LoopAnalysis(Function *F, const DominanceInfo &dominanceInfo) {
-  // BlockMap (defined in Analysis.h) and BlockSet are used for most cases.
-  // TinyBlockSet is only used for headerSets (defined below); it has a smaller
-  // inline size because we store BLOCK -> {SET OF HEADERS} for every block, and
-  // very deeply nested loops (leading to many headers) are not that common.
+  // BlockMap and TinyBlockSet are defined in Analysis.h. BlockSet is used for
+  // everything other than sets of headers.
   using BlockSet = llvh::SmallPtrSet<const BasicBlock *, 16>;
-  using TinyBlockSet = llvh::SmallPtrSet<BasicBlock *, 2>;
 
   int dfsTime = 0;
   // Maps each block to its DFS discovery time (value of dfsTime).
@@ -98,7 +95,7 @@ LoopAnalysis::LoopAnalysis(Function *F, const DominanceInfo &dominanceInfo) {
   // Maps each block to its parent in the DFS tree.
   BlockMap<BasicBlock *> parent;
   // Maps each block to a set of header blocks of loops that enclose it.
-  BlockMap<TinyBlockSet> headerSets;
+  BlockMap<TinyBlockSet> &headerSets = blockToHeaders_;
 
   // Explicit stack for depth-first search.
   llvh::SmallVector<BasicBlock *, 16> stack;
@@ -177,9 +174,9 @@ LoopAnalysis::LoopAnalysis(Function *F, const DominanceInfo &dominanceInfo) {
   }
 
   // Populate blockToHeader_ with the innermost loop header for each block.
-  for (auto &entry : headerSets) {
+  for (const auto &entry : headerSets) {
     const BasicBlock *BB = entry.first;
-    TinyBlockSet &headers = entry.second;
+    const TinyBlockSet &headers = entry.second;
     if (!headers.empty()) {
       BasicBlock *innerHeader = nullptr;
       int maxDiscovery = -1;
@@ -207,6 +204,12 @@ BasicBlock *LoopAnalysis::getLoopPreheader(const BasicBlock *BB) const {
   return nullptr;
 }
 
+bool LoopAnalysis::isBlockInLoop(const BasicBlock *BB, BasicBlock *header)
+    const {
+  auto entry = blockToHeaders_.find(BB);
+  return entry != blockToHeaders_.end() && entry->second.count(header);
+}
+
 static llvh::Optional<int> &nextScopeDepth(llvh::Optional<int> &depth) {
   if (depth) {
     *depth -= 1;
@@ -78,6 +78,8 @@ void hermes::runFullOptimizationPasses(Module &M) {
   PM.addTypeInference();
   PM.addCSE();
   PM.addSimplifyCFG();
+  // Hoist loop-invariant code once the loops have their final shape.
+  PM.addLICM();
 
   PM.addInstSimplify();
   PM.addFuncSigOpts();
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#define DEBUG_TYPE "licm"
+#include "hermes/Optimizer/Scalar/LICM.h"
+#include "hermes/IR/Analysis.h"
+#include "hermes/IR/CFG.h"
+#include "hermes/IR/Instrs.h"
+#include "hermes/Optimizer/Scalar/Utils.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvh/ADT/SmallPtrSet.h"
+#include "llvh/ADT/SmallVector.h"
+#include "llvh/Support/Debug.h"
+
+using namespace hermes;
+using llvh::dbgs;
+
+STATISTIC(NumLICM, "Number of instructions hoisted out of loops");
+STATISTIC(NumLICMFrameLoads, "Number of variable loads hoisted out of loops");
+STATISTIC(
+    NumLICMPropertyLoads,
+    "Number of property loads hoisted out of loops");
+
+namespace {
+
+/// What a loop may write, as far as hoisting is concerned.
+struct LoopWrites {
+  /// Variables stored to by instructions in the loop.
+  llvh::SmallPtrSet<const Variable *, 8> variables{};
+  /// Objects stored to by instructions in the loop, with the literal property
+  /// names they store, or null if the store may write any property.
+  llvh::SmallVector<std::pair<const Value *, const Value *>, 8> properties{};
+  /// Whether the loop contains an instruction with unknown side effects, such
+  /// as a call, which may run arbitrary code and write any variable it can
+  /// reach.
+  bool mayCallOut = false;
+
+  /// \returns true if the loop may store to property \p prop of \p obj.
+  bool mayStoreProperty(const Value *obj, const Value *prop) const {
+    for (const auto &store : properties) {
+      if (store.first == obj &&
+          (!store.second || store.second == prop ||
+           !llvh::isa<LiteralString>(prop)))
+        return true;
+    }
+    return false;
+  }
+};
+
+/// \returns true if the only stores to \p var are in \p F and \p var lives in
+/// the scope of \p F. Then code called from \p F can't write to the instance
+/// of \p var that \p F sees: even a recursive call of \p F gets its own.
+static bool isOnlyWrittenByOwnFunction(const Variable *var, const Function *F) {
+  ScopeDesc *scope = var->getParent();
+  if (!scope->hasFunction() || scope->getFunction() != F)
+    return false;
+  for (const Instruction *user : var->getUsers()) {
+    if (llvh::isa<StoreFrameInst>(user) && user->getParent()->getParent() != F)
+      return false;
+  }
+  return true;
+}
+
+/// \returns true if \p prop is known to be an own data property of \p obj
+/// wherever \p obj is used, because \p obj is an array and \p prop is its
+/// length, or \p obj is an object literal that defines \p prop.
+static bool isKnownOwnProperty(Instruction *obj, Value *prop) {
+  auto *name = llvh::dyn_cast<LiteralString>(prop);
+  if (!name)
+    return false;
+  if (llvh::isa<AllocArrayInst>(obj))
+    return name->getValue().str() == "length";
+  // The literal's own properties are defined in the block that allocates it.
+  for (Instruction *user : obj->getUsers()) {
+    auto *SOP = llvh::dyn_cast<StoreOwnPropertyInst>(user);
+    if (SOP && SOP->getObject() == obj && SOP->getProperty() == name &&
+        SOP->getParent() == obj->getParent())
+      return true;
+  }
+  return false;
+}
+
+/// \returns true if \p obj is an object or array allocated in this function
+/// that never escapes it: its only uses are loads and stores of its own
+/// properties. No other code can then observe or modify it, and loading its
+/// own properties neither throws nor runs getters.
+static bool isNonEscapingAllocation(Instruction *obj) {
+  if (!llvh::isa<AllocObjectInst>(obj) && !llvh::isa<AllocArrayInst>(obj))
+    return false;
+  for (Instruction *user : obj->getUsers()) {
+    if (user->getKind() == ValueKind::LoadPropertyInstKind) {
+      auto *LPI = llvh::cast<LoadPropertyInst>(user);
+      if (LPI->getObject() != obj ||
+          !isKnownOwnProperty(obj, LPI->getProperty()))
+        return false;
+    } else if (auto *SOP = llvh::dyn_cast<StoreOwnPropertyInst>(user)) {
+      // Defining a property never calls a setter.
+      if (SOP->getObject() != obj || SOP->getStoredValue() == obj ||
+          SOP->getProperty() == obj)
+        return false;
+    } else if (user->getKind() == ValueKind::StorePropertyInstKind) {
+      // Storing to a property that isn't own may call a setter on the
+      // prototype with obj as this.
+      auto *SPI = llvh::cast<StorePropertyInst>(user);
+      if (SPI->getObject() != obj || SPI->getStoredValue() == obj ||
+          !isKnownOwnProperty(obj, SPI->getProperty()))
+        return false;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \returns true if \p inst, which is in a loop that makes the writes
+/// described by \p writes, computes the same value on every iteration provided
+/// its operands do, and is safe to execute even when the loop wouldn't.
+static bool isInvariantInLoop(Instruction *inst, const LoopWrites &writes) {
+  if (isSimpleSideEffectFreeInstruction(inst))
+    return true;
+
+  if (auto *LFI = llvh::dyn_cast<LoadFrameInst>(inst)) {
+    Variable *var = LFI->getLoadVariable();
+    if (writes.variables.count(var))
+      return false;
+    return !writes.mayCallOut ||
+        isOnlyWrittenByOwnFunction(var, inst->getParent()->getParent());
+  }
+
+  // A load of an own property of an object that doesn't escape can only be
+  // clobbered by stores to the object in this function.
+  if (inst->getKind() == ValueKind::LoadPropertyInstKind) {
+    auto *LPI = llvh::cast<LoadPropertyInst>(inst);
+    auto *obj = llvh::dyn_cast<Instruction>(LPI->getObject());
+    return obj && isNonEscapingAllocation(obj) &&
+        !writes.mayStoreProperty(obj, LPI->getProperty());
+  }
+
+  return false;
+}
+
+/// Hoist the invariant instructions of the loop with header \p header into
+/// its preheader \p preheader. \p loopBlocks are the blocks in the loop, in
+/// reverse post order, so operands are visited before their users.
+/// \returns true if some instructions were hoisted.
+static bool hoistFromLoop(
+    BasicBlock *header,
+    BasicBlock *preheader,
+    llvh::ArrayRef<BasicBlock *> loopBlocks,
+    const LoopAnalysis &loops) {
+  LoopWrites writes{};
+  for (BasicBlock *BB : loopBlocks) {
+    for (Instruction &inst : *BB) {
+      if (auto *SFI = llvh::dyn_cast<StoreFrameInst>(&inst)) {
+        writes.variables.insert(SFI->getVariable());
+        continue;
+      }
+      // Arrays change their length when elements are stored, so a store to
+      // any property of an array may clobber any load from it.
+      auto addStore = [&writes](Value *obj, Value *prop) {
+        if (llvh::isa<AllocArrayInst>(obj) || !llvh::isa<LiteralString>(prop))
+          prop = nullptr;
+        writes.properties.push_back({obj, prop});
+      };
+      if (auto *SPI = llvh::dyn_cast<StorePropertyInst>(&inst))
+        addStore(SPI->getObject(), SPI->getProperty());
+      else if (auto *SOP = llvh::dyn_cast<StoreOwnPropertyInst>(&inst))
+        addStore(SOP->getObject(), SOP->getProperty());
+      if (inst.mayExecute())
+        writes.mayCallOut = true;
+    }
+  }
+
+  Instruction *branchInst = preheader->getTerminator();
+  bool changed = false;
+  for (BasicBlock *BB : loopBlocks) {
+    for (auto it = BB->begin(), e = BB->end(); it != e;) {
+      // Save the advanced iterator here since calling inst->moveBefore below
+      // invalidates the iterator.
+      Instruction *inst = &*it++;
+      if (!isInvariantInLoop(inst, writes))
+        continue;
+
+      // All the operands must be available in the preheader. An operand
+      // outside the loop dominates its use in the loop, and therefore the
+      // preheader, since the header dominates the loop.
+      bool operandsAvailable = true;
+      for (unsigned i = 0, numOps = inst->getNumOperands(); i < numOps; ++i) {
+        auto *operand = llvh::dyn_cast<Instruction>(inst->getOperand(i));
+        if (operand && loops.isBlockInLoop(operand->getParent(), header)) {
+          operandsAvailable = false;
+          break;
+        }
+      }
+      if (!operandsAvailable)
+        continue;
+
+      LLVM_DEBUG(
+          dbgs() << "Hoisting " << inst->getKindStr() << " out of loop at "
+                 << header->getParent()->getInternalNameStr() << "\n");
+      inst->moveBefore(branchInst);
+      changed = true;
+      ++NumLICM;
+      if (llvh::isa<LoadFrameInst>(inst))
+        ++NumLICMFrameLoads;
+      else if (llvh::isa<LoadPropertyInst>(inst))
+        ++NumLICMPropertyLoads;
+    }
+  }
+  return changed;
+}
+
+} // namespace
+
+bool LICM::runOnFunction(Function *F) {
+  DominanceInfo dominance(F);
+  LoopAnalysis loops(F, dominance);
+  PostOrderAnalysis PO(F);
+
+  // Visit the loops from the innermost out: an inner header finishes before
+  // the headers of enclosing loops in the post order. Then instructions hoisted
+  // into the preheader of an inner loop, which is in the outer loop, may be
+  // hoisted again out of the outer loop.
+  bool changed = false;
+  llvh::SmallVector<BasicBlock *, 16> loopBlocks;
+  for (BasicBlock *header : PO) {
+    if (!loops.isBlockHeader(header))
+      continue;
+    BasicBlock *preheader = loops.getLoopPreheader(header);
+    if (!preheader)
+      continue;
+
+    loopBlocks.clear();
+    for (auto it = PO.rbegin(), e = PO.rend(); it != e; ++it) {
+      if (loops.isBlockInLoop(*it, header))
+        loopBlocks.push_back(*it);
+    }
+    changed |= hoistFromLoop(header, preheader, loopBlocks, loops);
+  }
+  return changed;
+}
+
+std::unique_ptr<Pass> hermes::createLICM() {
+  return std::make_unique<LICM>();
+}
+
+#undef DEBUG_TYPE
@@ -9,11 +9,15 @@
 #include "hermes/Regex/RegexTraits.h"
 #include "hermes/Support/OptValue.h"
 
+#include "llvh/ADT/Optional.h"
 #include "llvh/ADT/ScopeExit.h"
 #include "llvh/ADT/SmallVector.h"
 #include "llvh/Support/TrailingObjects.h"
 #include "llvh/Support/raw_ostream.h"
 
+#include <algorithm>
+#include <cstring>
+
 // This file contains the machinery for executing a regexp compiled to bytecode.
 
 namespace hermes {
@@ -22,6 +26,9 @@ namespace regex {
 template <class Traits>
 struct State;
 
+template <class Traits>
+class LinearExecutor;
+
 /// Describes the exit status of a RegEx execution: it either returned
 /// normally or stack overflowed
 enum class ExecutionStatus : uint8_t { RETURNED, STACK_OVERFLOW };
@@ -475,6 +482,9 @@ struct Context {
       BacktrackStack &bts);
 
  private:
+  /// The linear-time executor shares the instruction implementations below.
+  friend class LinearExecutor<Traits>;
+
   /// Do initialization of the given state before it enters the loop body
   /// described by the LoopInsn \p loop, including setting up any backtracking
   /// state.
@@ -491,11 +501,11 @@ struct Context {
   inline bool matchWidth1(const Insn *insn, CodeUnit c) const;
 
   /// \return true if all chars, stored in contiguous memory after \p insn,
-  /// match the chars in state \p s in the same order, case insensitive. Note
-  /// the count of chars is given in \p insn.
+  /// match the chars under the cursor \p c in the same order, case
+  /// insensitive, consuming them. Note the count of chars is given in \p insn.
   inline bool matchesNCharICase8(
       const MatchNCharICase8Insn *insn,
-      State<Traits> &s);
+      Cursor<Traits> &c) const;
 
   /// Execute the given Width1 instruction \p loopBody on cursor \p c up to \p
   /// max times. \return the number of matches made, not to exceed \p max.
@@ -575,9 +585,8 @@ bool isLineTerminator(CharT c) {
 }
 
 template <class Traits>
-bool matchesLeftAnchor(Context<Traits> &ctx, State<Traits> &s) {
+bool matchesLeftAnchor(const Context<Traits> &ctx, const Cursor<Traits> &c) {
   bool matchesAnchor = false;
-  const Cursor<Traits> &c = s.cursor_;
   if (c.atLeft()) {
     // Beginning of text.
     matchesAnchor = true;
@@ -591,9 +600,8 @@ bool matchesLeftAnchor(Context<Traits> &ctx, State<Traits> &s) {
 }
 
 template <class Traits>
-bool matchesRightAnchor(Context<Traits> &ctx, State<Traits> &s) {
+bool matchesRightAnchor(const Context<Traits> &ctx, const Cursor<Traits> &c) {
   bool matchesAnchor = false;
-  const Cursor<Traits> &c = s.cursor_;
   if (c.atRight() && !(ctx.flags_ & constants::matchNotEndOfLine)) {
     matchesAnchor = true;
   } else if (
@@ -604,12 +612,30 @@ bool matchesRightAnchor(Context<Traits> &ctx, State<Traits> &s) {
   return matchesAnchor;
 }
 
+/// \return whether the cursor \p c is between a word character and a non-word
+/// character (or the start or end of the input).
+template <class Traits>
+bool matchesWordBoundary(const Context<Traits> &ctx, const Cursor<Traits> &c) {
+  const auto *charPointer = c.currentPointer();
+
+  bool prevIsWordchar = false;
+  if (!c.atLeft())
+    prevIsWordchar =
+        ctx.traits_.characterHasType(charPointer[-1], CharacterClass::Words);
+
+  bool currentIsWordchar = false;
+  if (!c.atRight())
+    currentIsWordchar =
+        ctx.traits_.characterHasType(charPointer[0], CharacterClass::Words);
+
+  return prevIsWordchar != currentIsWordchar;
+}
+
 /// \return true if all chars, stored in contiguous memory after \p insn,
-/// match the chars in state \p s in the same order. Note the count of chars
-/// is given in \p insn.
+/// match the chars under the cursor \p c in the same order, consuming them.
+/// Note the count of chars is given in \p insn.
 template <class Traits>
-bool matchesNChar8(const MatchNChar8Insn *insn, State<Traits> &s) {
-  Cursor<Traits> &c = s.cursor_;
+bool matchesNChar8(const MatchNChar8Insn *insn, Cursor<Traits> &c) {
   auto insnCharPtr = reinterpret_cast<const char *>(insn + 1);
   auto charCount = insn->charCount;
   for (int idx = 0; idx < charCount; idx++) {
@@ -623,8 +649,7 @@ bool matchesNChar8(const MatchNChar8Insn *insn, State<Traits> &s) {
 template <class Traits>
 bool Context<Traits>::matchesNCharICase8(
     const MatchNCharICase8Insn *insn,
-    State<Traits> &s) {
-  Cursor<Traits> &c = s.cursor_;
+    Cursor<Traits> &c) const {
   auto insnCharPtr = reinterpret_cast<const char *>(insn + 1);
   auto charCount = insn->charCount;
   bool unicode = syntaxFlags_.unicode;
@@ -936,6 +961,55 @@ ExecutorResult<bool> Context<Traits>::matchWidth1Loop(
   return true;
 }
 
+/// \return a pointer to the first occurrence of \p c in [\p first, \p last),
+/// or null if there is none.
+inline const char *
+findCodeUnit(const char *first, const char *last, char16_t c) {
+  // The input string is ASCII.
+  if (c > 0x7F)
+    return nullptr;
+  return static_cast<const char *>(std::memchr(first, c, last - first));
+}
+
+inline const char16_t *
+findCodeUnit(const char16_t *first, const char16_t *last, char16_t c) {
+  const char16_t *result = std::find(first, last, c);
+  return result == last ? nullptr : result;
+}
+
+/// \return the first index in [\p index, \p length) at which \p prefilter
+/// accepts the input starting at \p start as the start of a match, or
+/// \p length + 1 if there is none. If the prefilter rejects anything, a match
+/// consumes at least one character and so can't start at \p length.
+template <typename CodeUnit>
+size_t findPossibleMatchStart(
+    const MatchPrefilter &prefilter,
+    const CodeUnit *start,
+    size_t index,
+    size_t length) {
+  if (size_t prefixLength = prefilter.prefixLength) {
+    // Look for the first code unit of the prefix, then check the rest.
+    if (length < prefixLength)
+      return length + 1;
+    const CodeUnit *last = start + (length - prefixLength + 1);
+    for (const CodeUnit *cur = start + index; cur < last; ++cur) {
+      cur = findCodeUnit(cur, last, prefilter.prefix[0]);
+      if (!cur)
+        break;
+      if (std::equal(
+              prefilter.prefix + 1, prefilter.prefix + prefixLength, cur + 1))
+        return cur - start;
+    }
+    return length + 1;
+  }
+  using UnsignedCodeUnit = typename std::make_unsigned<CodeUnit>::type;
+  for (; index < length; ++index) {
+    if (prefilter.mayStartWith(static_cast<UnsignedCodeUnit>(start[index])))
+      return index;
+  }
+  return length + 1;
+}
+
 /// ES6 21.2.5.2.3. Effectively this skips surrogate pairs if the regexp has the
 /// Unicode flag set.
 template <class Traits>
@@ -981,6 +1055,14 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
   // Save the incoming IP in case we have to loop.
   const auto startIp = s->ip_;
 
+  // When searching the whole input, skip the locations where the prefilter
+  // says the regex can't match.
+  const auto *header =
+      reinterpret_cast<const RegexBytecodeHeader *>(bytecodeStream_.data());
+  const MatchPrefilter *prefilter =
+      !onlyAtStart && !header->prefilter.acceptsAll() ? &header->prefilter
+                                                       : nullptr;
+
   const CodeUnit *const startLoc = c.currentPointer();
 
   // Use offsetFromRight() instead of remaining() here so that the length passed
@@ -1023,6 +1105,12 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
   for (size_t locIndex = 0; locIndex < locsToCheckCount;
        locIndex = advanceStringIndex(startLoc, locIndex, charsToRight)) {
+    if (prefilter) {
+      locIndex =
+          findPossibleMatchStart(*prefilter, startLoc, locIndex, charsToRight);
+      if (locIndex >= locsToCheckCount)
+        break;
+    }
     const CodeUnit *potentialMatchLocation = startLoc + locIndex;
     c.setCurrentPointer(potentialMatchLocation);
     s->ip_ = startIp;
@@ -1034,13 +1122,13 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
           return potentialMatchLocation;
 
         case Opcode::LeftAnchor:
-          if (!matchesLeftAnchor(*this, *s))
+          if (!matchesLeftAnchor(*this, c))
             BACKTRACK();
           s->ip_ += sizeof(LeftAnchorInsn);
           break;
 
         case Opcode::RightAnchor:
-          if (!matchesRightAnchor(*this, *s))
+          if (!matchesRightAnchor(*this, c))
             BACKTRACK();
           s->ip_ += sizeof(RightAnchorInsn);
           break;
@@ -1129,7 +1217,7 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
         case Opcode::MatchNChar8: {
           const auto *insn = llvh::cast<MatchNChar8Insn>(base);
-          if (c.remaining() < insn->charCount || !matchesNChar8(insn, *s))
+          if (c.remaining() < insn->charCount || !matchesNChar8(insn, c))
             BACKTRACK();
           s->ip_ += insn->totalWidth();
           break;
@@ -1137,7 +1225,7 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
         case Opcode::MatchNCharICase8: {
           const auto *insn = llvh::cast<MatchNCharICase8Insn>(base);
-          if (c.remaining() < insn->charCount || !matchesNCharICase8(insn, *s))
+          if (c.remaining() < insn->charCount || !matchesNCharICase8(insn, c))
             BACKTRACK();
           s->ip_ += insn->totalWidth();
           break;
@@ -1199,20 +1287,7 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
         case Opcode::WordBoundary: {
           const WordBoundaryInsn *insn = llvh::cast<WordBoundaryInsn>(base);
-          const auto *charPointer = c.currentPointer();
-
-          bool prevIsWordchar = false;
-          if (!c.atLeft())
-            prevIsWordchar = traits_.characterHasType(
-                charPointer[-1], CharacterClass::Words);
-
-          bool currentIsWordchar = false;
-          if (!c.atRight())
-            currentIsWordchar =
-                traits_.characterHasType(charPointer[0], CharacterClass::Words);
-
-          bool isWordBoundary = (prevIsWordchar != currentIsWordchar);
-          if (isWordBoundary ^ insn->invert)
+          if (matchesWordBoundary(*this, c) ^ insn->invert)
             s->ip_ += sizeof(WordBoundaryInsn);
           else
             BACKTRACK();
@@ -1525,6 +1600,799 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
   return nullptr;
 }
 
+/// \return the width of the instruction \p insn, including any trailing data.
+/// All instructions are fixed-width, except for brackets, MatchNChar8Insn, and
+/// MatchNCharICase8Insn.
+template <typename Instruction>
+uint32_t instructionWidth(const Instruction *insn) {
+  return sizeof *insn;
+}
+
+inline uint32_t instructionWidth(const BracketInsn *insn) {
+  return insn->totalWidth();
+}
+
+inline uint32_t instructionWidth(const U16BracketInsn *insn) {
+  return insn->totalWidth();
+}
+
+inline uint32_t instructionWidth(const MatchNChar8Insn *insn) {
+  return insn->totalWidth();
+}
+
+inline uint32_t instructionWidth(const MatchNCharICase8Insn *insn) {
+  return insn->totalWidth();
+}
+
+inline uint32_t instructionWidth(const Insn *insn) {
+  switch (insn->opcode) {
+#define REOP(Code)      \
+  case Opcode::Code:    \
+    return instructionWidth(llvh::cast<Code##Insn>(insn));
+#include "hermes/Regex/RegexOpcodes.def"
+  }
+  llvm_unreachable("Invalid opcode");
+}
+
+/// LinearProgram describes the states a thread of the LinearExecutor can be in
+/// while running a regex. A state is an instruction together with the progress
+/// of every loop enclosing it: its iteration count, and whether the current
+/// iteration was entered at the current input position. The loops a thread is
+/// not inside always have zeroed LoopData, so they don't add to the state.
+/// States are numbered densely so the executor can track them in a flat array.
+class LinearProgram {
+ public:
+  /// The maximum number of states a regex may have for the LinearExecutor to
+  /// run it.
+  static constexpr uint32_t kMaxStates = 1u << 16;
+
+  /// Analyze the regex compiled to \p bytecode, including its header.
+  explicit LinearProgram(llvh::ArrayRef<uint8_t> bytecode);
+
+  /// \return whether the LinearExecutor can run the regex. It can't run
+  /// backreferences or lookarounds, nor counted loops with too many states.
+  bool isSupported() const {
+    return supported_;
+  }
+
+  /// \return the number of states.
+  uint32_t stateCount() const {
+    return stateCount_;
+  }
+
+  /// \return the largest iteration count stored for the loop \p loopId.
+  /// Iterations of an unbounded loop past its minimum all behave the same, so
+  /// its count saturates at one more than the minimum.
+  uint32_t iterationLimit(uint32_t loopId) const {
+    return iterationLimits_[loopId];
+  }
+
+  /// \return the state of a thread at instruction \p ip whose loops are
+  /// described by \p loops, when it is at the input position \p pos.
+  uint32_t stateIndex(uint32_t ip, const LoopData *loops, uint32_t pos) const {
+    const InsnInfo &info = insnInfos_[ip];
+    uint32_t index = 0;
+    for (uint32_t i = info.loopsBegin; i != info.loopsEnd; ++i) {
+      uint32_t loopId = enclosingLoops_[i];
+      const LoopData &loop = loops[loopId];
+      // The entry position is only ever compared to the current position, to
+      // reject iterations that matched the empty string.
+      bool enteredHere = loop.iterations != 0 && loop.entryPosition == pos;
+      index = index * stateRadix(loopId) + loop.iterations * 2 + enteredHere;
+    }
+    return info.firstState + index;
+  }
+
+ private:
+  /// \return the number of states of the loop \p loopId.
+  uint32_t stateRadix(uint32_t loopId) const {
+    return (iterationLimits_[loopId] + 1) * 2;
+  }
+
+  /// Information about the instruction at some offset.
+  struct InsnInfo {
+    /// The index of the first state at this instruction.
+    uint32_t firstState;
+
+    /// The range of enclosingLoops_ listing the loops around this
+    /// instruction, outermost first.
+    uint32_t loopsBegin;
+    uint32_t loopsEnd;
+  };
+
+  /// Whether the LinearExecutor can run the regex.
+  bool supported_ = false;
+
+  /// The total number of states.
+  uint32_t stateCount_ = 0;
+
+  /// Information about each instruction, indexed by its offset.
+  std::vector<InsnInfo> insnInfos_;
+
+  /// The loop IDs enclosing each instruction.
+  std::vector<uint32_t> enclosingLoops_;
+
+  /// The largest stored iteration count of each loop.
+  std::vector<uint32_t> iterationLimits_;
+};
+
+LinearProgram::LinearProgram(llvh::ArrayRef<uint8_t> bytecode) {
+  const auto *header =
+      reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+  llvh::ArrayRef<uint8_t> insns = bytecode.slice(sizeof(RegexBytecodeHeader));
+  iterationLimits_.resize(header->loopCount);
+  insnInfos_.resize(insns.size());
+
+  // The loops enclosing the current instruction, as pairs of loop ID and the
+  // offset just past the loop.
+  llvh::SmallVector<std::pair<uint32_t, uint32_t>, 8> openLoops;
+  auto openLoop = [&](uint32_t loopId, uint32_t min, uint32_t max, uint32_t end) {
+    uint64_t limit = max != UINT32_MAX ? max : uint64_t(min) + 1;
+    if (limit >= kMaxStates)
+      return false;
+    iterationLimits_[loopId] = limit;
+    openLoops.push_back({loopId, end});
+    return true;
+  };
+
+  uint64_t stateCount = 0;
+  for (uint32_t ip = 0; ip < insns.size();) {
+    const Insn *insn = reinterpret_cast<const Insn *>(&insns[ip]);
+    while (!openLoops.empty() && openLoops.back().second <= ip)
+      openLoops.pop_back();
+
+    switch (insn->opcode) {
+      case Opcode::BackRef:
+      case Opcode::Lookaround:
+        return;
+      case Opcode::BeginLoop: {
+        const auto *loop = llvh::cast<BeginLoopInsn>(insn);
+        if (!openLoop(loop->loopId, loop->min, loop->max, loop->notTakenTarget))
+          return;
+        break;
+      }
+      case Opcode::Width1Loop: {
+        const auto *loop = llvh::cast<Width1LoopInsn>(insn);
+        if (!openLoop(loop->loopId, loop->min, loop->max, loop->notTakenTarget))
+          return;
+        break;
+      }
+      default:
+        break;
+    }
+
+    uint64_t insnStates = 1;
+    InsnInfo &info = insnInfos_[ip];
+    info.firstState = stateCount;
+    info.loopsBegin = enclosingLoops_.size();
+    for (const auto &loop : openLoops) {
+      insnStates *= stateRadix(loop.first);
+      if (insnStates > kMaxStates)
+        return;
+      enclosingLoops_.push_back(loop.first);
+    }
+    info.loopsEnd = enclosingLoops_.size();
+    stateCount += insnStates;
+    if (stateCount > kMaxStates)
+      return;
+    ip += instructionWidth(insn);
+  }
+  stateCount_ = stateCount;
+  supported_ = true;
+}
+
+/// LinearExecutor runs regex bytecode in time linear in the length of the
+/// input, as a "Pike VM". Rather than exploring one way of matching at a time
+/// and backtracking, it moves all of them through the input in lockstep, one
+/// code unit at a time. Whenever two threads reach the same state at the same
+/// position, their futures are identical apart from their captures, so only
+/// the one with higher priority is kept. That bounds the work per code unit by
+/// the number of states, where backtracking may take exponential time.
+/// Threads are kept in the order the backtracking executor would try them, so
+/// both find the same match and captures.
+template <class Traits>
+class LinearExecutor {
+  using CodeUnit = typename Traits::CodeUnit;
+  using CodePoint = typename Traits::CodePoint;
+
+ public:
+  LinearExecutor(Context<Traits> &ctx, const LinearProgram &program);
+
+  /// Search for a match in the same way as Context::match() with a forwards
+  /// cursor.
+  /// \return a pointer to the start of the match, or nullptr if there is none.
+  /// On success, populates \p state with the end of the match and the
+  /// captured ranges.
+  const CodeUnit *match(State<Traits> *state, bool onlyAtStart);
+
+ private:
+  /// A thread waiting to consume input.
+  struct Thread {
+    /// The consuming instruction to run.
+    uint32_t ip;
+
+    /// The instruction to continue at after consuming.
+    uint32_t next;
+
+    /// The slot holding the captures and loop datas of the thread.
+    uint32_t slot;
+
+    /// If nonzero, the thread has already consumed the input up to this many
+    /// code units past the current position, and continues at next there.
+    uint32_t wait;
+  };
+
+  using ThreadList = std::vector<Thread>;
+
+  /// Set in an instruction offset to refer to the body of the Width1Loop at
+  /// that offset rather than the loop itself.
+  static constexpr uint32_t kWidth1LoopBody = 1u << 31;
+
+  /// \return the instruction at offset \p ip.
+  const Insn *insnAt(uint32_t ip) const {
+    return reinterpret_cast<const Insn *>(&bytecode_[ip]);
+  }
+
+  /// \return the captured ranges of the thread in \p slot.
+  CapturedRange *capturesOf(uint32_t slot) {
+    return captures_.data() + slot * markedCount_;
+  }
+
+  /// \return the loop datas of the thread in \p slot.
+  LoopData *loopsOf(uint32_t slot) {
+    return loops_.data() + slot * loopCount_;
+  }
+
+  /// \return a slot for a new thread whose match starts at \p start.
+  uint32_t newThread(uint32_t start);
+
+  /// \return a slot for a copy of the thread in \p slot.
+  uint32_t copyThread(uint32_t slot);
+
+  /// Discard the thread in \p slot.
+  void killThread(uint32_t slot) {
+    freeSlots_.push_back(slot);
+  }
+
+  /// \return an unused slot. Note this may reallocate the slot storage.
+  uint32_t allocateSlot();
+
+  /// Run the thread in \p slot from the instruction \p ip at the input
+  /// position \p pos, along with every alternative it spawns, until each
+  /// reaches a consuming instruction, which is appended to \p list, or dies.
+  /// \return true if a thread reached the goal, in which case lower priority
+  /// alternatives were discarded.
+  bool addThread(ThreadList &list, uint32_t ip, uint32_t slot, uint32_t pos);
+
+  /// Run a single thread for addThread(), pushing the alternatives it spawns
+  /// onto branches_. \return true if it reached the goal.
+  bool runThread(ThreadList &list, uint32_t ip, uint32_t slot, uint32_t pos);
+
+  /// addThread() for a thread that has finished consuming, continuing at
+  /// \p next.
+  bool resumeThread(ThreadList &list, uint32_t next, uint32_t slot, uint32_t pos);
+
+  /// Run the consuming instruction \p insn at the input position \p pos.
+  /// \return the number of code units it consumed, or 0 if it didn't match.
+  uint32_t consume(const Insn *insn, uint32_t pos) const;
+
+  /// Update the thread in \p slot to start an iteration of \p loop at the input
+  /// position \p pos.
+  void enterLoopBody(uint32_t slot, const BeginLoopInsn *loop, uint32_t pos);
+
+  /// Update the thread in \p slot to leave the loop \p loopId.
+  void exitLoop(uint32_t slot, uint32_t loopId) {
+    loopsOf(slot)[loopId] = {0, 0};
+  }
+
+  Context<Traits> &ctx_;
+  const LinearProgram &program_;
+
+  /// The instructions, following the header.
+  const uint8_t *const bytecode_;
+
+  const uint32_t markedCount_;
+  const uint32_t loopCount_;
+
+  /// Per-slot thread data: where its match started, its captures, and its
+  /// loop datas.
+  std::vector<uint32_t> starts_;
+  std::vector<CapturedRange> captures_;
+  std::vector<LoopData> loops_;
+
+  /// Slots not in use.
+  std::vector<uint32_t> freeSlots_;
+
+  /// For each state, one more than the last input position at which a thread
+  /// reached it.
+  std::vector<uint32_t> visited_;
+
+  /// Alternatives that addThread() has yet to run, as pairs of instruction
+  /// offset and slot, with the lowest priority at the bottom.
+  std::vector<std::pair<uint32_t, uint32_t>> branches_;
+
+  /// The best match found so far, if matched_ is set.
+  bool matched_ = false;
+  uint32_t matchStart_ = 0;
+  uint32_t matchEnd_ = 0;
+  std::vector<CapturedRange> matchCaptures_;
+};
+
+template <class Traits>
+LinearExecutor<Traits>::LinearExecutor(
+    Context<Traits> &ctx,
+    const LinearProgram &program)
+    : ctx_(ctx),
+      program_(program),
+      bytecode_(&ctx.bytecodeStream_[sizeof(RegexBytecodeHeader)]),
+      markedCount_(ctx.markedCount_),
+      loopCount_(ctx.loopCount_),
+      visited_(program.stateCount(), 0) {}
+
+template <class Traits>
+uint32_t LinearExecutor<Traits>::allocateSlot() {
+  if (!freeSlots_.empty()) {
+    uint32_t slot = freeSlots_.back();
+    freeSlots_.pop_back();
+    return slot;
+  }
+  uint32_t slot = starts_.size();
+  starts_.push_back(0);
+  captures_.resize(captures_.size() + markedCount_);
+  loops_.resize(loops_.size() + loopCount_);
+  return slot;
+}
+
+template <class Traits>
+uint32_t LinearExecutor<Traits>::newThread(uint32_t start) {
+  uint32_t slot = allocateSlot();
+  starts_[slot] = start;
+  std::fill_n(capturesOf(slot), markedCount_, CapturedRange{kNotMatched, kNotMatched});
+  std::fill_n(loopsOf(slot), loopCount_, LoopData{0, 0});
+  return slot;
+}
+
+template <class Traits>
+uint32_t LinearExecutor<Traits>::copyThread(uint32_t slot) {
+  uint32_t copy = allocateSlot();
+  starts_[copy] = starts_[slot];
+  std::copy_n(capturesOf(slot), markedCount_, capturesOf(copy));
+  std::copy_n(loopsOf(slot), loopCount_, loopsOf(copy));
+  return copy;
+}
+
+template <class Traits>
+void LinearExecutor<Traits>::enterLoopBody(
+    uint32_t slot,
+    const BeginLoopInsn *loop,
+    uint32_t pos) {
+  LoopData &loopData = loopsOf(slot)[loop->loopId];
+  loopData.iterations = std::min(
+      loopData.iterations + 1, program_.iterationLimit(loop->loopId));
+  loopData.entryPosition = pos;
+  CapturedRange *captures = capturesOf(slot);
+  std::fill(
+      captures + loop->mexpBegin,
+      captures + loop->mexpEnd,
+      CapturedRange{kNotMatched, kNotMatched});
+}
+
+template <class Traits>
+bool LinearExecutor<Traits>::addThread(
+    ThreadList &list,
+    uint32_t ip,
+    uint32_t slot,
+    uint32_t pos) {
+  branches_.push_back({ip, slot});
+  while (!branches_.empty()) {
+    std::tie(ip, slot) = branches_.back();
+    branches_.pop_back();
+    if (runThread(list, ip, slot, pos)) {
+      // Everything left is lower priority than the match.
+      for (const auto &branch : branches_)
+        killThread(branch.second);
+      branches_.clear();
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class Traits>
+bool LinearExecutor<Traits>::runThread(
+    ThreadList &list,
+    uint32_t ip,
+    uint32_t slot,
+    uint32_t pos) {
+  const Cursor<Traits> c{ctx_.first_, ctx_.first_ + pos, ctx_.last_, true};
+  const auto flags = ctx_.flags_;
+
+  // A Width1Loop that chose to run its body, after the loop's state was
+  // visited.
+  if (ip & kWidth1LoopBody) {
+    ip &= ~kWidth1LoopBody;
+    list.push_back(
+        {ip + (uint32_t)sizeof(Width1LoopInsn), ip | kWidth1LoopBody, slot, 0});
+    return false;
+  }
+
+  for (;;) {
+    uint32_t &visited = visited_[program_.stateIndex(ip, loopsOf(slot), pos)];
+    if (visited == pos + 1) {
+      // A higher priority thread got here first.
+      killThread(slot);
+      return false;
+    }
+    visited = pos + 1;
+
+    const Insn *base = insnAt(ip);
+    switch (base->opcode) {
+      case Opcode::Goal:
+        matched_ = true;
+        matchStart_ = starts_[slot];
+        matchEnd_ = pos;
+        matchCaptures_.assign(capturesOf(slot), capturesOf(slot) + markedCount_);
+        killThread(slot);
+        return true;
+
+      case Opcode::LeftAnchor:
+        if (!matchesLeftAnchor(ctx_, c)) {
+          killThread(slot);
+          return false;
+        }
+        ip += sizeof(LeftAnchorInsn);
+        break;
+
+      case Opcode::RightAnchor:
+        if (!matchesRightAnchor(ctx_, c)) {
+          killThread(slot);
+          return false;
+        }
+        ip += sizeof(RightAnchorInsn);
+        break;
+
+      case Opcode::WordBoundary:
+        if (!(matchesWordBoundary(ctx_, c) ^
+              llvh::cast<WordBoundaryInsn>(base)->invert)) {
+          killThread(slot);
+          return false;
+        }
+        ip += sizeof(WordBoundaryInsn);
+        break;
+
+      case Opcode::MatchAny:
+      case Opcode::U16MatchAny:
+      case Opcode::MatchAnyButNewline:
+      case Opcode::U16MatchAnyButNewline:
+      case Opcode::MatchChar8:
+      case Opcode::MatchChar16:
+      case Opcode::U16MatchChar32:
+      case Opcode::MatchCharICase8:
+      case Opcode::MatchCharICase16:
+      case Opcode::U16MatchCharICase32:
+      case Opcode::MatchNChar8:
+      case Opcode::MatchNCharICase8:
+      case Opcode::Bracket:
+      case Opcode::U16Bracket:
+        list.push_back({ip, ip + instructionWidth(base), slot, 0});
+        return false;
+
+      case Opcode::Alternation: {
+        const AlternationInsn *alt = llvh::cast<AlternationInsn>(base);
+        bool primaryViable = c.satisfiesConstraints(flags, alt->primaryConstraints);
+        bool secondaryViable =
+            c.satisfiesConstraints(flags, alt->secondaryConstraints);
+        if (primaryViable && secondaryViable) {
+          branches_.push_back({alt->secondaryBranch, copyThread(slot)});
+          ip += sizeof(AlternationInsn);
+        } else if (primaryViable) {
+          ip += sizeof(AlternationInsn);
+        } else if (secondaryViable) {
+          ip = alt->secondaryBranch;
+        } else {
+          killThread(slot);
+          return false;
+        }
+        break;
+      }
+
+      case Opcode::Jump32:
+        ip = llvh::cast<Jump32Insn>(base)->target;
+        break;
+
+      case Opcode::BeginMarkedSubexpression: {
+        const auto *insn = llvh::cast<BeginMarkedSubexpressionInsn>(base);
+        capturesOf(slot)[insn->mexp].start = pos;
+        ip += sizeof(BeginMarkedSubexpressionInsn);
+        break;
+      }
+
+      case Opcode::EndMarkedSubexpression: {
+        const auto *insn = llvh::cast<EndMarkedSubexpressionInsn>(base);
+        capturesOf(slot)[insn->mexp].end = pos;
+        ip += sizeof(EndMarkedSubexpressionInsn);
+        break;
+      }
+
+      case Opcode::BackRef:
+      case Opcode::Lookaround:
+        llvm_unreachable("LinearProgram should have rejected the regex");
+
+      case Opcode::BeginLoop: {
+        const BeginLoopInsn *loop = llvh::cast<BeginLoopInsn>(base);
+        exitLoop(slot, loop->loopId);
+        if (!c.satisfiesConstraints(flags, loop->loopeeConstraints)) {
+          if (loop->min > 0) {
+            killThread(slot);
+            return false;
+          }
+          ip = loop->notTakenTarget;
+          break;
+        }
+        goto runLoop;
+      }
+
+      case Opcode::EndLoop:
+        ip = llvh::cast<EndLoopInsn>(base)->target;
+        base = insnAt(ip);
+        // Note fall through.
+
+      runLoop: {
+        // This mirrors runLoop in Context::match(), with the alternative that
+        // would be backtracked to pushed as a lower priority branch.
+        const BeginLoopInsn *loop = llvh::cast<BeginLoopInsn>(base);
+        const LoopData loopData = loopsOf(slot)[loop->loopId];
+        const uint32_t loopTakenIp = ip + sizeof(BeginLoopInsn);
+        if (loopData.iterations > loop->min && loopData.entryPosition == pos) {
+          killThread(slot);
+          return false;
+        }
+        if (loopData.iterations < loop->min) {
+          enterLoopBody(slot, loop, pos);
+          ip = loopTakenIp;
+        } else if (loopData.iterations == loop->max) {
+          exitLoop(slot, loop->loopId);
+          ip = loop->notTakenTarget;
+        } else if (loop->greedy) {
+          uint32_t exitSlot = copyThread(slot);
+          exitLoop(exitSlot, loop->loopId);
+          branches_.push_back({loop->notTakenTarget, exitSlot});
+          enterLoopBody(slot, loop, pos);
+          ip = loopTakenIp;
+        } else {
+          uint32_t bodySlot = copyThread(slot);
+          enterLoopBody(bodySlot, loop, pos);
+          branches_.push_back({loopTakenIp, bodySlot});
+          exitLoop(slot, loop->loopId);
+          ip = loop->notTakenTarget;
+        }
+        break;
+      }
+
+      case Opcode::BeginSimpleLoop: {
+        const BeginSimpleLoopInsn *loop = llvh::cast<BeginSimpleLoopInsn>(base);
+        if (!c.satisfiesConstraints(flags, loop->loopeeConstraints)) {
+          ip = loop->notTakenTarget;
+          break;
+        }
+        goto runSimpleLoop;
+      }
+
+      case Opcode::EndSimpleLoop:
+        ip = llvh::cast<EndSimpleLoopInsn>(base)->target;
+        base = insnAt(ip);
+        // Note fall through.
+
+      runSimpleLoop: {
+        const BeginSimpleLoopInsn *loop = llvh::cast<BeginSimpleLoopInsn>(base);
+        branches_.push_back({loop->notTakenTarget, copyThread(slot)});
+        ip += sizeof(BeginSimpleLoopInsn);
+        break;
+      }
+
+      case Opcode::Width1Loop: {
+        // A Width1Loop runs its body as a consuming instruction of this
+        // thread, which comes back here after counting the iteration. Its loop
+        // data is zero when entering from outside.
+        const Width1LoopInsn *loop = llvh::cast<Width1LoopInsn>(base);
+        uint32_t iterations = loopsOf(slot)[loop->loopId].iterations;
+        const Thread body{
+            ip + (uint32_t)sizeof(Width1LoopInsn), ip | kWidth1LoopBody, slot, 0};
+        if (iterations < loop->min) {
+          list.push_back(body);
+          return false;
+        }
+        if (iterations == loop->max) {
+          exitLoop(slot, loop->loopId);
+          ip = loop->notTakenTarget;
+          break;
+        }
+        if (loop->greedy) {
+          uint32_t exitSlot = copyThread(slot);
+          exitLoop(exitSlot, loop->loopId);
+          branches_.push_back({loop->notTakenTarget, exitSlot});
+          list.push_back(body);
+          return false;
+        }
+        branches_.push_back({ip | kWidth1LoopBody, copyThread(slot)});
+        exitLoop(slot, loop->loopId);
+        ip = loop->notTakenTarget;
+        break;
+      }
+    }
+  }
+}
+
+template <class Traits>
+bool LinearExecutor<Traits>::resumeThread(
+    ThreadList &list,
+    uint32_t next,
+    uint32_t slot,
+    uint32_t pos) {
+  if (next & kWidth1LoopBody) {
+    next &= ~kWidth1LoopBody;
+    const auto *loop = llvh::cast<Width1LoopInsn>(insnAt(next));
+    LoopData &loopData = loopsOf(slot)[loop->loopId];
+    loopData.iterations = std::min(
+        loopData.iterations + 1, program_.iterationLimit(loop->loopId));
+  }
+  return addThread(list, next, slot, pos);
+}
+
+template <class Traits>
+uint32_t LinearExecutor<Traits>::consume(const Insn *base, uint32_t pos)
+    const {
+  Cursor<Traits> c{ctx_.first_, ctx_.first_ + pos, ctx_.last_, true};
+  if (c.atEnd())
+    return 0;
+  using W1 = Width1Opcode;
+  bool matched = false;
+  switch (base->opcode) {
+    case Opcode::MatchAny:
+      matched = ctx_.template matchWidth1<W1::MatchAny>(base, c.consume());
+      break;
+    case Opcode::MatchAnyButNewline:
+      matched =
+          ctx_.template matchWidth1<W1::MatchAnyButNewline>(base, c.consume());
+      break;
+    case Opcode::MatchChar8:
+      matched = ctx_.template matchWidth1<W1::MatchChar8>(base, c.consume());
+      break;
+    case Opcode::MatchChar16:
+      matched = ctx_.template matchWidth1<W1::MatchChar16>(base, c.consume());
+      break;
+    case Opcode::MatchCharICase8:
+      matched =
+          ctx_.template matchWidth1<W1::MatchCharICase8>(base, c.consume());
+      break;
+    case Opcode::MatchCharICase16:
+      matched =
+          ctx_.template matchWidth1<W1::MatchCharICase16>(base, c.consume());
+      break;
+    case Opcode::Bracket:
+      matched = ctx_.template matchWidth1<W1::Bracket>(base, c.consume());
+      break;
+    case Opcode::U16MatchAny:
+      c.consumeUTF16();
+      matched = true;
+      break;
+    case Opcode::U16MatchAnyButNewline:
+      matched = !isLineTerminator(c.consumeUTF16());
+      break;
+    case Opcode::U16MatchChar32:
+      matched =
+          c.consumeUTF16() == (CodePoint)llvh::cast<U16MatchChar32Insn>(base)->c;
+      break;
+    case Opcode::U16MatchCharICase32: {
+      const auto *insn = llvh::cast<U16MatchCharICase32Insn>(base);
+      CodePoint cp = c.consumeUTF16();
+      matched =
+          (cp == (CodePoint)insn->c ||
+           ctx_.traits_.canonicalize(cp, true) == (CodePoint)insn->c);
+      break;
+    }
+    case Opcode::MatchNChar8: {
+      const auto *insn = llvh::cast<MatchNChar8Insn>(base);
+      matched = c.remaining() >= insn->charCount && matchesNChar8(insn, c);
+      break;
+    }
+    case Opcode::MatchNCharICase8: {
+      const auto *insn = llvh::cast<MatchNCharICase8Insn>(base);
+      matched = c.remaining() >= insn->charCount &&
+          ctx_.matchesNCharICase8(insn, c);
+      break;
+    }
+    case Opcode::U16Bracket: {
+      const U16BracketInsn *insn = llvh::cast<U16BracketInsn>(base);
+      const BracketRange32 *ranges =
+          reinterpret_cast<const BracketRange32 *>(insn + 1);
+      matched =
+          bracketMatchesChar<Traits>(ctx_, insn, ranges, c.consumeUTF16());
+      break;
+    }
+    default:
+      llvm_unreachable("Not a consuming instruction");
+  }
+  return matched ? c.offsetFromLeft() - pos : 0;
+}
+
+template <class Traits>
+auto LinearExecutor<Traits>::match(State<Traits> *s, bool onlyAtStart)
+    -> const CodeUnit * {
+  assert(s->cursor_.forwards() && "LinearExecutor only runs forwards");
+  const CodeUnit *const startLoc = s->cursor_.currentPointer();
+  const uint32_t startPos = s->cursor_.offsetFromLeft();
+  const size_t charsToRight = s->cursor_.offsetFromRight();
+
+  const auto *header =
+      reinterpret_cast<const RegexBytecodeHeader *>(ctx_.bytecodeStream_.data());
+  const MatchPrefilter *prefilter =
+      !onlyAtStart && !header->prefilter.acceptsAll() ? &header->prefilter
+                                                       : nullptr;
+
+  // The threads at the current position, in priority order, and those at the
+  // next position being built from them.
+  ThreadList current;
+  ThreadList next;
+
+  // The next index (relative to startLoc) at which a match may start. Threads
+  // started there have the lowest priority, since earlier matches win.
+  size_t nextStart = 0;
+  for (size_t index = 0;; ++index) {
+    if (current.empty()) {
+      // Nothing is in flight, so skip ahead to the next start.
+      if (matched_ || nextStart > charsToRight)
+        break;
+      index = nextStart;
+    }
+    const uint32_t pos = startPos + index;
+    if (!matched_ && index == nextStart) {
+      if (prefilter)
+        nextStart =
+            findPossibleMatchStart(*prefilter, startLoc, index, charsToRight);
+      if (index == nextStart) {
+        addThread(current, 0, newThread(pos), pos);
+        nextStart = onlyAtStart
+            ? charsToRight + 1
+            : ctx_.advanceStringIndex(startLoc, index, charsToRight);
+      }
+    }
+    if (index == charsToRight)
+      break;
+
+    // Move every thread past the code unit at pos, stopping at the first
+    // that matches: the rest have lower priority.
+    bool reachedGoal = false;
+    for (const Thread &thread : current) {
+      if (reachedGoal) {
+        killThread(thread.slot);
+      } else if (thread.wait > 1) {
+        next.push_back({thread.ip, thread.next, thread.slot, thread.wait - 1});
+      } else if (thread.wait == 1) {
+        reachedGoal = resumeThread(next, thread.next, thread.slot, pos + 1);
+      } else if (uint32_t consumed = consume(insnAt(thread.ip), pos)) {
+        if (consumed == 1)
+          reachedGoal = resumeThread(next, thread.next, thread.slot, pos + 1);
+        else
+          next.push_back({thread.ip, thread.next, thread.slot, consumed - 1});
+      } else {
+        killThread(thread.slot);
+      }
+    }
+    current.swap(next);
+    next.clear();
+  }
+
+  if (!matched_)
+    return nullptr;
+  s->cursor_.setCurrentPointer(ctx_.first_ + matchEnd_);
+  std::copy(
+      matchCaptures_.begin(),
+      matchCaptures_.end(),
+      s->capturedRanges_.begin());
+  return ctx_.first_ + matchStart_;
+}
+
 /// Entry point for searching a string via regex compiled bytecode.
 /// Given the bytecode \p bytecode, search the range starting at \p first up to
 /// (not including) \p last with the flags \p matchFlags. If the search
@@ -1550,31 +2418,47 @@ MatchRuntimeResult searchWithBytecodeImpl(
   if (!cursor.satisfiesConstraints(matchFlags, header->constraints))
     return MatchRuntimeResult::NoMatch;
 
+  // Analysis of the regex for the linear-time executor, done only once we
+  // decide to use it.
+  llvh::Optional<LinearProgram> linearProgram;
+
   auto markedCount = header->markedCount;
   auto loopCount = header->loopCount;
 
-  Context<Traits> ctx(
-      bytecode,
-      matchFlags,
-      SyntaxFlags::fromByte(header->syntaxFlags),
-      first,
-      first + length,
-      header->markedCount,
-      header->loopCount,
-      guard);
-  State<Traits> state{cursor, markedCount, loopCount};
-
   // We check only one location if either the regex pattern constrains us to, or
   // the flags request it (via the sticky flag 'y').
   bool onlyAtStart = (header->constraints & MatchConstraintAnchoredAtStart) ||
       (matchFlags & constants::matchOnlyAtStart);
 
-  auto res = ctx.match(&state, onlyAtStart);
-  if (!res) {
-    assert(res.getStatus() == ExecutionStatus::STACK_OVERFLOW);
-    return MatchRuntimeResult::StackOverflow;
-  }
-  if (const CharT *matchStartLoc = res.getValue()) {
+  auto makeContext = [&]() {
+    return Context<Traits>(
+        bytecode,
+        matchFlags,
+        SyntaxFlags::fromByte(header->syntaxFlags),
+        first,
+        first + length,
+        markedCount,
+        loopCount,
+        guard);
+  };
+
+  // \return the result of searching with \p ctx, populating \p m on a match.
+  auto search = [&](Context<Traits> &ctx, bool linear) {
+    State<Traits> state{cursor, markedCount, loopCount};
+    const CharT *matchStartLoc;
+    if (linear) {
+      matchStartLoc = LinearExecutor<Traits>(ctx, *linearProgram)
+                          .match(&state, onlyAtStart);
+    } else {
+      auto res = ctx.match(&state, onlyAtStart);
+      if (!res) {
+        assert(res.getStatus() == ExecutionStatus::STACK_OVERFLOW);
+        return MatchRuntimeResult::StackOverflow;
+      }
+      matchStartLoc = res.getValue();
+    }
+    if (!matchStartLoc)
+      return MatchRuntimeResult::NoMatch;
     // Match succeeded. Return captured ranges. The first range is the total
     // match, followed by any capture groups.
     if (m != nullptr) {
@@ -1587,8 +2471,35 @@ MatchRuntimeResult searchWithBytecodeImpl(
           state.capturedRanges_.begin(), markedCount, std::back_inserter(*m));
     }
     return MatchRuntimeResult::Match;
+  };
+
+  if (matchFlags & constants::matchForceLinear) {
+    linearProgram.emplace(bytecode);
+    Context<Traits> ctx = makeContext();
+    return search(ctx, linearProgram->isSupported());
   }
-  return MatchRuntimeResult::NoMatch;
+
+  Context<Traits> ctx = makeContext();
+  if (matchFlags & constants::matchForceBacktracking)
+    return search(ctx, false);
+
+  // Backtrack for a while first: it is usually faster than the linear-time
+  // executor, which only pays off once backtracking goes exponential.
+  uint64_t budget = std::max<uint64_t>(
+      kLinearFallbackMinBacktracks,
+      uint64_t(bytecode.size()) * (uint64_t(length - start) + 1));
+  if (budget >= kBacktrackLimit)
+    return search(ctx, false);
+  ctx.backtracksRemaining_ = budget;
+  auto result = search(ctx, false);
+  if (result != MatchRuntimeResult::StackOverflow)
+    return result;
+
+  // Backtracking gave up. Finish with the linear-time executor if it can run
+  // the regex; otherwise start over with the full backtracking budget.
+  linearProgram.emplace(bytecode);
+  Context<Traits> retryCtx = makeContext();
+  return search(retryCtx, linearProgram->isSupported());
 }
 
 MatchRuntimeResult searchWithBytecode(
@@ -275,6 +275,47 @@ void dumpInstruction(const regex::Width1LoopInsn *insn, llvh::raw_ostream &OS) {
       aligner(insn->min),
       aligner(insn->max));
 }
+
+/// Dump the prefilter \p prefilter to \p OS, unless it accepts everything.
+void dumpPrefilter(
+    const regex::MatchPrefilter &prefilter,
+    llvh::raw_ostream &OS) {
+  if (prefilter.acceptsAll())
+    return;
+  auto output1Char = [&OS](uint32_t c) {
+    if (c <= 127 && std::isprint(c))
+      OS << char(c);
+    else
+      OS << llvh::format_hex(c, 4);
+  };
+  OS << "  Prefilter: first chars [";
+  for (uint32_t c = 0; c < 128; ++c) {
+    if (!prefilter.mayStartWith(c))
+      continue;
+    uint32_t last = c;
+    while (last + 1 < 128 && prefilter.mayStartWith(last + 1))
+      ++last;
+    output1Char(c);
+    if (last > c) {
+      OS << '-';
+      output1Char(last);
+    }
+    c = last;
+  }
+  if (prefilter.nonASCIIFirstChar) {
+    output1Char(0x80);
+    OS << '-';
+    output1Char(0xffff);
+  }
+  OS << ']';
+  if (prefilter.prefixLength) {
+    OS << " prefix '";
+    for (uint32_t i = 0; i < prefilter.prefixLength; i++)
+      output1Char(aligner(prefilter.prefix[i]));
+    OS << '\'';
+  }
+  OS << '\n';
+}
 } // namespace
 
 namespace hermes {
@@ -289,6 +330,7 @@ void dumpRegexBytecode(llvh::ArrayRef<uint8_t> bytes, llvh::raw_ostream &OS) {
       aligner(header->loopCount),
       aligner(header->syntaxFlags),
       header->constraints);
+  dumpPrefilter(header->prefilter, OS);
   bytes = bytes.slice(sizeof *header);
   uint32_t cursor = 0;
   while (cursor < bytes.size()) {
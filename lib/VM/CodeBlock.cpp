@@ -120,6 +120,21 @@ static void validateInstructions(ArrayRef<uint8_t> list, unsigned frameSize) {
 
 #endif
 
+uint32_t CodeBlock::computePropertyCacheSize(
+    const hbc::RuntimeFunctionHeader &header,
+    uint32_t &readCacheSize) {
+  // Compute size needed for caching from the highest accessed indices.
+  // If the highest access index is 0, that function does not use this cache at
+  // all so there is no reason to allocate it. If the function does access the
+  // cache we need to allocate an extra slot for the no-cache indicator.
+  auto sizeComputer = [](uint16_t highest) -> uint32_t {
+    return highest == 0 ? 0 : highest + 1;
+  };
+
+  readCacheSize = sizeComputer(header.highestReadCacheIndex());
+  return readCacheSize + sizeComputer(header.highestWriteCacheIndex());
+}
+
 CodeBlock *CodeBlock::createCodeBlock(
     RuntimeModule *runtimeModule,
     hbc::RuntimeFunctionHeader header,
@@ -130,23 +145,17 @@ CodeBlock *CodeBlock::createCodeBlock(
       {bytecode, header.bytecodeSizeInBytes()}, header.frameSize());
 #endif
 
-  // Compute size needed for caching from the highest accessed indices.
-  // If the highest access index is 0, that function does not use this cache at
-  // all so there is no reason to allocate it. If the function does access the
-  // cache we need to allocate an extra slot for the no-cache indicator.
-  auto sizeComputer = [](uint8_t highest) -> uint32_t {
-    return highest == 0 ? 0 : highest + 1;
-  };
-
-  uint32_t readCacheSize = sizeComputer(header.highestReadCacheIndex());
-  uint32_t cacheSize =
-      readCacheSize + sizeComputer(header.highestWriteCacheIndex());
+  uint32_t readCacheSize;
+  uint32_t cacheSize = computePropertyCacheSize(header, readCacheSize);
 
 #ifndef HERMESVM_LEAN
   bool isCodeBlockLazy = !bytecode;
   if (!runtimeModule->isInitialized() || isCodeBlockLazy) {
-    readCacheSize = sizeComputer(std::numeric_limits<uint8_t>::max());
-    cacheSize = 2 * readCacheSize;
+    assert(isCodeBlockLazy && "Uninitialized modules only have lazy blocks");
+    // The cache is allocated once the function has been compiled, see
+    // lazyCompileImpl().
+    readCacheSize = 0;
+    cacheSize = 0;
   }
 #endif
 
@@ -369,6 +378,14 @@ ExecutionStatus CodeBlock::lazyCompileImpl(Runtime &runtime) {
       runtimeModule_->getBytecode()->getFunctionHeader(functionID_);
   bytecode_ = runtimeModule_->getBytecode()->getBytecode(functionID_);
 
+  // Now that the cache indices used by the function are known, allocate the
+  // property cache.
+  assert(propertyCacheSize_ == 0 && "Lazy CodeBlock already has a cache");
+  propertyCacheSize_ =
+      computePropertyCacheSize(functionHeader_, writePropCacheOffset_);
+  lazyPropertyCache_.reset(new PropertyCacheEntry[propertyCacheSize_]);
+  propertyCache_ = lazyPropertyCache_.get();
+
   return ExecutionStatus::RETURNED;
 }
 #endif // HERMESVM_LEAN
@@ -382,6 +399,35 @@ void CodeBlock::markCachedHiddenClasses(
       acceptor.acceptWeak(prop.clazz);
     }
   }
+  for (auto &entry : polymorphicCaches_) {
+    entry.second->markWeakRoots(acceptor);
+  }
+}
+
+PolymorphicPropertyCacheEntry &CodeBlock::getPolymorphicCacheEntry(
+    const PropertyCacheEntry *entry) {
+  assert(
+      entry >= propertyCache() &&
+      entry < propertyCache() + propertyCacheSize_ &&
+      "entry is not in this CodeBlock's property cache");
+  auto &poly = polymorphicCaches_[entry - propertyCache()];
+  if (!poly)
+    poly = std::make_unique<PolymorphicPropertyCacheEntry>();
+  return *poly;
+}
+
+bool CodeBlock::insertCacheEntry(
+    PropertyCacheEntry *entry,
+    CompressedPointer clazz,
+    SlotIndex slot) {
+  // The interpreter checks the inline entry first, so keep the first class
+  // observed at the site there, or replace it if it has been collected.
+  if (!entry->clazz || entry->clazz == clazz) {
+    entry->clazz = clazz;
+    entry->slot = slot;
+    return true;
+  }
+  return getPolymorphicCacheEntry(entry).insert(clazz, slot);
 }
 
 uint32_t CodeBlock::getVirtualOffset() const {
@@ -53,6 +53,12 @@ HERMES_SLOW_STATISTIC(
 HERMES_SLOW_STATISTIC(
     NumGetByIdCacheHits,
     "NumGetByIdCacheHits: Number of property 'read by id' cache hits");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdPolyHits,
+    "NumGetByIdPolyHits: Number of property 'read by id' polymorphic cache hits");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdMegaHits,
+    "NumGetByIdMegaHits: Number of property 'read by id' megamorphic cache hits");
 HERMES_SLOW_STATISTIC(
     NumGetByIdProtoHits,
     "NumGetByIdProtoHits: Number of property 'read by id' cache hits for the prototype");
@@ -87,6 +93,12 @@ HERMES_SLOW_STATISTIC(
 HERMES_SLOW_STATISTIC(
     NumPutByIdCacheHits,
     "NumPutByIdCacheHits: Number of property 'write by id' cache hits");
+HERMES_SLOW_STATISTIC(
+    NumPutByIdPolyHits,
+    "NumPutByIdPolyHits: Number of property 'write by id' polymorphic cache hits");
+HERMES_SLOW_STATISTIC(
+    NumPutByIdMegaHits,
+    "NumPutByIdMegaHits: Number of property 'write by id' megamorphic cache hits");
 HERMES_SLOW_STATISTIC(
     NumPutByIdCacheEvicts,
     "NumPutByIdCacheEvicts: Number of property 'write by id' cache evictions");
@@ -97,6 +109,25 @@ HERMES_SLOW_STATISTIC(
     NumPutByIdTransient,
     "NumPutByIdTransient: Number of property 'write by id' to non-objects");
 
+HERMES_SLOW_STATISTIC(
+    NumGetByVal,
+    "NumGetByVal: Number of property 'read by value' accesses");
+HERMES_SLOW_STATISTIC(
+    NumGetByValIndexedHits,
+    "NumGetByValIndexedHits: Number of property 'read by value' indexed fast paths");
+HERMES_SLOW_STATISTIC(
+    NumGetByValCacheHits,
+    "NumGetByValCacheHits: Number of property 'read by value' cache hits");
+HERMES_SLOW_STATISTIC(
+    NumPutByVal,
+    "NumPutByVal: Number of property 'write by value' accesses");
+HERMES_SLOW_STATISTIC(
+    NumPutByValIndexedHits,
+    "NumPutByValIndexedHits: Number of property 'write by value' indexed fast paths");
+HERMES_SLOW_STATISTIC(
+    NumPutByValCacheHits,
+    "NumPutByValCacheHits: Number of property 'write by value' cache hits");
+
 HERMES_SLOW_STATISTIC(
     NumNativeFunctionCalls,
     "NumNativeFunctionCalls: Number of native function calls");
@@ -717,6 +748,19 @@ static void printDebugInfo(
 
 #endif
 
+/// \return the SymbolID to look up in the property cache of a GetByVal or
+/// PutByVal instruction for the key \p key, if it can be obtained without
+/// allocating: that is, if the key is a symbol or an already uniqued string.
+/// Otherwise \return an invalid SymbolID.
+static inline SymbolID getCacheableKey(HermesValue key) {
+  if (key.isString()) {
+    return key.getString()->getUniqueIDIfUniqued();
+  } else if (key.isSymbol()) {
+    return key.getSymbol();
+  }
+  return SymbolID::empty();
+}
+
 /// \return the address of the next instruction after \p ip, which must be a
 /// call-type instruction.
 LLVM_ATTRIBUTE_ALWAYS_INLINE
@@ -1141,6 +1185,7 @@ tailCall:
     {
       const Inst *nextIP;
       uint32_t idVal;
+      uint16_t cacheIdxVal;
       bool tryProp;
       uint32_t callArgCount;
       // This is HermesValue::getRaw(), since HermesValue cannot be assigned
@@ -2188,40 +2233,46 @@ tailCall:
       CASE(TryGetByIdLong) {
         tryProp = true;
         idVal = ip->iTryGetByIdLong.op4;
+        cacheIdxVal = ip->iTryGetByIdLong.op3;
         nextIP = NEXTINST(TryGetByIdLong);
         goto getById;
       }
       CASE(GetByIdLong) {
         tryProp = false;
         idVal = ip->iGetByIdLong.op4;
+        cacheIdxVal = ip->iGetByIdLong.op3;
         nextIP = NEXTINST(GetByIdLong);
         goto getById;
       }
       CASE(GetByIdShort) {
         tryProp = false;
         idVal = ip->iGetByIdShort.op4;
+        cacheIdxVal = ip->iGetByIdShort.op3;
         nextIP = NEXTINST(GetByIdShort);
         goto getById;
       }
       CASE(TryGetById) {
         tryProp = true;
         idVal = ip->iTryGetById.op4;
+        cacheIdxVal = ip->iTryGetById.op3;
         nextIP = NEXTINST(TryGetById);
         goto getById;
       }
       CASE(GetById) {
         tryProp = false;
         idVal = ip->iGetById.op4;
+        cacheIdxVal = ip->iGetById.op3;
         nextIP = NEXTINST(GetById);
       }
     getById: {
       ++NumGetById;
       // NOTE: it is safe to use OnREG(GetById) here because all instructions
       // have the same layout: opcode, registers, non-register operands, i.e.
-      // they only differ in the width of the last "identifier" field.
+      // they only differ in the width of the cache index and "identifier"
+      // fields, which are decoded by each case above.
       if (LLVM_LIKELY(O2REG(GetById).isObject())) {
         auto *obj = vmcast<JSObject>(O2REG(GetById));
-        auto cacheIdx = ip->iGetById.op3;
+        auto cacheIdx = cacheIdxVal;
         auto *cacheEntry = curCodeBlock->getReadCacheEntry(cacheIdx);
 
 #ifdef HERMESVM_PROFILER_BB
@@ -2230,10 +2281,8 @@ tailCall:
               gcScope.getHandleCountDbg() == KEEP_HANDLES &&
               "unaccounted handles were created");
           auto objHandle = runtime.makeHandle(obj);
-          auto cacheHCPtr = vmcast_or_null<HiddenClass>(static_cast<GCCell *>(
-              cacheEntry->clazz.get(runtime, runtime.getHeap())));
           CAPTURE_IP(runtime.recordHiddenClass(
-              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheHCPtr));
+              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheEntry));
           // obj may be moved by GC due to recordHiddenClass
           obj = objHandle.get();
         }
@@ -2259,7 +2308,32 @@ tailCall:
           ip = nextIP;
           DISPATCH;
         }
+        auto *polyCache = curCodeBlock->findPolymorphicCacheEntry(cacheEntry);
+        if (const auto *polyEntry =
+                polyCache ? polyCache->find(clazzPtr) : nullptr) {
+          ++NumGetByIdPolyHits;
+          CAPTURE_IP(
+              O1REG(GetById) =
+                  JSObject::getNamedSlotValueUnsafe<PropStorage::Inline::Yes>(
+                      obj, runtime, polyEntry->slot)
+                      .unboxToHV(runtime));
+          ip = nextIP;
+          DISPATCH;
+        }
         auto id = ID(idVal);
+        if (LLVM_UNLIKELY(polyCache && polyCache->megamorphic)) {
+          if (const auto *megaEntry =
+                  runtime.megamorphicReadPropCache_.find(clazzPtr, id)) {
+            ++NumGetByIdMegaHits;
+            CAPTURE_IP(
+                O1REG(GetById) =
+                    JSObject::getNamedSlotValueUnsafe<PropStorage::Inline::Yes>(
+                        obj, runtime, megaEntry->slot)
+                        .unboxToHV(runtime));
+            ip = nextIP;
+            DISPATCH;
+          }
+        }
         NamedPropertyDescriptor desc;
         CAPTURE_IP_ASSIGN(
             OptValue<bool> fastPathResult,
@@ -2275,15 +2349,14 @@ tailCall:
               vmcast<HiddenClass>(clazzPtr.getNonNull(runtime));
           if (LLVM_LIKELY(!clazz->isDictionaryNoCache()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
-#ifdef HERMES_SLOW_DEBUG
-            if (cacheEntry->clazz && cacheEntry->clazz != clazzPtr)
+            // Cache the class, id and property slot, falling back to the
+            // runtime-wide cache once the site has gone megamorphic.
+            if (LLVM_UNLIKELY(!curCodeBlock->insertCacheEntry(
+                    cacheEntry, clazzPtr, desc.slot))) {
               ++NumGetByIdCacheEvicts;
-#else
-            (void)NumGetByIdCacheEvicts;
-#endif
-            // Cache the class, id and property slot.
-            cacheEntry->clazz = clazzPtr;
-            cacheEntry->slot = desc.slot;
+              runtime.megamorphicReadPropCache_.insert(
+                  clazzPtr, id, desc.slot);
+            }
           }
 
           assert(
@@ -2307,13 +2380,23 @@ tailCall:
           // having no properties and therefore cannot contain the property.
           // This check does not belong here, it should be merged into
           // tryGetOwnNamedDescriptorFast().
-          if (parent && cacheEntry->clazz == parent->getClassGCPtr() &&
-              LLVM_LIKELY(!obj->isLazy())) {
+          OptValue<SlotIndex> protoSlot{};
+          if (parent) {
+            CompressedPointer parentClazz{parent->getClassGCPtr()};
+            if (cacheEntry->clazz == parentClazz) {
+              protoSlot = cacheEntry->slot;
+            } else if (
+                const auto *polyEntry =
+                    polyCache ? polyCache->find(parentClazz) : nullptr) {
+              protoSlot = polyEntry->slot;
+            }
+          }
+          if (protoSlot && LLVM_LIKELY(!obj->isLazy())) {
             ++NumGetByIdProtoHits;
             // We've already checked that this isn't a Proxy.
             CAPTURE_IP(
                 O1REG(GetById) = JSObject::getNamedSlotValueUnsafe(
-                                     parent, runtime, cacheEntry->slot)
+                                     parent, runtime, *protoSlot)
                                      .unboxToHV(runtime));
             ip = nextIP;
             DISPATCH;
@@ -2339,31 +2422,33 @@ tailCall:
         (void)NumGetByIdAccessor;
         (void)NumGetByIdProto;
         (void)NumGetByIdNotFound;
-#endif
-#ifdef HERMES_SLOW_DEBUG
-        auto *savedClass = cacheIdx != hbc::PROPERTY_CACHING_DISABLED
-            ? cacheEntry->clazz.get(runtime, runtime.getHeap())
-            : nullptr;
 #endif
         ++NumGetByIdSlow;
-        CAPTURE_IP(
-            resPH = JSObject::getNamed_RJS(
-                Handle<JSObject>::vmcast(&O2REG(GetById)),
-                runtime,
-                id,
-                !tryProp ? defaultPropOpFlags
-                         : defaultPropOpFlags.plusMustExist(),
-                cacheIdx != hbc::PROPERTY_CACHING_DISABLED ? cacheEntry
-                                                           : nullptr));
-        if (LLVM_UNLIKELY(resPH == ExecutionStatus::EXCEPTION)) {
-          goto exception;
-        }
-#ifdef HERMES_SLOW_DEBUG
-        if (cacheIdx != hbc::PROPERTY_CACHING_DISABLED && savedClass &&
-            cacheEntry->clazz.get(runtime, runtime.getHeap()) != savedClass) {
-          ++NumGetByIdCacheEvicts;
+        {
+          // The slow path reports the class and slot of the object the
+          // property was found in, which may be a prototype. Collect it in a
+          // scratch entry and add it to the polymorphic cache afterwards.
+          PropertyCacheEntry slowEntry;
+          CAPTURE_IP(
+              resPH = JSObject::getNamed_RJS(
+                  Handle<JSObject>::vmcast(&O2REG(GetById)),
+                  runtime,
+                  id,
+                  !tryProp ? defaultPropOpFlags
+                           : defaultPropOpFlags.plusMustExist(),
+                  cacheIdx != hbc::PROPERTY_CACHING_DISABLED ? &slowEntry
+                                                             : nullptr));
+          if (LLVM_UNLIKELY(resPH == ExecutionStatus::EXCEPTION)) {
+            goto exception;
+          }
+          if (slowEntry.clazz &&
+              !curCodeBlock->insertCacheEntry(
+                  cacheEntry,
+                  slowEntry.clazz.getNoBarrierUnsafe(),
+                  slowEntry.slot)) {
+            ++NumGetByIdCacheEvicts;
+          }
         }
-#endif
       } else {
         ++NumGetByIdTransient;
         assert(!tryProp && "TryGetById can only be used on the global object");
@@ -2384,24 +2469,28 @@ tailCall:
       CASE(TryPutByIdLong) {
         tryProp = true;
         idVal = ip->iTryPutByIdLong.op4;
+        cacheIdxVal = ip->iTryPutByIdLong.op3;
         nextIP = NEXTINST(TryPutByIdLong);
         goto putById;
       }
       CASE(PutByIdLong) {
         tryProp = false;
         idVal = ip->iPutByIdLong.op4;
+        cacheIdxVal = ip->iPutByIdLong.op3;
         nextIP = NEXTINST(PutByIdLong);
         goto putById;
       }
       CASE(TryPutById) {
         tryProp = true;
         idVal = ip->iTryPutById.op4;
+        cacheIdxVal = ip->iTryPutById.op3;
         nextIP = NEXTINST(TryPutById);
         goto putById;
       }
       CASE(PutById) {
         tryProp = false;
         idVal = ip->iPutById.op4;
+        cacheIdxVal = ip->iPutById.op3;
         nextIP = NEXTINST(PutById);
       }
     putById: {
@@ -2411,7 +2500,7 @@ tailCall:
             SmallHermesValue shv,
             SmallHermesValue::encodeHermesValue(O2REG(PutById), runtime));
         auto *obj = vmcast<JSObject>(O1REG(PutById));
-        auto cacheIdx = ip->iPutById.op3;
+        auto cacheIdx = cacheIdxVal;
         auto *cacheEntry = curCodeBlock->getWriteCacheEntry(cacheIdx);
 
 #ifdef HERMESVM_PROFILER_BB
@@ -2421,10 +2510,8 @@ tailCall:
               "unaccounted handles were created");
           auto shvHandle = runtime.makeHandle(shv.toHV(runtime));
           auto objHandle = runtime.makeHandle(obj);
-          auto cacheHCPtr = vmcast_or_null<HiddenClass>(static_cast<GCCell *>(
-              cacheEntry->clazz.get(runtime, runtime.getHeap())));
           CAPTURE_IP(runtime.recordHiddenClass(
-              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheHCPtr));
+              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheEntry));
           // shv/obj may be invalidated by recordHiddenClass
           if (shv.isPointer())
             shv.unsafeUpdatePointer(
@@ -2444,7 +2531,28 @@ tailCall:
           ip = nextIP;
           DISPATCH;
         }
+        auto *polyCache = curCodeBlock->findPolymorphicCacheEntry(cacheEntry);
+        if (const auto *polyEntry =
+                polyCache ? polyCache->find(clazzPtr) : nullptr) {
+          ++NumPutByIdPolyHits;
+          CAPTURE_IP(
+              JSObject::setNamedSlotValueUnsafe<PropStorage::Inline::Yes>(
+                  obj, runtime, polyEntry->slot, shv));
+          ip = nextIP;
+          DISPATCH;
+        }
         auto id = ID(idVal);
+        if (LLVM_UNLIKELY(polyCache && polyCache->megamorphic)) {
+          if (const auto *megaEntry =
+                  runtime.megamorphicWritePropCache_.find(clazzPtr, id)) {
+            ++NumPutByIdMegaHits;
+            CAPTURE_IP(
+                JSObject::setNamedSlotValueUnsafe<PropStorage::Inline::Yes>(
+                    obj, runtime, megaEntry->slot, shv));
+            ip = nextIP;
+            DISPATCH;
+          }
+        }
         NamedPropertyDescriptor desc;
         CAPTURE_IP_ASSIGN(
             OptValue<bool> hasOwnProp,
@@ -2460,15 +2568,14 @@ tailCall:
               vmcast<HiddenClass>(clazzPtr.getNonNull(runtime));
           if (LLVM_LIKELY(!clazz->isDictionary()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
-#ifdef HERMES_SLOW_DEBUG
-            if (cacheEntry->clazz && cacheEntry->clazz != clazzPtr)
+            // Cache the class and property slot, falling back to the
+            // runtime-wide cache once the site has gone megamorphic.
+            if (LLVM_UNLIKELY(!curCodeBlock->insertCacheEntry(
+                    cacheEntry, clazzPtr, desc.slot))) {
               ++NumPutByIdCacheEvicts;
-#else
-            (void)NumPutByIdCacheEvicts;
-#endif
-            // Cache the class and property slot.
-            cacheEntry->clazz = clazzPtr;
-            cacheEntry->slot = desc.slot;
+              runtime.megamorphicWritePropCache_.insert(
+                  clazzPtr, id, desc.slot);
+            }
           }
 
           // This must be valid because an own property was already found.
@@ -2511,7 +2618,94 @@ tailCall:
     }
 
       CASE(GetByVal) {
+        ++NumGetByVal;
         if (LLVM_LIKELY(O2REG(GetByVal).isObject())) {
+          auto *obj = vmcast<JSObject>(O2REG(GetByVal));
+          // Fast path for integer keys on objects whose indexed properties
+          // live in indexed storage, e.g. arrays and typed arrays.
+          if (obj->hasFastIndexProperties()) {
+            if (auto arrayIndex = toArrayIndexFastPath(O3REG(GetByVal))) {
+              if (auto *arr = dyn_vmcast<JSArray>(obj)) {
+                SmallHermesValue elem = arr->at(runtime, *arrayIndex);
+                if (LLVM_LIKELY(!elem.isEmpty())) {
+                  ++NumGetByValIndexedHits;
+                  O1REG(GetByVal) = elem.unboxToHV(runtime);
+                  ip = NEXTINST(GetByVal);
+                  DISPATCH;
+                }
+              } else {
+                CAPTURE_IP_ASSIGN(
+                    HermesValue elem,
+                    JSObject::getOwnIndexed(
+                        createPseudoHandle(obj), runtime, *arrayIndex));
+                if (LLVM_LIKELY(!elem.isEmpty())) {
+                  ++NumGetByValIndexedHits;
+                  O1REG(GetByVal) = elem;
+                  ip = NEXTINST(GetByVal);
+                  DISPATCH;
+                }
+              }
+            }
+          }
+          // Keyed cache for string and symbol keys that are already uniqued.
+          auto cacheIdx = ip->iGetByVal.op4;
+          SymbolID key = getCacheableKey(O3REG(GetByVal));
+          if (cacheIdx != hbc::PROPERTY_CACHING_DISABLED && key.isValid()) {
+            // Keyed entries record the name, so they are all kept out of
+            // line.
+            auto *cacheEntry = curCodeBlock->getReadCacheEntry(cacheIdx);
+            auto *keyedCache =
+                curCodeBlock->findPolymorphicCacheEntry(cacheEntry);
+            CompressedPointer clazzPtr{obj->getClassGCPtr()};
+            if (const auto *hitEntry =
+                    keyedCache ? keyedCache->find(clazzPtr, key) : nullptr) {
+              ++NumGetByValCacheHits;
+              CAPTURE_IP(
+                  O1REG(GetByVal) =
+                      JSObject::getNamedSlotValueUnsafe<
+                          PropStorage::Inline::Yes>(
+                          obj, runtime, hitEntry->slot)
+                          .unboxToHV(runtime));
+              ip = NEXTINST(GetByVal);
+              DISPATCH;
+            }
+            if (LLVM_UNLIKELY(keyedCache && keyedCache->megamorphic)) {
+              if (const auto *megaEntry =
+                      runtime.megamorphicReadPropCache_.find(clazzPtr, key)) {
+                ++NumGetByValCacheHits;
+                CAPTURE_IP(
+                    O1REG(GetByVal) =
+                        JSObject::getNamedSlotValueUnsafe<
+                            PropStorage::Inline::Yes>(
+                            obj, runtime, megaEntry->slot)
+                            .unboxToHV(runtime));
+                ip = NEXTINST(GetByVal);
+                DISPATCH;
+              }
+            }
+            NamedPropertyDescriptor desc;
+            CAPTURE_IP_ASSIGN(
+                OptValue<bool> fastPathResult,
+                JSObject::tryGetOwnNamedDescriptorFast(
+                    obj, runtime, key, desc));
+            if (fastPathResult.hasValue() && fastPathResult.getValue() &&
+                !desc.flags.accessor) {
+              HiddenClass *clazz =
+                  vmcast<HiddenClass>(clazzPtr.getNonNull(runtime));
+              if (LLVM_LIKELY(!clazz->isDictionaryNoCache()) &&
+                  !curCodeBlock->getPolymorphicCacheEntry(cacheEntry)
+                       .insert(clazzPtr, desc.slot, key)) {
+                runtime.megamorphicReadPropCache_.insert(
+                    clazzPtr, key, desc.slot);
+              }
+              CAPTURE_IP(
+                  O1REG(GetByVal) =
+                      JSObject::getNamedSlotValueUnsafe(obj, runtime, desc)
+                          .unboxToHV(runtime));
+              ip = NEXTINST(GetByVal);
+              DISPATCH;
+            }
+          }
           CAPTURE_IP(
               resPH = JSObject::getComputed_RJS(
                   Handle<JSObject>::vmcast(&O2REG(GetByVal)),
@@ -2538,7 +2732,86 @@ tailCall:
       }
 
       CASE(PutByVal) {
+        ++NumPutByVal;
         if (LLVM_LIKELY(O1REG(PutByVal).isObject())) {
+          // Fast path for overwriting an existing element of an extensible
+          // array.
+          if (vmisa<JSArray>(O1REG(PutByVal))) {
+            auto *arr = vmcast<JSArray>(O1REG(PutByVal));
+            auto arrayIndex = toArrayIndexFastPath(O2REG(PutByVal));
+            if (arrayIndex && arr->hasFastIndexProperties() &&
+                arr->isExtensible() &&
+                !arr->at(runtime, *arrayIndex).isEmpty()) {
+              ++NumPutByValIndexedHits;
+              CAPTURE_IP_ASSIGN(
+                  SmallHermesValue shv,
+                  SmallHermesValue::encodeHermesValue(
+                      O3REG(PutByVal), runtime));
+              // The array may have been moved by the allocation above.
+              JSArray::unsafeSetExistingElementAt(
+                  vmcast<JSArray>(O1REG(PutByVal)), runtime, *arrayIndex, shv);
+              ip = NEXTINST(PutByVal);
+              DISPATCH;
+            }
+          }
+          // Keyed cache for string and symbol keys that are already uniqued.
+          auto cacheIdx = ip->iPutByVal.op4;
+          SymbolID key = getCacheableKey(O2REG(PutByVal));
+          if (cacheIdx != hbc::PROPERTY_CACHING_DISABLED && key.isValid()) {
+            // Keyed entries record the name, so they are all kept out of
+            // line.
+            auto *cacheEntry = curCodeBlock->getWriteCacheEntry(cacheIdx);
+            auto *keyedCache =
+                curCodeBlock->findPolymorphicCacheEntry(cacheEntry);
+            CAPTURE_IP_ASSIGN(
+                SmallHermesValue shv,
+                SmallHermesValue::encodeHermesValue(O3REG(PutByVal), runtime));
+            auto *obj = vmcast<JSObject>(O1REG(PutByVal));
+            CompressedPointer clazzPtr{obj->getClassGCPtr()};
+            if (const auto *hitEntry =
+                    keyedCache ? keyedCache->find(clazzPtr, key) : nullptr) {
+              ++NumPutByValCacheHits;
+              CAPTURE_IP(
+                  JSObject::setNamedSlotValueUnsafe<PropStorage::Inline::Yes>(
+                      obj, runtime, hitEntry->slot, shv));
+              ip = NEXTINST(PutByVal);
+              DISPATCH;
+            }
+            if (LLVM_UNLIKELY(keyedCache && keyedCache->megamorphic)) {
+              if (const auto *megaEntry =
+                      runtime.megamorphicWritePropCache_.find(clazzPtr, key)) {
+                ++NumPutByValCacheHits;
+                CAPTURE_IP(
+                    JSObject::setNamedSlotValueUnsafe<
+                        PropStorage::Inline::Yes>(
+                        obj, runtime, megaEntry->slot, shv));
+                ip = NEXTINST(PutByVal);
+                DISPATCH;
+              }
+            }
+            NamedPropertyDescriptor desc;
+            CAPTURE_IP_ASSIGN(
+                OptValue<bool> hasOwnProp,
+                JSObject::tryGetOwnNamedDescriptorFast(
+                    obj, runtime, key, desc));
+            if (hasOwnProp.hasValue() && hasOwnProp.getValue() &&
+                !desc.flags.accessor && desc.flags.writable &&
+                !desc.flags.internalSetter) {
+              HiddenClass *clazz =
+                  vmcast<HiddenClass>(clazzPtr.getNonNull(runtime));
+              if (LLVM_LIKELY(!clazz->isDictionary()) &&
+                  !curCodeBlock->getPolymorphicCacheEntry(cacheEntry)
+                       .insert(clazzPtr, desc.slot, key)) {
+                runtime.megamorphicWritePropCache_.insert(
+                    clazzPtr, key, desc.slot);
+              }
+              // This must be valid because an own property was already found.
+              CAPTURE_IP(JSObject::setNamedSlotValueUnsafe(
+                  obj, runtime, desc.slot, shv));
+              ip = NEXTINST(PutByVal);
+              DISPATCH;
+            }
+          }
           CAPTURE_IP_ASSIGN(
               auto putRes,
               JSObject::putComputed_RJS(
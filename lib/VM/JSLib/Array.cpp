@@ -13,6 +13,7 @@
 #include "JSLibInternal.h"
 
 #include "hermes/ADT/SafeInt.h"
+#include "hermes/Support/Conversions.h"
 #include "hermes/VM/HandleRootOwner-inline.h"
 #include "hermes/VM/JSLib/Sorting.h"
 #include "hermes/VM/Operations.h"
@@ -1042,18 +1043,17 @@ arrayPrototypePush(void *, Runtime &runtime, NativeArgs args) {
 }
 
 namespace {
-/// General object sorting model used by custom sorting routines.
-/// Provides a model by which to less and swap elements, using the [[Get]],
-/// [[Put]], and [[Delete]] internal methods of a supplied Object. Should be
-/// allocated on the stack, because it creates its own internal GCScope, with
-/// reusable MutableHandle<>-s that are used in the less and swap methods.
-/// These allow for quick accesses without allocating a great number of new
-/// handles every time we want to compare different elements.
+/// Sorting model for the list of values collected from the object being
+/// sorted, which is stored in a JSArray that is never exposed to JavaScript.
+/// Elements are read and swapped directly in its storage, and only the
+/// comparison can run JavaScript: either the user supplied compareFn, or the
+/// string conversions of the default comparison. Should be allocated on the
+/// stack, because it creates its own internal GCScope with reusable
+/// MutableHandle<>-s for the values being compared.
 /// Usage example:
-///   StandardSortModel sm{runtime, obj, compareFn};
-///   quickSort(sm, 0, length);
-/// Note that this is generic and does nothing different if passed a JSArray.
-class StandardSortModel : public SortModel {
+///   SortListModel sm{runtime, list, compareFn};
+///   timSort(&sm, 0, length);
+class SortListModel : public SortModel {
  private:
   /// Runtime to sort in.
   Runtime &runtime_;
@@ -1065,235 +1065,76 @@ class StandardSortModel : public SortModel {
   /// If null, then use the built in < operator.
   Handle<Callable> compareFn_;
 
-  /// Object to sort elements [0, length).
-  Handle<JSObject> obj_;
+  /// The values to sort, none of which is empty.
+  Handle<JSArray> list_;
 
-  /// Temporary handles for property name.
-  MutableHandle<SymbolID> aTmpNameStorage_;
-  MutableHandle<SymbolID> bTmpNameStorage_;
-
-  /// Preallocate handles in the current GCScope so that we don't have to make
-  /// new handles in every method call.
-
-  /// Handles for two indices.
-  MutableHandle<> aHandle_;
-  MutableHandle<> bHandle_;
-
-  /// Handles for the values at two indices.
+  /// Handles for the values being compared.
   MutableHandle<> aValue_;
   MutableHandle<> bValue_;
 
-  /// Handles for the objects the values are retrieved from.
-  MutableHandle<JSObject> aDescObjHandle_;
-  MutableHandle<JSObject> bDescObjHandle_;
-
   /// Marker created after initializing all fields so handles allocated later
   /// can be flushed.
   GCScope::Marker gcMarker_;
 
  public:
-  StandardSortModel(
+  SortListModel(
       Runtime &runtime,
-      Handle<JSObject> obj,
+      Handle<JSArray> list,
       Handle<Callable> compareFn)
       : runtime_(runtime),
         gcScope_(runtime),
         compareFn_(compareFn),
-        obj_(obj),
-        aTmpNameStorage_(runtime),
-        bTmpNameStorage_(runtime),
-        aHandle_(runtime),
-        bHandle_(runtime),
+        list_(list),
         aValue_(runtime),
         bValue_(runtime),
-        aDescObjHandle_(runtime),
-        bDescObjHandle_(runtime),
         gcMarker_(gcScope_.createMarker()) {}
 
-  /// Use getComputed and putComputed to swap the values at obj[a] and obj[b].
+  /// Swap list[a] and list[b] in the storage.
   ExecutionStatus swap(uint32_t a, uint32_t b) override {
-    // Ensure that we don't leave here with any new handles.
-    GCScopeMarkerRAII gcMarker{gcScope_, gcMarker_};
-
-    aHandle_ = HermesValue::encodeTrustedNumberValue(a);
-    bHandle_ = HermesValue::encodeTrustedNumberValue(b);
-
-    ComputedPropertyDescriptor aDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, aHandle_, aDescObjHandle_, aTmpNameStorage_, aDesc);
-
-    if (aDescObjHandle_) {
-      if (LLVM_LIKELY(!aDesc.flags.proxyObject)) {
-        auto res = JSObject::getComputedPropertyValue_RJS(
-            obj_,
-            runtime_,
-            aDescObjHandle_,
-            aTmpNameStorage_,
-            aDesc,
-            aDescObjHandle_);
-        if (res == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        if (LLVM_LIKELY(!(*res)->isEmpty())) {
-          aValue_ = std::move(*res);
-        }
-      } else {
-        auto keyRes = toPropertyKey(runtime_, aHandle_);
-        if (keyRes == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        aHandle_ = keyRes->get();
-        CallResult<bool> hasPropRes = JSProxy::getOwnProperty(
-            aDescObjHandle_, runtime_, aHandle_, aDesc, nullptr);
-        if (hasPropRes == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        if (*hasPropRes) {
-          auto res =
-              JSProxy::getComputed(aDescObjHandle_, runtime_, aHandle_, obj_);
-          if (res == ExecutionStatus::EXCEPTION) {
-            return ExecutionStatus::EXCEPTION;
-          }
-          aValue_ = std::move(*res);
-        } else {
-          aDescObjHandle_ = nullptr;
-        }
-      }
-    }
-
-    ComputedPropertyDescriptor bDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, bHandle_, bDescObjHandle_, bTmpNameStorage_, bDesc);
-
-    if (bDescObjHandle_) {
-      if (LLVM_LIKELY(!bDesc.flags.proxyObject)) {
-        auto res = JSObject::getComputedPropertyValue_RJS(
-            obj_,
-            runtime_,
-            bDescObjHandle_,
-            bTmpNameStorage_,
-            bDesc,
-            bDescObjHandle_);
-        if (res == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        if (LLVM_LIKELY(!(*res)->isEmpty())) {
-          bValue_ = std::move(*res);
-        }
-      } else {
-        auto keyRes = toPropertyKey(runtime_, bHandle_);
-        if (keyRes == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        bHandle_ = keyRes->get();
-        CallResult<bool> hasPropRes = JSProxy::getOwnProperty(
-            bDescObjHandle_, runtime_, bHandle_, bDesc, nullptr);
-        if (hasPropRes == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        if (*hasPropRes) {
-          auto res =
-              JSProxy::getComputed(bDescObjHandle_, runtime_, bHandle_, obj_);
-          if (res == ExecutionStatus::EXCEPTION) {
-            return ExecutionStatus::EXCEPTION;
-          }
-          bValue_ = std::move(*res);
-        } else {
-          bDescObjHandle_ = nullptr;
-        }
-      }
-    }
-
-    if (bDescObjHandle_) {
-      if (LLVM_UNLIKELY(
-              JSObject::putComputed_RJS(
-                  obj_,
-                  runtime_,
-                  aHandle_,
-                  bValue_,
-                  PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      if (LLVM_UNLIKELY(
-              JSObject::deleteComputed(
-                  obj_, runtime_, aHandle_, PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    }
+    SmallHermesValue aValue = list_->at(runtime_, a);
+    JSArray::unsafeSetExistingElementAt(
+        *list_, runtime_, a, list_->at(runtime_, b));
+    JSArray::unsafeSetExistingElementAt(*list_, runtime_, b, aValue);
+    return ExecutionStatus::RETURNED;
+  }
 
-    if (aDescObjHandle_) {
-      if (LLVM_UNLIKELY(
-              JSObject::putComputed_RJS(
-                  obj_,
-                  runtime_,
-                  bHandle_,
-                  aValue_,
-                  PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      if (LLVM_UNLIKELY(
-              JSObject::deleteComputed(
-                  obj_, runtime_, bHandle_, PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
+  /// Extend the list storage by \p count slots past the values being sorted.
+  /// If the storage can't grow that much, merges are done with swaps instead.
+  CallResult<OptValue<uint32_t>> reserveTemp(uint32_t count) override {
+    uint32_t base = list_->getEndIndex();
+    if (count > JSArray::StorageType::maxElements() - base)
+      return OptValue<uint32_t>{llvh::None};
+    if (LLVM_UNLIKELY(
+            JSArray::setStorageEndIndex(list_, runtime_, base + count) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
+    return OptValue<uint32_t>{base};
+  }
 
+  /// Copy list[from] to list[to] in the storage.
+  ExecutionStatus copy(uint32_t from, uint32_t to) override {
+    JSArray::unsafeSetExistingElementAt(
+        *list_, runtime_, to, list_->at(runtime_, from));
     return ExecutionStatus::RETURNED;
   }
 
-  /// If compareFn isn't null, return compareFn(obj[a], obj[b])
-  /// If compareFn is null, return -1 if obj[a] < obj[b], 1 if obj[a] > obj[b],
-  /// 0 otherwise
+  /// If compareFn isn't null, return compareFn(list[a], list[b])
+  /// If compareFn is null, return -1 if list[a] < list[b], 1 if
+  /// list[a] > list[b], 0 otherwise
   CallResult<int> compare(uint32_t a, uint32_t b) override {
     // Ensure that we don't leave here with any new handles.
     GCScopeMarkerRAII gcMarker{gcScope_, gcMarker_};
 
-    aHandle_ = HermesValue::encodeTrustedNumberValue(a);
-    bHandle_ = HermesValue::encodeTrustedNumberValue(b);
-
-    ComputedPropertyDescriptor aDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, aHandle_, aDescObjHandle_, aTmpNameStorage_, aDesc);
-    CallResult<PseudoHandle<>> propRes = JSObject::getComputedPropertyValue_RJS(
-        obj_, runtime_, aDescObjHandle_, aTmpNameStorage_, aDesc, aHandle_);
-    if (propRes == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-    if ((*propRes)->isEmpty()) {
-      // Spec defines empty as greater than everything.
-      return 1;
-    }
-    aValue_ = std::move(*propRes);
-    assert(!aValue_->isEmpty());
-
-    ComputedPropertyDescriptor bDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, bHandle_, bDescObjHandle_, bTmpNameStorage_, bDesc);
-    if ((propRes = JSObject::getComputedPropertyValue_RJS(
-             obj_,
-             runtime_,
-             bDescObjHandle_,
-             bTmpNameStorage_,
-             bDesc,
-             bHandle_)) == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-    if ((*propRes)->isEmpty()) {
-      // Spec defines empty as greater than everything.
-      return -1;
-    }
-    bValue_ = std::move(*propRes);
-    assert(!bValue_->isEmpty());
+    aValue_ = list_->at(runtime_, a).unboxToHV(runtime_);
+    bValue_ = list_->at(runtime_, b).unboxToHV(runtime_);
+    assert(
+        !aValue_->isEmpty() && !bValue_->isEmpty() &&
+        "holes are not collected for sorting");
 
     if (aValue_->isUndefined()) {
       // Spec defines undefined as greater than everything.
-      return 1;
+      return bValue_->isUndefined() ? 0 : 1;
     }
     if (bValue_->isUndefined()) {
       // Spec defines undefined as greater than everything.
@@ -1423,9 +1264,9 @@ CallResult<HermesValue> sortSparse(
   gcMarker.flush();
 
   {
-    StandardSortModel sm(runtime, array, compareFn);
+    SortListModel sm(runtime, array, compareFn);
     if (LLVM_UNLIKELY(
-            quickSort(&sm, 0u, numProps) == ExecutionStatus::EXCEPTION))
+            timSort(&sm, 0u, numProps) == ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
   }
 
@@ -1450,6 +1291,186 @@ CallResult<HermesValue> sortSparse(
 
   return O.getHermesValue();
 }
+
+/// Sort the first \p len elements of \p arr with the default comparator, if
+/// they are all numbers or all strings. Converting such values to strings and
+/// comparing them can't run JavaScript, so they are sorted natively and
+/// written back directly to the storage, without going through a SortModel.
+/// \return true if the array was sorted, false if it has to be sorted
+///   generically.
+bool sortDenseDefault(Runtime &runtime, Handle<JSArray> arr, uint64_t len) {
+  // The string representation of each number is kept in a native buffer
+  // several times the size of the element. Beyond this length, let the generic
+  // path convert the numbers on the GC heap instead.
+  static constexpr uint32_t kMaxNumberSortLength = 1 << 16;
+
+  // Elements are written back directly, which requires them to be plain
+  // writable elements of an extensible array.
+  if (!arr->isExtensible() || !arr->hasFastIndexProperties() ||
+      len > arr->getEndIndex())
+    return false;
+  if (len < 2)
+    return true;
+
+  // Nothing below may allocate on the GC heap, since it holds raw values.
+  NoAllocScope noAlloc{runtime};
+  auto n = static_cast<uint32_t>(len);
+  SmallHermesValue first = arr->at(runtime, 0);
+
+  if (first.isNumber()) {
+    if (n > kMaxNumberSortLength)
+      return false;
+    // Numbers are compared by their string representation, which is computed
+    // once per element instead of once per comparison. The elements refer to
+    // a copy of the original values, which may be boxed doubles and must be
+    // written back as they are.
+    struct NumberElement {
+      uint32_t index;
+      uint32_t length;
+      char str[NUMBER_TO_STRING_BUF_SIZE];
+
+      llvh::StringRef ref() const {
+        return {str, length};
+      }
+    };
+    std::vector<SmallHermesValue> values;
+    std::vector<NumberElement> elements(n);
+    values.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) {
+      SmallHermesValue shv = arr->at(runtime, i);
+      if (!shv.isNumber())
+        return false;
+      values.push_back(shv);
+      NumberElement &elem = elements[i];
+      elem.index = i;
+      elem.length = hermes::numberToString(
+          shv.getNumber(runtime), elem.str, NUMBER_TO_STRING_BUF_SIZE);
+    }
+    std::stable_sort(
+        elements.begin(),
+        elements.end(),
+        [](const NumberElement &a, const NumberElement &b) {
+          return a.ref() < b.ref();
+        });
+    for (uint32_t i = 0; i < n; ++i)
+      JSArray::unsafeSetExistingElementAt(
+          *arr, runtime, i, values[elements[i].index]);
+    return true;
+  }
+
+  if (first.isString()) {
+    std::vector<StringPrimitive *> elements;
+    elements.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) {
+      SmallHermesValue shv = arr->at(runtime, i);
+      if (!shv.isString())
+        return false;
+      elements.push_back(shv.getString(runtime));
+    }
+    std::stable_sort(
+        elements.begin(),
+        elements.end(),
+        [](const StringPrimitive *a, const StringPrimitive *b) {
+          return a->compare(b) < 0;
+        });
+    for (uint32_t i = 0; i < n; ++i)
+      JSArray::unsafeSetExistingElementAt(
+          *arr,
+          runtime,
+          i,
+          SmallHermesValue::encodeStringValue(elements[i], runtime));
+    return true;
+  }
+
+  return false;
+}
+
+/// Sort an object with fast indexed properties, a proxy or a host object.
+/// As in the spec, the values of the properties in [0, len) that exist are
+/// collected into a list, which is sorted and then written back, followed by
+/// deleting the properties that were holes.
+CallResult<HermesValue> sortDense(
+    Runtime &runtime,
+    Handle<JSObject> O,
+    Handle<Callable> compareFn,
+    uint64_t len) {
+  GCScope gcScope{runtime};
+
+  auto crList = JSArray::create(runtime, 0, 0);
+  if (LLVM_UNLIKELY(crList == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  auto list = *crList;
+
+  MutableHandle<> k{runtime};
+  MutableHandle<> kValue{runtime};
+  MutableHandle<JSObject> descObjHandle{runtime};
+  MutableHandle<SymbolID> tmpPropNameStorage{runtime};
+  auto marker = gcScope.createMarker();
+
+  // Collect the values, skipping holes.
+  uint32_t itemCount = 0;
+  for (uint64_t i = 0; i < len; ++i) {
+    gcScope.flushToMarker(marker);
+    k = HermesValue::encodeTrustedNumberValue(i);
+    if (LLVM_UNLIKELY(O->isProxyObject())) {
+      auto hasRes = JSObject::hasComputed(O, runtime, k);
+      if (LLVM_UNLIKELY(hasRes == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      if (!*hasRes)
+        continue;
+      auto propRes = JSObject::getComputed_RJS(O, runtime, k);
+      if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      kValue = std::move(*propRes);
+    } else {
+      ComputedPropertyDescriptor desc;
+      JSObject::getComputedPrimitiveDescriptor(
+          O, runtime, k, descObjHandle, tmpPropNameStorage, desc);
+      CallResult<PseudoHandle<>> propRes =
+          JSObject::getComputedPropertyValue_RJS(
+              O, runtime, descObjHandle, tmpPropNameStorage, desc, k);
+      if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      if ((*propRes)->isEmpty())
+        continue;
+      kValue = std::move(*propRes);
+    }
+    if (LLVM_UNLIKELY(itemCount == JSArray::StorageType::maxElements()))
+      return runtime.raiseRangeError("Array too large to sort");
+    JSArray::setElementAt(list, runtime, itemCount++, kValue);
+  }
+  gcScope.flushToMarker(marker);
+
+  {
+    SortListModel sm(runtime, list, compareFn);
+    if (LLVM_UNLIKELY(
+            timSort(&sm, 0u, itemCount) == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+  }
+
+  // Write back the sorted values, and delete the remaining properties so that
+  // the holes end up at the end.
+  for (uint64_t i = 0; i < len; ++i) {
+    gcScope.flushToMarker(marker);
+    k = HermesValue::encodeTrustedNumberValue(i);
+    if (i < itemCount) {
+      kValue = list->at(runtime, i).unboxToHV(runtime);
+      if (LLVM_UNLIKELY(
+              JSObject::putComputed_RJS(
+                  O, runtime, k, kValue, PropOpFlags().plusThrowOnError()) ==
+              ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+    } else {
+      if (LLVM_UNLIKELY(
+              JSObject::deleteComputed(
+                  O, runtime, k, PropOpFlags().plusThrowOnError()) ==
+              ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+    }
+  }
+
+  return O.getHermesValue();
+}
 } // anonymous namespace
 
 /// ES5.1 15.4.4.11.
@@ -1484,16 +1505,15 @@ arrayPrototypeSort(void *, Runtime &runtime, NativeArgs args) {
   if (!O->isProxyObject() && !O->isHostObject() && !O->hasFastIndexProperties())
     return sortSparse(runtime, O, compareFn, len);
 
-  // This is the "fast" path. We are sorting an array with indexed storage.
-  StandardSortModel sm(runtime, O, compareFn);
-
-  // Use our custom sort routine. We can't use std::sort because it performs
-  // optimizations that allow it to bypass calls to std::swap, but our swap
-  // function is special, since it needs to use the internal Object functions.
-  if (LLVM_UNLIKELY(quickSort(&sm, 0u, len) == ExecutionStatus::EXCEPTION))
-    return ExecutionStatus::EXCEPTION;
+  if (!compareFn) {
+    if (auto arr = Handle<JSArray>::dyn_vmcast(O)) {
+      if (sortDenseDefault(runtime, arr, len))
+        return O.getHermesValue();
+    }
+  }
 
-  return O.getHermesValue();
+  // This is the "fast" path. We are sorting an array with indexed storage.
+  return sortDense(runtime, O, compareFn, len);
 }
 
 inline CallResult<HermesValue>
@@ -8,337 +8,688 @@
 #include "hermes/VM/JSLib/Sorting.h"
 
 #include "hermes/Support/Compiler.h"
+#include "hermes/Support/ErrorHandling.h"
 
-#include "llvh/Support/MathExtras.h"
+#include "llvh/ADT/SmallVector.h"
 
 #include <algorithm>
-#include <vector>
 
 namespace hermes {
 namespace vm {
 
+CallResult<OptValue<uint32_t>> SortModel::reserveTemp(uint32_t count) {
+  return OptValue<uint32_t>{llvh::None};
+}
+
+ExecutionStatus SortModel::copy(uint32_t from, uint32_t to) {
+  llvm_unreachable("copy requires temporary slots");
+}
+
 SortModel::~SortModel() = default;
 
 namespace {
 
-/// Helper function to make sort algorithm stable
-/// If [i] < [j], return true
-/// If [j] < [i], return false
-/// If [i] == [j], compare their original index
-CallResult<bool> _less(
-    SortModel *sm,
-    const std::vector<uint32_t> &index,
-    uint32_t i,
-    uint32_t j) {
-  auto res = sm->compare(i, j);
-  if (res == ExecutionStatus::EXCEPTION) {
+/// Runs shorter than this are extended with binary insertion sort before they
+/// are merged. Swaps may be expensive, so this is kept at the lower end of
+/// what TimSort implementations use.
+const uint32_t MIN_MERGE = 32;
+
+/// Number of consecutive elements taken from the same run after which merging
+/// switches to galloping.
+const uint32_t MIN_GALLOP = 7;
+
+/// \return true if [a] < [b].
+inline CallResult<bool> _less(SortModel *sm, uint32_t a, uint32_t b) {
+  auto res = sm->compare(a, b);
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  assert(i < index.size() && "OOB should be impossible");
-  assert(j < index.size() && "OOB should be impossible");
-  return (*res != 0) ? (*res < 0) : (index[i] < index[j]);
+  return *res < 0;
 }
 
-/// Helper function to swap both items and their indices
+/// Swap the \p n elements starting at \p a with the ones starting at \p b.
 ExecutionStatus
-_swap(SortModel *sm, std::vector<uint32_t> &index, uint32_t i, uint32_t j) {
-  if (sm->swap(i, j) == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
+swapRange(SortModel *sm, uint32_t a, uint32_t b, uint32_t n) {
+  for (uint32_t i = 0; i < n; ++i) {
+    if (LLVM_UNLIKELY(sm->swap(a + i, b + i) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
   }
-  assert(i < index.size() && "OOB should be impossible");
-  assert(j < index.size() && "OOB should be impossible");
-  std::swap(index[i], index[j]);
   return ExecutionStatus::RETURNED;
 }
 
-/**
- * @param base the beginning of the logical array
- */
-LLVM_NODISCARD ExecutionStatus heapFixDown(
+/// Reverse the elements in [begin, end).
+ExecutionStatus reverseRange(SortModel *sm, uint32_t begin, uint32_t end) {
+  while (end - begin > 1) {
+    --end;
+    if (LLVM_UNLIKELY(sm->swap(end, begin) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    ++begin;
+  }
+  return ExecutionStatus::RETURNED;
+}
+
+/// Exchange the adjacent ranges [a, m) and [m, b) with a block swap rotation,
+/// which performs at most b - a swaps.
+ExecutionStatus rotate(SortModel *sm, uint32_t a, uint32_t m, uint32_t b) {
+  uint32_t i = m - a;
+  uint32_t j = b - m;
+  while (i != j) {
+    if (i > j) {
+      if (swapRange(sm, m - i, m, j) == ExecutionStatus::EXCEPTION)
+        return ExecutionStatus::EXCEPTION;
+      i -= j;
+    } else {
+      if (swapRange(sm, m - i, m + j - i, i) == ExecutionStatus::EXCEPTION)
+        return ExecutionStatus::EXCEPTION;
+      j -= i;
+    }
+  }
+  return swapRange(sm, m - i, m, i);
+}
+
+/// Find the run starting at \p begin, reversing it in place if it is strictly
+/// descending. Descending runs must be strict so that reversing them keeps
+/// the sort stable.
+/// \return the length of the run, which is at least 1.
+CallResult<uint32_t>
+countRunAndMakeAscending(SortModel *sm, uint32_t begin, uint32_t end) {
+  assert(begin < end && "empty range");
+  uint32_t i = begin + 1;
+  if (i == end) {
+    return 1;
+  }
+
+  CallResult<bool> res = _less(sm, i, begin);
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  bool descending = *res;
+  for (++i; i != end; ++i) {
+    res = _less(sm, i, i - 1);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (*res != descending) {
+      break;
+    }
+  }
+
+  if (descending &&
+      reverseRange(sm, begin, i) == ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return i - begin;
+}
+
+/// Sort [begin, end), of which [begin, sorted) is already sorted, by binary
+/// searching the position of each element and moving it into place.
+ExecutionStatus binaryInsertionSort(
     SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t base,
     uint32_t begin,
+    uint32_t sorted,
     uint32_t end) {
-  CallResult<bool> res{false};
-  if (LLVM_UNLIKELY(end - begin <= 1)) {
-    return ExecutionStatus::RETURNED;
+  assert(begin < sorted && sorted <= end && "invalid range");
+  for (uint32_t i = sorted; i != end; ++i) {
+    // Find the first element in [begin, i) greater than [i], so that [i] goes
+    // after all the elements equal to it.
+    uint32_t lo = begin;
+    uint32_t hi = i;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      auto res = _less(sm, i, mid);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    for (uint32_t j = i; j != lo; --j) {
+      if (LLVM_UNLIKELY(sm->swap(j, j - 1) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
   }
+  return ExecutionStatus::RETURNED;
+}
 
-  uint32_t lastGood = base + (end - base - 2) / 2;
-  uint32_t i = begin;
+/// Stably merge the adjacent sorted ranges [a, m) and [m, b) in place, using
+/// the SymMerge algorithm by Kim and Kutzner. It performs O(m log(n/m + 1))
+/// comparisons, where m is the length of the shorter range, and recurses to a
+/// depth of O(log n). Unlike a buffered merge, moving elements only requires
+/// swaps.
+ExecutionStatus symMerge(SortModel *sm, uint32_t a, uint32_t m, uint32_t b) {
+  assert(a < m && m < b && "ranges must not be empty");
+
+  if (m - a == 1) {
+    // Insert [a] before the first element in [m, b) not less than it.
+    uint32_t lo = m;
+    uint32_t hi = b;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      auto res = _less(sm, mid, a);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    for (uint32_t k = a; k + 1 < lo; ++k) {
+      if (LLVM_UNLIKELY(sm->swap(k, k + 1) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
 
-  while (i <= lastGood) {
-    uint32_t j = (i - base) * 2 + 1 + base;
-    // Find the greater of the two children
-    if (j + 1 < end) {
-      res = _less(sm, index, j, j + 1);
-      if (res == ExecutionStatus::EXCEPTION) {
+  if (b - m == 1) {
+    // Insert [m] before the first element in [a, m) greater than it.
+    uint32_t lo = a;
+    uint32_t hi = m;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      auto res = _less(sm, m, mid);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
       if (*res) {
-        ++j;
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    for (uint32_t k = m; k > lo; --k) {
+      if (LLVM_UNLIKELY(sm->swap(k, k - 1) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
       }
     }
-    // If the child is greater than us, exchange places
-    res = _less(sm, index, i, j);
-    if (res == ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::RETURNED;
+  }
+
+  // Find the split point: the smallest start such that the last m - start
+  // elements of the left range and the first m - start elements of the right
+  // range, mirrored around the middle, need to be exchanged. Indices are
+  // computed in 64 bits since their sum may not fit in 32.
+  uint32_t mid = a + (b - a) / 2;
+  uint64_t n = (uint64_t)mid + m;
+  uint32_t start;
+  uint32_t r;
+  if (m > mid) {
+    start = (uint32_t)(n - b);
+    r = mid;
+  } else {
+    start = a;
+    r = m;
+  }
+  uint64_t p = n - 1;
+  while (start < r) {
+    uint32_t c = start + (r - start) / 2;
+    auto res = _less(sm, (uint32_t)(p - c), c);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
     if (!*res) {
-      break;
+      start = c + 1;
+    } else {
+      r = c;
     }
+  }
 
-    if (_swap(sm, index, i, j) == ExecutionStatus::EXCEPTION) {
+  uint32_t end = (uint32_t)(n - start);
+  if (start < m && m < end) {
+    if (rotate(sm, start, m, end) == ExecutionStatus::EXCEPTION)
+      return ExecutionStatus::EXCEPTION;
+  }
+  if (a < start && start < mid) {
+    if (symMerge(sm, a, start, mid) == ExecutionStatus::EXCEPTION)
+      return ExecutionStatus::EXCEPTION;
+  }
+  if (mid < end && end < b) {
+    if (symMerge(sm, mid, end, b) == ExecutionStatus::EXCEPTION)
       return ExecutionStatus::EXCEPTION;
-    }
-    i = j;
   }
-
   return ExecutionStatus::RETURNED;
 }
 
-ExecutionStatus heapSort(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t begin,
-    uint32_t end) {
-  if (LLVM_UNLIKELY(end - begin <= 1)) {
-    return ExecutionStatus::RETURNED;
+/// \return the first index in [lo, hi) for which \p pred is false, assuming
+/// it is true for a prefix of the range and false for the rest. Probes are
+/// made at exponentially growing distances from lo, so this takes O(log k)
+/// comparisons for a result that is k elements away from it.
+template <typename Pred>
+CallResult<uint32_t> gallopFromLo(uint32_t lo, uint32_t hi, Pred pred) {
+  uint32_t ofs = 1;
+  uint32_t searchHi = hi;
+  while (ofs <= hi - lo) {
+    uint32_t probe = lo + ofs - 1;
+    auto res = pred(probe);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (!*res) {
+      searchHi = probe;
+      break;
+    }
+    lo = probe + 1;
+    ofs = ofs <= UINT32_MAX / 2 ? ofs * 2 : UINT32_MAX;
   }
-
-  // "heapify"
-  uint32_t start = (end - begin - 2) / 2 + begin;
-  do {
-    if (heapFixDown(sm, index, begin, start, end) ==
-        ExecutionStatus::EXCEPTION) {
+  while (lo < searchHi) {
+    uint32_t mid = lo + (searchHi - lo) / 2;
+    auto res = pred(mid);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-  } while (start-- != begin);
+    if (*res) {
+      lo = mid + 1;
+    } else {
+      searchHi = mid;
+    }
+  }
+  return lo;
+}
 
-  while (end - begin > 1) {
-    --end;
-    if (_swap(sm, index, begin, end) == ExecutionStatus::EXCEPTION) {
+/// Like gallopFromLo, but probes at exponentially growing distances from hi.
+template <typename Pred>
+CallResult<uint32_t> gallopFromHi(uint32_t lo, uint32_t hi, Pred pred) {
+  uint32_t ofs = 1;
+  uint32_t searchLo = lo;
+  while (ofs <= hi - lo) {
+    uint32_t probe = hi - ofs;
+    auto res = pred(probe);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-    if (heapFixDown(sm, index, begin, begin, end) ==
-        ExecutionStatus::EXCEPTION) {
+    if (*res) {
+      searchLo = probe + 1;
+      break;
+    }
+    hi = probe;
+    ofs = ofs <= UINT32_MAX / 2 ? ofs * 2 : UINT32_MAX;
+  }
+  while (searchLo < hi) {
+    uint32_t mid = searchLo + (hi - searchLo) / 2;
+    auto res = pred(mid);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
+    if (*res) {
+      searchLo = mid + 1;
+    } else {
+      hi = mid;
+    }
   }
+  return hi;
+}
 
+/// Copy the \p n elements starting at \p from to the ones starting at \p to,
+/// which may overlap.
+ExecutionStatus
+copyRange(SortModel *sm, uint32_t from, uint32_t to, uint32_t n) {
+  if (from > to) {
+    for (uint32_t i = 0; i < n; ++i) {
+      if (LLVM_UNLIKELY(
+              sm->copy(from + i, to + i) == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+    }
+  } else if (from < to) {
+    for (uint32_t i = n; i-- > 0;) {
+      if (LLVM_UNLIKELY(
+              sm->copy(from + i, to + i) == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+    }
+  }
   return ExecutionStatus::RETURNED;
 }
 
-ExecutionStatus insertionSort(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t begin,
-    uint32_t end) {
-  CallResult<bool> res{false};
-  if (begin == end) {
-    return ExecutionStatus::RETURNED;
-  }
+/// Merge the adjacent sorted ranges [a, m) and [m, b), where m - a <= b - m,
+/// by copying [a, m) to the temporary slots starting at \p temp and merging
+/// forwards from a.
+/// Elements are merged one at a time until one side wins MIN_GALLOP times in
+/// a row, at which point we switch to galloping: finding how many elements in
+/// a row come from each side with an exponential search, and copying them in
+/// bulk. This makes merging a short run into a long one much cheaper.
+ExecutionStatus
+mergeLo(SortModel *sm, uint32_t temp, uint32_t a, uint32_t m, uint32_t b) {
+  uint32_t len1 = m - a;
+  if (copyRange(sm, a, temp, len1) == ExecutionStatus::EXCEPTION)
+    return ExecutionStatus::EXCEPTION;
 
-  for (uint32_t i = begin + 1; i != end; ++i) {
-    for (uint32_t j = i; j != begin; --j) {
-      res = _less(sm, index, j, j - 1);
-      if (res == ExecutionStatus::EXCEPTION) {
+  // Left elements are at [temp + i, temp + len1), right elements at [j, b).
+  uint32_t i = 0;
+  uint32_t j = m;
+  uint32_t dest = a;
+  while (i < len1 && j < b) {
+    // Merge one element at a time.
+    uint32_t leftWins = 0;
+    uint32_t rightWins = 0;
+    while (i < len1 && j < b && leftWins < MIN_GALLOP &&
+           rightWins < MIN_GALLOP) {
+      // Take from the right only if it is strictly less, for stability.
+      auto res = _less(sm, j, temp + i);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-      if (!*res) {
-        break;
+      uint32_t from;
+      if (*res) {
+        from = j++;
+        ++rightWins;
+        leftWins = 0;
+      } else {
+        from = temp + i++;
+        ++leftWins;
+        rightWins = 0;
+      }
+      if (LLVM_UNLIKELY(sm->copy(from, dest++) == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+    }
+
+    // Gallop while it keeps paying off.
+    while (i < len1 && j < b) {
+      // Left elements not greater than the next right element.
+      auto notGreater = [sm, j](uint32_t k) -> CallResult<bool> {
+        auto res = _less(sm, j, k);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        return !*res;
+      };
+      auto leftRes = gallopFromLo(temp + i, temp + len1, notGreater);
+      if (LLVM_UNLIKELY(leftRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
       }
-      if (_swap(sm, index, j, j - 1) == ExecutionStatus::EXCEPTION) {
+      uint32_t leftCount = *leftRes - (temp + i);
+      if (copyRange(sm, temp + i, dest, leftCount) ==
+          ExecutionStatus::EXCEPTION)
+        return ExecutionStatus::EXCEPTION;
+      i += leftCount;
+      dest += leftCount;
+      if (i == len1)
+        break;
+
+      // Right elements less than the next left element.
+      auto rightRes = gallopFromLo(j, b, [sm, temp, i](uint32_t k) {
+        return _less(sm, k, temp + i);
+      });
+      if (LLVM_UNLIKELY(rightRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
+      uint32_t rightCount = *rightRes - j;
+      if (copyRange(sm, j, dest, rightCount) == ExecutionStatus::EXCEPTION)
+        return ExecutionStatus::EXCEPTION;
+      j += rightCount;
+      dest += rightCount;
+
+      if (leftCount < MIN_GALLOP && rightCount < MIN_GALLOP)
+        break;
     }
   }
-  return ExecutionStatus::RETURNED;
+
+  // Whatever remains on the right is already in place.
+  return copyRange(sm, temp + i, dest, len1 - i);
 }
 
-// Must be at lest 3, for "median of three" to work
-const uint32_t INSERTION_THRESHOLD = 6;
+/// Merge the adjacent sorted ranges [a, m) and [m, b), where b - m < m - a,
+/// by copying [m, b) to the temporary slots starting at \p temp and merging
+/// backwards from b. Gallops like mergeLo.
+ExecutionStatus
+mergeHi(SortModel *sm, uint32_t temp, uint32_t a, uint32_t m, uint32_t b) {
+  if (copyRange(sm, m, temp, b - m) == ExecutionStatus::EXCEPTION)
+    return ExecutionStatus::EXCEPTION;
 
-/// Performs the partition for quickSort between elements [l,r].
-/// Pre-condition: [l] <= [l+1] <= [r] and [l+1] is the pivot.
-/// This routine is guaranteed to complete even with an inconsistent comparison
-/// routine because it always makes forward progress and doesn't rely on
-/// sentinels.
-/// \return the new index of the pivot.
-CallResult<uint32_t> quickSortPartition(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t l,
-    uint32_t r) {
-  CallResult<bool> res{false};
-  // Now [l] <= [l+1] <= [r]
-  // [l+1] is our pivot.
-  uint32_t pivot = l + 1;
-
-  uint32_t i = pivot + 1, j = r;
-  for (;;) {
-    for (; i <= j; ++i) {
-      res = _less(sm, index, i, pivot);
-      if (res == ExecutionStatus::EXCEPTION)
+  // Left elements are at [a, a + left), right elements at
+  // [temp, temp + right). The merged elements end at a + left + right.
+  uint32_t left = m - a;
+  uint32_t right = b - m;
+  while (left && right) {
+    // Merge one element at a time.
+    uint32_t leftWins = 0;
+    uint32_t rightWins = 0;
+    while (left && right && leftWins < MIN_GALLOP && rightWins < MIN_GALLOP) {
+      // Take from the left only if it is strictly greater, for stability.
+      auto res = _less(sm, temp + right - 1, a + left - 1);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      uint32_t dest = a + left + right - 1;
+      uint32_t from;
+      if (*res) {
+        from = a + --left;
+        ++leftWins;
+        rightWins = 0;
+      } else {
+        from = temp + --right;
+        ++rightWins;
+        leftWins = 0;
+      }
+      if (LLVM_UNLIKELY(sm->copy(from, dest) == ExecutionStatus::EXCEPTION))
         return ExecutionStatus::EXCEPTION;
-      if (!*res)
-        break;
     }
-    assert(i <= r + 1 && "i is out of range");
 
-    for (; i <= j; --j) {
-      res = _less(sm, index, pivot, j);
-      if (res == ExecutionStatus::EXCEPTION)
+    // Gallop while it keeps paying off.
+    while (left && right) {
+      // Right elements not less than the last left element.
+      uint32_t lastLeft = a + left - 1;
+      auto rightRes =
+          gallopFromHi(temp, temp + right, [sm, lastLeft](uint32_t k) {
+            return _less(sm, k, lastLeft);
+          });
+      if (LLVM_UNLIKELY(rightRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
-      if (!*res)
+      }
+      uint32_t rightCount = temp + right - *rightRes;
+      right -= rightCount;
+      if (copyRange(sm, temp + right, a + left + right, rightCount) ==
+          ExecutionStatus::EXCEPTION)
+        return ExecutionStatus::EXCEPTION;
+      if (!right)
         break;
-    }
-    assert(j > l && "j is out of range");
 
-    if (i >= j)
-      break;
-    if (_swap(sm, index, i, j) == ExecutionStatus::EXCEPTION)
-      return ExecutionStatus::EXCEPTION;
-    ++i;
-    --j;
-  }
+      // Left elements greater than the last right element.
+      uint32_t lastRight = temp + right - 1;
+      auto notGreater = [sm, lastRight](uint32_t k) -> CallResult<bool> {
+        auto res = _less(sm, lastRight, k);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        return !*res;
+      };
+      auto leftRes = gallopFromHi(a, a + left, notGreater);
+      if (LLVM_UNLIKELY(leftRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      uint32_t leftCount = a + left - *leftRes;
+      left -= leftCount;
+      if (copyRange(sm, a + left, a + left + right, leftCount) ==
+          ExecutionStatus::EXCEPTION)
+        return ExecutionStatus::EXCEPTION;
 
-  // [j] <= [pivot], we can put the pivot in its final position
-  if (j != pivot) {
-    if (_swap(sm, index, pivot, j) == ExecutionStatus::EXCEPTION)
-      return ExecutionStatus::EXCEPTION;
+      if (leftCount < MIN_GALLOP && rightCount < MIN_GALLOP)
+        break;
+    }
   }
 
-  return j;
+  // Whatever remains on the left is already in place.
+  return copyRange(sm, temp, a, right);
 }
 
-ExecutionStatus doQuickSort(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    int limit,
-    uint32_t l,
-    uint32_t r) {
-  CallResult<bool> res{false};
-quicksort_top:
-  if (limit <= 0) {
-    // Bail to heap sort
-    return heapSort(sm, index, l, r + 1);
-  }
-
-  // Median-of-three
-  // Place the middle element at [l+1]
-  if (_swap(sm, index, l + 1, l + ((r - l) >> 1)) ==
-      ExecutionStatus::EXCEPTION) {
+/// A sorted run [base, base + len) waiting to be merged.
+struct Run {
+  uint32_t base;
+  uint32_t len;
+};
+
+/// State of a TimSort in progress.
+struct SortState {
+  SortModel *sm;
+
+  /// Pending runs, in order. They are adjacent, and each is sorted.
+  llvh::SmallVector<Run, 40> runs{};
+
+  /// Number of temporary slots needed to merge any two runs.
+  uint32_t tempNeeded;
+
+  /// Index of the first temporary slot, if the model provides them.
+  OptValue<uint32_t> temp{llvh::None};
+
+  /// Whether temporary slots were already requested from the model.
+  bool tempReserved{false};
+
+  SortState(SortModel *sm, uint32_t len) : sm(sm), tempNeeded(len / 2) {}
+};
+
+/// Merge the runs at \p i and \p i + 1 in \p st.
+ExecutionStatus mergeAt(SortState &st, size_t i) {
+  SortModel *sm = st.sm;
+  auto &runs = st.runs;
+  assert(i + 1 < runs.size() && "no run to merge with");
+  uint32_t a = runs[i].base;
+  uint32_t m = runs[i + 1].base;
+  uint32_t b = m + runs[i + 1].len;
+  runs[i].len += runs[i + 1].len;
+  runs.erase(runs.begin() + i + 1);
+
+  // Runs that are already in order, which is common when the input was
+  // mostly sorted, don't need to be merged.
+  auto res = _less(sm, m, m - 1);
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  // Sort, [l], [l+1], [r]
-  res = _less(sm, index, r, l + 1);
-  if (res == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
+  if (!*res) {
+    return ExecutionStatus::RETURNED;
   }
-  if (*res) {
-    if (_swap(sm, index, r, l + 1) == ExecutionStatus::EXCEPTION) {
+
+  // Skip the elements of the left run that are not greater than the first
+  // element of the right run, and the elements of the right run that are not
+  // less than the last element of the left run: they are already in place.
+  for (uint32_t hi = m - 1; a < hi;) {
+    uint32_t mid = a + (hi - a) / 2;
+    res = _less(sm, m, mid);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
+    if (*res) {
+      hi = mid;
+    } else {
+      a = mid + 1;
+    }
   }
-  res = _less(sm, index, l + 1, l);
-  if (res == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
+  for (uint32_t lo = m + 1; lo < b;) {
+    uint32_t mid = lo + (b - lo) / 2;
+    res = _less(sm, mid, m - 1);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (*res) {
+      lo = mid + 1;
+    } else {
+      b = mid;
+    }
   }
-  if (*res) {
-    if (_swap(sm, index, l + 1, l) == ExecutionStatus::EXCEPTION) {
+
+  if (!st.tempReserved) {
+    st.tempReserved = true;
+    auto tempRes = sm->reserveTemp(st.tempNeeded);
+    if (LLVM_UNLIKELY(tempRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
+    st.temp = *tempRes;
   }
-  res = _less(sm, index, r, l + 1);
-  if (res == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
+  if (!st.temp) {
+    return symMerge(sm, a, m, b);
+  }
+  if (m - a <= b - m) {
+    return mergeLo(sm, *st.temp, a, m, b);
   }
-  if (*res) {
-    if (_swap(sm, index, r, l + 1) == ExecutionStatus::EXCEPTION) {
+  return mergeHi(sm, *st.temp, a, m, b);
+}
+
+/// Merge runs at the top of the stack until the lengths of the pending runs
+/// satisfy the TimSort invariants, which keep the merges balanced and bound
+/// the size of the stack by O(log n):
+///   runs[i - 2].len > runs[i - 1].len + runs[i].len
+///   runs[i - 1].len > runs[i].len
+ExecutionStatus mergeCollapse(SortState &st) {
+  auto &runs = st.runs;
+  while (runs.size() > 1) {
+    size_t n = runs.size() - 2;
+    if ((n > 0 && runs[n - 1].len <= runs[n].len + runs[n + 1].len) ||
+        (n > 1 && runs[n - 2].len <= runs[n - 1].len + runs[n].len)) {
+      if (runs[n - 1].len < runs[n + 1].len) {
+        --n;
+      }
+    } else if (runs[n].len > runs[n + 1].len) {
+      break;
+    }
+    if (mergeAt(st, n) == ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
     }
   }
+  return ExecutionStatus::RETURNED;
+}
 
-  // Now [l] <= [l+1] <= [r]
-  // [l+1] is our pivot and [r] is a sentinel
-  CallResult<uint32_t> partitionResult{quickSortPartition(sm, index, l, r)};
-  if (partitionResult == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
+/// \return the minimum run length for sorting \p n elements, chosen so that
+/// n / minRun is equal to, or slightly less than, a power of two.
+uint32_t computeMinRun(uint32_t n) {
+  uint32_t r = 0;
+  while (n >= MIN_MERGE) {
+    r |= n & 1;
+    n >>= 1;
   }
-  uint32_t j = *partitionResult;
+  return n + r;
+}
 
-  // To limit the stack size, recurse for the smaller partition and do
-  // tail-recursion for the bigger one
-  uint32_t lSize = j - l;
-  uint32_t rSize = r - j;
-  if (lSize <= rSize) {
-    if (lSize > INSERTION_THRESHOLD) {
-      if (doQuickSort(sm, index, limit - 1, l, j - 1) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      if (insertionSort(sm, index, l, j) == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    }
+} // namespace
 
-    if (rSize > INSERTION_THRESHOLD) {
-      l = j + 1;
-      --limit;
-      goto quicksort_top;
-    } else {
-      if (insertionSort(sm, index, j + 1, r + 1) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
+ExecutionStatus timSort(SortModel *sm, uint32_t begin, uint32_t end) {
+  if (begin >= end || end - begin < 2)
+    return ExecutionStatus::RETURNED;
+
+  uint32_t minRun = computeMinRun(end - begin);
+  SortState st{sm, end - begin};
+  auto &runs = st.runs;
+
+  for (uint32_t lo = begin; lo != end;) {
+    auto runRes = countRunAndMakeAscending(sm, lo, end);
+    if (LLVM_UNLIKELY(runRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
+    uint32_t runLen = *runRes;
 
-  } else {
-    if (rSize > INSERTION_THRESHOLD) {
-      if (doQuickSort(sm, index, limit - 1, j + 1, r) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      if (insertionSort(sm, index, j + 1, r + 1) ==
+    // Extend short runs to minRun elements.
+    if (runLen < minRun) {
+      uint32_t forced = std::min(minRun, end - lo);
+      if (binaryInsertionSort(sm, lo, lo + runLen, lo + forced) ==
           ExecutionStatus::EXCEPTION) {
         return ExecutionStatus::EXCEPTION;
       }
+      runLen = forced;
     }
 
-    if (lSize > INSERTION_THRESHOLD) {
-      r = j - 1;
-      --limit;
-      goto quicksort_top;
-    } else {
-      if (insertionSort(sm, index, l, j) == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
+    runs.push_back({lo, runLen});
+    if (mergeCollapse(st) == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
     }
+    lo += runLen;
   }
 
-  return ExecutionStatus::RETURNED;
-}
-
-} // namespace
-
-ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end) {
-  if (begin >= end)
-    return ExecutionStatus::RETURNED;
-  uint32_t len = end - begin;
-  std::vector<uint32_t> index(len); // Array of original indices of items
-  for (uint32_t i = 0; i < len; ++i) {
-    index[i] = i;
+  // Merge all the remaining runs, from the top of the stack.
+  while (runs.size() > 1) {
+    size_t n = runs.size() - 2;
+    if (n > 0 && runs[n - 1].len < runs[n + 1].len) {
+      --n;
+    }
+    if (mergeAt(st, n) == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
   }
 
-  if (len > INSERTION_THRESHOLD) {
-    return doQuickSort(sm, index, llvh::Log2_32(len) * 2, begin, end - 1);
-  } else {
-    return insertionSort(sm, index, begin, end);
-  }
+  return ExecutionStatus::RETURNED;
 }
 
 } // namespace vm
@@ -342,10 +342,23 @@ CallResult<HermesValue> mapFilterLoop(
   return HermesValue::encodeUntrustedNumberValue(insert);
 }
 
-/// This is the sort model for use with TypedArray.prototype.sort.
-/// template param \p WithCompareFn should be true if the compare function is
-/// a valid callback to call, and false if it is null or undefined.
-template <bool WithCompareFn>
+/// The default TypedArray sort order: numeric, with -0 before +0 and NaN
+/// after everything else.
+template <typename T>
+bool typedArrayDefaultLess(T a, T b) {
+  if constexpr (std::is_floating_point<T>::value) {
+    if (LLVM_UNLIKELY(std::isnan(a)))
+      return false;
+    if (LLVM_UNLIKELY(std::isnan(b)))
+      return true;
+    if (LLVM_UNLIKELY(a == 0 && b == 0))
+      return std::signbit(a) && !std::signbit(b);
+  }
+  return a < b;
+}
+
+/// This is the sort model for use with TypedArray.prototype.sort with a
+/// compare function. Without one, elements are sorted natively.
 class TypedArraySortModel : public SortModel {
  protected:
   /// Runtime to sort in.
@@ -406,8 +419,8 @@ class TypedArraySortModel : public SortModel {
     {
       Handle<> aValHandle = runtime_.makeHandle(JSObject::getOwnIndexed(
           createPseudoHandle(self_.get()), runtime_, a));
-      // To avoid the need to create a handle for bVal a NoAllocScope is created
-      // below, to ensure no memory allocation will happen.
+      // To avoid the need to create a handle for bVal, nothing may allocate
+      // between reading it and passing it to the call below.
       HermesValue bVal =
           JSObject::getOwnIndexed(createPseudoHandle(self_.get()), runtime_, b);
 
@@ -415,26 +428,6 @@ class TypedArraySortModel : public SortModel {
       // after no more allocations are expected for a while.
       HermesValue aVal = *aValHandle;
 
-      {
-        NoAllocScope noAllocs{runtime_};
-        if (!WithCompareFn) {
-          if (LLVM_UNLIKELY(aVal.isBigInt())) {
-            return aVal.getBigInt()->compare(bVal.getBigInt());
-          } else {
-            double a = aVal.getNumber();
-            double b = bVal.getNumber();
-            if (LLVM_UNLIKELY(a == 0) && LLVM_UNLIKELY(b == 0) &&
-                LLVM_UNLIKELY(std::signbit(a)) &&
-                LLVM_UNLIKELY(!std::signbit(b))) {
-              // -0 < +0, according to the spec.
-              return -1;
-            }
-            return (a < b) ? -1 : (a > b ? 1 : 0);
-          }
-          assert(
-              compareFn_ && "Cannot use this version if the compareFn is null");
-        }
-      }
       // ES7 22.2.3.26 2a.
       // Let v be toNumber_RJS(Call(comparefn, undefined, x, y)).
       callRes = Callable::executeCall2(
@@ -1504,17 +1497,29 @@ typedArrayPrototypeSort(void *, Runtime &runtime, NativeArgs args) {
     return runtime.raiseTypeError("TypedArray sort argument must be callable");
   }
 
-  // Use our custom sort routine. We can't use std::sort because it performs
-  // optimizations that allow it to bypass calls to std::swap, but our swap
-  // function is special, since it needs to use the internal Object functions.
   if (compareFn) {
-    TypedArraySortModel<true> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
-      return ExecutionStatus::EXCEPTION;
-  } else {
-    TypedArraySortModel<false> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
+    // Use our custom sort routine, since the compare function can run
+    // arbitrary code, including detaching the buffer.
+    TypedArraySortModel sm(runtime, self, compareFn);
+    if (LLVM_UNLIKELY(timSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
+    return self.getHermesValue();
+  }
+
+  // Without a compare function, the elements can be sorted directly in the
+  // buffer. Equal elements are indistinguishable, so stability is moot.
+#define TYPED_ARRAY(name, type)                                               \
+  case CellKind::name##ArrayKind: {                                           \
+    auto *arr = vmcast<JSTypedArray<type, CellKind::name##ArrayKind>>(*self); \
+    std::sort(                                                                \
+        arr->begin(runtime), arr->end(runtime), typedArrayDefaultLess<type>); \
+    break;                                                                    \
+  }
+
+  switch (self->getKind()) {
+#include "hermes/VM/TypedArrays.def"
+    default:
+      llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
   }
   return self.getHermesValue();
 }
@@ -321,6 +321,17 @@ CallResult<RegExpMatch> JSRegExp::search(
     matchFlags |= regex::constants::matchOnlyAtStart;
   }
 
+  switch (runtime.getRegExpEngine()) {
+    case RegExpEngine::Auto:
+      break;
+    case RegExpEngine::Backtracking:
+      matchFlags |= regex::constants::matchForceBacktracking;
+      break;
+    case RegExpEngine::Linear:
+      matchFlags |= regex::constants::matchForceLinear;
+      break;
+  }
+
   CallResult<RegExpMatch> matchResult = RegExpMatch{};
   if (input.isASCII()) {
     matchFlags |= regex::constants::matchInputAllAscii;
@@ -7,32 +7,52 @@
 
 #include "hermes/VM/OrderedHashMap.h"
 
+#include "hermes/Support/CheckedMalloc.h"
 #include "hermes/Support/ErrorHandling.h"
 #include "hermes/VM/BuildMetadata.h"
 #include "hermes/VM/GCPointer-inline.h"
 #include "hermes/VM/Operations.h"
 
+#include "llvh/Support/MathExtras.h"
+
 namespace hermes {
 namespace vm {
 //===----------------------------------------------------------------------===//
-// class HashMapEntry
-
-const VTable HashMapEntry::vt{
-    CellKind::HashMapEntryKind,
-    cellSize<HashMapEntry>()};
-
-void HashMapEntryBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
-  const auto *self = static_cast<const HashMapEntry *>(cell);
-  mb.setVTable(&HashMapEntry::vt);
-  mb.addField("key", &self->key);
-  mb.addField("value", &self->value);
-  mb.addField("prevIterationEntry", &self->prevIterationEntry);
-  mb.addField("nextIterationEntry", &self->nextIterationEntry);
-  mb.addField("nextEntryInBucket", &self->nextEntryInBucket);
+// class HashMapGeneration
+
+const VTable HashMapGeneration::vt{
+    CellKind::HashMapGenerationKind,
+    cellSize<HashMapGeneration>()};
+
+void HashMapGenerationBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
+  const auto *self = static_cast<const HashMapGeneration *>(cell);
+  mb.setVTable(&HashMapGeneration::vt);
+  mb.addField("next", &self->next_);
+  mb.addField("entries", &self->entries_);
 }
 
-CallResult<PseudoHandle<HashMapEntry>> HashMapEntry::create(Runtime &runtime) {
-  return createPseudoHandle(runtime.makeAFixed<HashMapEntry>());
+PseudoHandle<HashMapGeneration> HashMapGeneration::create(Runtime &runtime) {
+  return createPseudoHandle(runtime.makeAFixed<HashMapGeneration>());
+}
+
+uint32_t HashMapGeneration::translateIndex(Runtime &runtime, uint32_t index)
+    const {
+  assert(next_ && "Only a retired generation can translate positions");
+  const SegmentedArraySmall *entries = entries_.get(runtime);
+  if (!entries) {
+    // The map was cleared.
+    return 0;
+  }
+  // Compaction preserves the order of the live entries, so the new position
+  // is the number of live entries before the old one. Each entry occupies two
+  // slots, starting with the key, which is empty if the entry was deleted.
+  uint32_t newIndex = 0;
+  const uint32_t end = std::min(index, entries->size(runtime) / 2);
+  for (uint32_t i = 0; i < end; ++i) {
+    if (!entries->at(runtime, i * 2).isEmpty())
+      ++newIndex;
+  }
+  return newIndex;
 }
 
 //===----------------------------------------------------------------------===//
@@ -40,160 +60,192 @@ CallResult<PseudoHandle<HashMapEntry>> HashMapEntry::create(Runtime &runtime) {
 
 const VTable OrderedHashMap::vt{
     CellKind::OrderedHashMapKind,
-    cellSize<OrderedHashMap>()};
+    cellSize<OrderedHashMap>(),
+    _finalizeImpl,
+    _mallocSizeImpl};
 
 void OrderedHashMapBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   const auto *self = static_cast<const OrderedHashMap *>(cell);
   mb.setVTable(&OrderedHashMap::vt);
-  mb.addField("hashTable", &self->hashTable_);
-  mb.addField("firstIterationEntry", &self->firstIterationEntry_);
-  mb.addField("lastIterationEntry", &self->lastIterationEntry_);
+  mb.addField("entries", &self->entries_);
+  mb.addField("generation", &self->generation_);
 }
 
 OrderedHashMap::OrderedHashMap(
     Runtime &runtime,
-    Handle<ArrayStorageSmall> hashTableStorage)
-    : hashTable_(runtime, hashTableStorage.get(), runtime.getHeap()) {}
+    Handle<SegmentedArraySmall> entries)
+    : entries_(runtime, entries.get(), runtime.getHeap()) {
+  index_.set(runtime, nullptr);
+}
 
 CallResult<PseudoHandle<OrderedHashMap>> OrderedHashMap::create(
     Runtime &runtime) {
-  auto arrRes =
-      ArrayStorageSmall::create(runtime, INITIAL_CAPACITY, INITIAL_CAPACITY);
+  auto arrRes = SegmentedArraySmall::create(runtime, INITIAL_CAPACITY);
   if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto hashTableStorage = runtime.makeHandle<ArrayStorageSmall>(*arrRes);
+  auto entries = runtime.makeHandle<SegmentedArraySmall>(std::move(*arrRes));
 
   return createPseudoHandle(
-      runtime.makeAFixed<OrderedHashMap>(runtime, hashTableStorage));
+      runtime.makeAFixed<OrderedHashMap, HasFinalizer::Yes>(runtime, entries));
+}
+
+void OrderedHashMap::_finalizeImpl(GCCell *cell, GC &gc) {
+  auto *self = vmcast<OrderedHashMap>(cell);
+  self->freeIndex(gc);
+  self->~OrderedHashMap();
+}
+
+size_t OrderedHashMap::_mallocSizeImpl(GCCell *cell) {
+  return vmcast<OrderedHashMap>(cell)->capacity_ * sizeof(Bucket);
 }
 
-void OrderedHashMap::removeLinkedListNode(
+void OrderedHashMap::freeIndex(GC &gc) {
+  if (!capacity_)
+    return;
+  gc.debitExternalMemory(this, capacity_ * sizeof(Bucket));
+  free(index_.get(gc));
+  index_.set(gc, nullptr);
+  capacity_ = 0;
+}
+
+/// \return the number of buckets to use for an index holding \p size entries,
+/// leaving room for as many insertions before it needs to be rebuilt.
+static uint32_t capacityForSize(uint32_t size, uint32_t minCapacity) {
+  return std::max<uint32_t>(minCapacity, llvh::PowerOf2Ceil(size * 4ull));
+}
+
+OptValue<uint32_t> OrderedHashMap::lookup(
     Runtime &runtime,
-    HashMapEntry *entry,
-    GC &gc) {
-  assert(
-      entry != lastIterationEntry_.get(runtime) &&
-      "Cannot remove the last entry");
-  if (entry->prevIterationEntry) {
-    entry->prevIterationEntry.getNonNull(runtime)->nextIterationEntry.set(
-        runtime, entry->nextIterationEntry, gc);
+    uint32_t hash,
+    HermesValue key) const {
+  if (!capacity_)
+    return llvh::None;
+  const Bucket *buckets = index_.get(runtime);
+  const SegmentedArraySmall *entries = entries_.getNonNull(runtime);
+  const uint32_t mask = capacity_ - 1;
+  // The index is never more than half full, so the probing terminates.
+  for (uint32_t i = hash & mask;; i = (i + 1) & mask) {
+    const Bucket &bucket = buckets[i];
+    if (!bucket.entry)
+      return llvh::None;
+    if (bucket.hash != hash)
+      continue;
+    const uint32_t index = bucket.entry - 1;
+    HermesValue entryKey =
+        entries->at(runtime, keySlot(index)).unboxToHV(runtime);
+    // Deleted entries have an empty key, which never matches.
+    if (!entryKey.isEmpty() && isSameValueZero(entryKey, key))
+      return index;
   }
-  if (entry->nextIterationEntry) {
-    entry->nextIterationEntry.getNonNull(runtime)->prevIterationEntry.set(
-        runtime, entry->prevIterationEntry, gc);
-  }
-  if (entry == firstIterationEntry_.get(runtime)) {
-    firstIterationEntry_.set(runtime, entry->nextIterationEntry, gc);
-  }
-  entry->prevIterationEntry.setNull(runtime.getHeap());
 }
 
-static HashMapEntry *castToMapEntry(SmallHermesValue shv, PointerBase &base) {
-  if (shv.isEmpty())
-    return nullptr;
-  return vmcast<HashMapEntry>(shv.getObject(base));
+void OrderedHashMap::addToIndex(
+    Bucket *buckets,
+    uint32_t capacity,
+    uint32_t hash,
+    uint32_t index) {
+  const uint32_t mask = capacity - 1;
+  uint32_t i = hash & mask;
+  while (buckets[i].entry)
+    i = (i + 1) & mask;
+  buckets[i].hash = hash;
+  buckets[i].entry = index + 1;
 }
 
-HashMapEntry *OrderedHashMap::lookupInBucket(
+void OrderedHashMap::retireGeneration(
+    Handle<OrderedHashMap> self,
     Runtime &runtime,
-    uint32_t bucket,
-    HermesValue key) {
-  assert(
-      hashTable_.getNonNull(runtime)->size() == capacity_ &&
-      "Inconsistent capacity");
-  auto *entry =
-      castToMapEntry(hashTable_.getNonNull(runtime)->at(bucket), runtime);
-  while (entry && !isSameValueZero(entry->key, key)) {
-    entry = entry->nextEntryInBucket.get(runtime);
+    Handle<SegmentedArraySmall> oldEntries) {
+  if (!self->generation_) {
+    // The map was never iterated, so there are no positions to translate.
+    return;
   }
-  return entry;
+  auto next = HashMapGeneration::create(runtime);
+  HashMapGeneration *current = self->generation_.getNonNull(runtime);
+  if (oldEntries)
+    current->entries_.setNonNull(runtime, *oldEntries, runtime.getHeap());
+  current->next_.setNonNull(runtime, next.get(), runtime.getHeap());
+  self->generation_.setNonNull(runtime, next.get(), runtime.getHeap());
 }
 
-ExecutionStatus OrderedHashMap::rehashIfNecessary(
+ExecutionStatus OrderedHashMap::rehash(
     Handle<OrderedHashMap> self,
-    Runtime &runtime) {
-  uint32_t newCapacity = self->capacity_;
-  // NOTE: we have ensured that self->capacity_ * 4 never overflows uint32_t by
-  // setting MAX_CAPACITY to the appropriate value. self->size_ is always <=
-  // self->capacity_, so this applies to self->size_ as well.
-  static_assert(
-      MAX_CAPACITY < UINT32_MAX / 4,
-      "Avoid overflow checks on multiplying capacity by 4");
-  if (self->size_ * 4 > self->capacity_ * 3) {
-    // Load factor is more than 0.75, need to increase the capacity.
-    newCapacity = self->capacity_ * 2;
-    if (LLVM_UNLIKELY(newCapacity > MAX_CAPACITY)) {
-      // We maintain the invariant that the capacity_ is a power of two.
-      // Therefore, if doubling would exceed the max, we revert to the
-      // previous value.  (Assert the invariant to make it clear.)
-      assert(
-          (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-          "capacity_ must be power of 2");
-      newCapacity = self->capacity_;
-    }
-  } else if (
-      self->size_ * 4 < self->capacity_ && self->capacity_ > INITIAL_CAPACITY) {
-    // Load factor is less than 0.25, and we are not at initial cap.
-    newCapacity = self->capacity_ / 2;
+    Runtime &runtime,
+    uint32_t newCapacity,
+    bool compact) {
+  assert(
+      (newCapacity & (newCapacity - 1)) == 0 &&
+      "capacity must be power of 2");
+  assert(
+      newCapacity >= (compact ? self->size_ : self->numEntries_) * 2 &&
+      "New capacity is too small");
+  if (LLVM_UNLIKELY(newCapacity > MAX_CAPACITY)) {
+    return runtime.raiseRangeError("Map/Set size exceeds the maximum");
   }
-  if (newCapacity == self->capacity_) {
-    // No need to rehash.
-    return ExecutionStatus::RETURNED;
+  if (newCapacity > self->capacity_ &&
+      LLVM_UNLIKELY(!runtime.getHeap().canAllocExternalMemory(
+          newCapacity * sizeof(Bucket)))) {
+    return runtime.raiseRangeError("Cannot allocate storage for Map/Set");
   }
-  assert(
-      self->size_ && self->firstIterationEntry_ && self->lastIterationEntry_ &&
-      "We should never be rehashing when there are no elements");
-
-  // Set new capacity first to update the hash function.
-  self->capacity_ = newCapacity;
 
-  // Create a new hash table.
-  auto arrRes = ArrayStorageSmall::create(runtime, newCapacity, newCapacity);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
+  // Position of each entry of the current entries array in the compacted one,
+  // or UINT32_MAX if it was deleted.
+  std::vector<uint32_t> newPositions;
+  if (compact) {
+    auto arrRes = SegmentedArraySmall::create(
+        runtime,
+        std::max(self->size_ * 2, INITIAL_CAPACITY),
+        self->size_ * 2);
+    if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    auto newEntries =
+        runtime.makeHandle<SegmentedArraySmall>(std::move(*arrRes));
+    auto oldEntries = runtime.makeHandle(self->entries_.getNonNull(runtime));
+    retireGeneration(self, runtime, oldEntries);
+
+    // No allocations from here on.
+    newPositions.resize(self->numEntries_, UINT32_MAX);
+    uint32_t newIndex = 0;
+    for (uint32_t i = 0; i < self->numEntries_; ++i) {
+      SmallHermesValue key = oldEntries->at(runtime, keySlot(i));
+      if (key.isEmpty())
+        continue;
+      newEntries->set(runtime, keySlot(newIndex), key);
+      newEntries->set(
+          runtime, valueSlot(newIndex), oldEntries->at(runtime, valueSlot(i)));
+      newPositions[i] = newIndex++;
+    }
+    assert(newIndex == self->size_ && "Inconsistent size");
+    self->entries_.setNonNull(runtime, *newEntries, runtime.getHeap());
+    self->numEntries_ = self->size_;
   }
-  auto newHashTable = runtime.makeHandle<ArrayStorageSmall>(*arrRes);
-
-  // Now re-add all entries to the hash table.
-  MutableHandle<HashMapEntry> entry{runtime};
-  MutableHandle<HashMapEntry> oldNextInBucket{runtime};
-  MutableHandle<> keyHandle{runtime};
-  GCScopeMarkerRAII marker{runtime};
-  for (unsigned i = 0, len = self->hashTable_.getNonNull(runtime)->size();
-       i < len;
-       ++i) {
-    entry =
-        castToMapEntry(self->hashTable_.getNonNull(runtime)->at(i), runtime);
-    while (entry) {
-      marker.flush();
-      keyHandle = entry->key;
-      uint32_t bucket = hashToBucket(self, runtime, keyHandle);
-      oldNextInBucket = entry->nextEntryInBucket.get(runtime);
-      if (newHashTable->at(bucket).isEmpty()) {
-        // Empty bucket.
-        entry->nextEntryInBucket.setNull(runtime.getHeap());
-      } else {
-        // There are already a bucket head.
-        entry->nextEntryInBucket.set(
-            runtime,
-            vmcast<HashMapEntry>(newHashTable->at(bucket).getObject(runtime)),
-            runtime.getHeap());
-      }
-      // Update bucket head to the new entry.
-      newHashTable->set(
-          bucket,
-          SmallHermesValue::encodeObjectValue(*entry, runtime),
-          runtime.getHeap());
-
-      entry = *oldNextInBucket;
+
+  // Rebuild the index from the old one, using the recorded hashes.
+  auto *newBuckets =
+      static_cast<Bucket *>(checkedCalloc(newCapacity, sizeof(Bucket)));
+  const Bucket *oldBuckets = self->index_.get(runtime);
+  const SegmentedArraySmall *entries = self->entries_.getNonNull(runtime);
+  for (uint32_t i = 0; i < self->capacity_; ++i) {
+    const Bucket &bucket = oldBuckets[i];
+    if (!bucket.entry)
+      continue;
+    uint32_t index = bucket.entry - 1;
+    if (compact) {
+      index = newPositions[index];
+      if (index == UINT32_MAX)
+        continue;
+    } else if (entries->at(runtime, keySlot(index)).isEmpty()) {
+      continue;
     }
+    addToIndex(newBuckets, newCapacity, bucket.hash, index);
   }
 
-  self->hashTable_.setNonNull(runtime, newHashTable.get(), runtime.getHeap());
-  assert(
-      self->hashTable_.getNonNull(runtime)->size() == self->capacity_ &&
-      "Inconsistent capacity");
+  self->freeIndex(runtime.getHeap());
+  self->index_.set(runtime, newBuckets);
+  self->capacity_ = newCapacity;
+  runtime.getHeap().creditExternalMemory(*self, newCapacity * sizeof(Bucket));
   return ExecutionStatus::RETURNED;
 }
 
@@ -201,27 +253,24 @@ bool OrderedHashMap::has(
     Handle<OrderedHashMap> self,
     Runtime &runtime,
     Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
-}
-
-HashMapEntry *OrderedHashMap::find(
-    Handle<OrderedHashMap> self,
-    Runtime &runtime,
-    Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
+  if (!self->size_)
+    return false;
+  const uint32_t hash = hashKey(runtime, key);
+  return self->lookup(runtime, hash, *key).hasValue();
 }
 
 HermesValue OrderedHashMap::get(
     Handle<OrderedHashMap> self,
     Runtime &runtime,
     Handle<> key) {
-  auto *entry = find(self, runtime, key);
-  if (!entry) {
+  if (!self->size_)
+    return HermesValue::encodeUndefinedValue();
+  const uint32_t hash = hashKey(runtime, key);
+  auto index = self->lookup(runtime, hash, *key);
+  if (!index) {
     return HermesValue::encodeUndefinedValue();
   }
-  return entry->value;
+  return self->getValueAt(runtime, *index);
 }
 
 ExecutionStatus OrderedHashMap::insert(
@@ -229,162 +278,146 @@ ExecutionStatus OrderedHashMap::insert(
     Runtime &runtime,
     Handle<> key,
     Handle<> value) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  if (auto *entry =
-          self->lookupInBucket(runtime, bucket, key.getHermesValue())) {
+  const uint32_t hash = hashKey(runtime, key);
+  if (auto index = self->lookup(runtime, hash, *key)) {
     // Element already exists, update value and return.
-    entry->value.set(value.get(), runtime.getHeap());
+    const auto shv = SmallHermesValue::encodeHermesValue(*value, runtime);
+    self->entries_.getNonNull(runtime)->set(runtime, valueSlot(*index), shv);
     return ExecutionStatus::RETURNED;
   }
-  // Create a new entry, set the key and value.
-  auto crtRes = HashMapEntry::create(runtime);
-  if (LLVM_UNLIKELY(crtRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto newMapEntry = runtime.makeHandle(std::move(*crtRes));
-  newMapEntry->key.set(key.get(), runtime.getHeap());
-  newMapEntry->value.set(value.get(), runtime.getHeap());
-  auto *curBucketFront =
-      castToMapEntry(self->hashTable_.getNonNull(runtime)->at(bucket), runtime);
-  if (curBucketFront) {
-    // If the bucket we are inserting to is not empty, we maintain the
-    // linked list properly.
-    newMapEntry->nextEntryInBucket.set(
-        runtime, curBucketFront, runtime.getHeap());
-  }
-  // Set the newly inserted entry as the front of this bucket chain.
-  self->hashTable_.getNonNull(runtime)->set(
-      bucket,
-      SmallHermesValue::encodeObjectValue(*newMapEntry, runtime),
-      runtime.getHeap());
-
-  if (!self->firstIterationEntry_) {
-    // If we are inserting the first ever element, update
-    // first iteration entry pointer.
-    self->firstIterationEntry_.set(
-        runtime, newMapEntry.get(), runtime.getHeap());
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), runtime.getHeap());
-  } else {
-    // Connect the new entry with the last entry.
-    self->lastIterationEntry_.getNonNull(runtime)->nextIterationEntry.set(
-        runtime, newMapEntry.get(), runtime.getHeap());
-    newMapEntry->prevIterationEntry.set(
-        runtime, self->lastIterationEntry_, runtime.getHeap());
-
-    HashMapEntry *previousLastEntry = self->lastIterationEntry_.get(runtime);
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), runtime.getHeap());
-
-    if (previousLastEntry && previousLastEntry->isDeleted()) {
-      // If the last entry was a deleted entry, we no longer need to keep it.
-      self->removeLinkedListNode(runtime, previousLastEntry, runtime.getHeap());
+
+  // Make sure the index stays at most half full with the new entry.
+  if ((self->numEntries_ + 1) * 2 > self->capacity_) {
+    const uint32_t numDeleted = self->numEntries_ - self->size_;
+    ExecutionStatus status;
+    if (numDeleted && numDeleted * 2 >= self->numEntries_) {
+      // At least half of the entries are deleted, drop them instead of
+      // growing.
+      status = rehash(
+          self,
+          runtime,
+          capacityForSize(self->size_ + 1, INITIAL_CAPACITY),
+          true);
+    } else {
+      status = rehash(
+          self,
+          runtime,
+          std::max(self->capacity_ * 2, INITIAL_CAPACITY),
+          false);
+    }
+    if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
   }
 
+  // Append the new entry.
+  const uint32_t index = self->numEntries_;
+  MutableHandle<SegmentedArraySmall> entries{
+      runtime, self->entries_.getNonNull(runtime)};
+  if (LLVM_UNLIKELY(
+          SegmentedArraySmall::resize(entries, runtime, keySlot(index + 1)) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  self->entries_.setNonNull(runtime, *entries, runtime.getHeap());
+  // Encoding may allocate, so it must happen before accessing the entries.
+  const auto keyShv = SmallHermesValue::encodeHermesValue(*key, runtime);
+  entries->set(runtime, keySlot(index), keyShv);
+  const auto valueShv = SmallHermesValue::encodeHermesValue(*value, runtime);
+  entries->set(runtime, valueSlot(index), valueShv);
+
+  addToIndex(self->index_.get(runtime), self->capacity_, hash, index);
+  self->numEntries_++;
   self->size_++;
-  return self->rehashIfNecessary(self, runtime);
+  return ExecutionStatus::RETURNED;
 }
 
 bool OrderedHashMap::erase(
     Handle<OrderedHashMap> self,
     Runtime &runtime,
     Handle<> key) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  HashMapEntry *prevEntry = nullptr;
-  auto *entry =
-      castToMapEntry(self->hashTable_.getNonNull(runtime)->at(bucket), runtime);
-  while (entry && !isSameValueZero(entry->key, key.getHermesValue())) {
-    prevEntry = entry;
-    entry = entry->nextEntryInBucket.get(runtime);
-  }
-  if (!entry) {
+  if (!self->size_)
+    return false;
+  const uint32_t hash = hashKey(runtime, key);
+  auto index = self->lookup(runtime, hash, *key);
+  if (!index) {
     // Element does not exist.
     return false;
   }
 
-  if (prevEntry) {
-    // The entry we are deleting has a previous entry, update the link.
-    prevEntry->nextEntryInBucket.set(
-        runtime, entry->nextEntryInBucket, runtime.getHeap());
-  } else {
-    // The entry we are erasing is the front entry in the bucket, we need
-    // to update the bucket head to the next entry in the bucket, if not
-    // any, set to empty value.
-    self->hashTable_.getNonNull(runtime)->set(
-        bucket,
-        entry->nextEntryInBucket
-            ? SmallHermesValue::encodeObjectValue(entry->nextEntryInBucket)
-            : SmallHermesValue::encodeEmptyValue(),
-        runtime.getHeap());
-  }
-
-  entry->markDeleted(runtime);
+  // Leave a tombstone. The entry keeps its position so that iterators don't
+  // need to be updated, and its bucket stays in the index until the next
+  // rehash.
+  SegmentedArraySmall *entries = self->entries_.getNonNull(runtime);
+  entries->setNonPtr(
+      runtime, keySlot(*index), SmallHermesValue::encodeEmptyValue());
+  entries->setNonPtr(
+      runtime, valueSlot(*index), SmallHermesValue::encodeEmptyValue());
   self->size_--;
 
-  // Now delete the entry from the iteration linked list.
-  // If we are deleting the last entry, don't remove it from the list yet.
-  // This will ensure that if any iterator out there is currently pointing to
-  // this entry, it will be able to follow on if we add new entries in the
-  // future.
-  if (entry != self->lastIterationEntry_.get(runtime)) {
-    self->removeLinkedListNode(runtime, entry, runtime.getHeap());
+  if (self->size_ * 8 < self->capacity_ &&
+      self->capacity_ > INITIAL_CAPACITY) {
+    // Most of the map was deleted, compact it into a smaller one. Compaction
+    // allocates a new entries array, which may fail; the map is left intact in
+    // that case, so just keep the tombstones and retry on a later erase.
+    if (LLVM_UNLIKELY(
+            rehash(
+                self,
+                runtime,
+                capacityForSize(self->size_, INITIAL_CAPACITY),
+                true) == ExecutionStatus::EXCEPTION)) {
+      runtime.clearThrownValue();
+    }
   }
 
-  self->rehashIfNecessary(self, runtime);
-
   return true;
 }
 
-HashMapEntry *OrderedHashMap::iteratorNext(
-    Runtime &runtime,
-    HashMapEntry *entry) const {
-  if (entry == nullptr) {
-    // Starting a new iteration from the first entry.
-    entry = firstIterationEntry_.get(runtime);
-  } else {
-    // Advance to the next entry.
-    entry = entry->nextIterationEntry.get(runtime);
+HashMapGeneration *OrderedHashMap::getGeneration(
+    Handle<OrderedHashMap> self,
+    Runtime &runtime) {
+  if (!self->generation_) {
+    auto generation = HashMapGeneration::create(runtime);
+    self->generation_.setNonNull(runtime, generation.get(), runtime.getHeap());
   }
+  return self->generation_.getNonNull(runtime);
+}
 
-  // Make sure the entry we returned (if not nullptr) must not be deleted.
-  while (entry && entry->isDeleted()) {
-    entry = entry->nextIterationEntry.get(runtime);
+bool OrderedHashMap::iteratorNext(
+    Runtime &runtime,
+    HashMapGeneration *&generation,
+    uint32_t &index) const {
+  // Catch up with any compaction or clearing since the last step.
+  while (HashMapGeneration *next = generation->getNext(runtime)) {
+    index = generation->translateIndex(runtime, index);
+    generation = next;
   }
-  return entry;
+  assert(
+      generation == generation_.get(runtime) &&
+      "Iterating with a generation of another map");
+
+  // Skip over deleted entries.
+  const SegmentedArraySmall *entries = entries_.getNonNull(runtime);
+  for (; index < numEntries_; ++index) {
+    if (!entries->at(runtime, keySlot(index)).isEmpty())
+      return true;
+  }
+  return false;
 }
 
-void OrderedHashMap::clear(Runtime &runtime) {
-  if (!firstIterationEntry_) {
+void OrderedHashMap::clear(Handle<OrderedHashMap> self, Runtime &runtime) {
+  if (!self->numEntries_) {
     // Empty set.
     return;
   }
 
-  // Clear the hash table.
-  for (unsigned i = 0; i < capacity_; ++i) {
-    auto entry = castToMapEntry(hashTable_.getNonNull(runtime)->at(i), runtime);
-    // Delete every element reachable from the hash table.
-    while (entry) {
-      entry->markDeleted(runtime);
-      entry = entry->nextEntryInBucket.get(runtime);
-    }
-    // Clear every element in the hash table.
-    hashTable_.getNonNull(runtime)->setNonPtr(
-        i, SmallHermesValue::encodeEmptyValue(), runtime.getHeap());
-  }
-  // Resize the hash table to the initial size.
-  ArrayStorageSmall::resizeWithinCapacity(
-      hashTable_.getNonNull(runtime), runtime, INITIAL_CAPACITY);
-  capacity_ = INITIAL_CAPACITY;
-
-  // After clearing, we will still keep the last deleted entry
-  // in case there is an iterator out there
-  // pointing to the middle of the iteration chain. We need it to be
-  // able to merge back eventually.
-  firstIterationEntry_.set(runtime, lastIterationEntry_, runtime.getHeap());
-  firstIterationEntry_.getNonNull(runtime)->prevIterationEntry.setNull(
-      runtime.getHeap());
-  size_ = 0;
+  // Any iterator will resume from the beginning.
+  retireGeneration(
+      self, runtime, Runtime::makeNullHandle<SegmentedArraySmall>());
+  self->entries_.getNonNull(runtime)->clear(runtime);
+  self->freeIndex(runtime.getHeap());
+  self->numEntries_ = 0;
+  self->size_ = 0;
 }
 
 } // namespace vm
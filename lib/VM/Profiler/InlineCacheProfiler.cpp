@@ -44,27 +44,35 @@ bool InlineCacheProfiler::insertICMiss(
     uint32_t instOffset,
     SymbolID &propertyID,
     ClassId objectHiddenClassId,
-    ClassId cachedHiddenClassId) {
+    ClassId cachedHiddenClassId,
+    bool megamorphic) {
   ICMiss &icMiss = getICMissBySourceLocation(codeblock, instOffset);
   // record the hidden class pair for the source location
   auto hcPair =
       std::pair<ClassId, ClassId>(objectHiddenClassId, cachedHiddenClassId);
   auto icRecord =
       std::pair<PropertyId, HiddenClassPair>(propertyID.unsafeGetRaw(), hcPair);
-  icMiss.insertMiss(icRecord);
+  icMiss.insertMiss(icRecord, megamorphic);
 
   ++totalMisses_;
+  if (megamorphic) {
+    ++totalMegamorphicMisses_;
+  }
   return true;
 }
 
 bool InlineCacheProfiler::insertICHit(
     CodeBlock *codeblock,
-    uint32_t instOffset) {
+    uint32_t instOffset,
+    bool polymorphic) {
   // if not exist, create inline caching entry for the source location
   ICMiss &icMiss = getICMissBySourceLocation(codeblock, instOffset);
-  icMiss.incrementHit();
+  icMiss.incrementHit(polymorphic);
 
   ++totalHits_;
+  if (polymorphic) {
+    ++totalPolymorphicHits_;
+  }
   return true;
 }
 
@@ -176,7 +184,9 @@ void InlineCacheProfiler::dumpInfoOfSourceLocation(
            << (1. * icMiss.missCount) / (icMiss.missCount + icMiss.hitCount);
     std::string missRatio = stream.str();
     ostream << "total access: " << icMiss.missCount + icMiss.hitCount
-            << ", miss ratio: " << missRatio << "\n";
+            << ", miss ratio: " << missRatio
+            << ", polymorphic hits: " << icMiss.polymorphicHitCount
+            << ", megamorphic misses: " << icMiss.megamorphicCount << "\n";
   } else {
     ostream << "[No Loc]\n";
   }
@@ -188,7 +198,8 @@ void InlineCacheProfiler::dumpInfoOfSourceLocation(
 /// The source locations are ranked in the descending order of IC misses.
 ///
 /// An example of output for a specific source location is as follows:
-/// [filename:line:column] total access: 2661, miss ratio: 0.3
+/// [filename:line:column] total access: 2661, miss ratio: 0.3,
+///   polymorphic hits: 1024, megamorphic misses: 0
 ///  property: children, inline cache misses: 427
 ///    <type, domNamespace, children, childIndex, context, footer>
 ///    <domNamespace, type, children, childIndex, context, footer>
@@ -200,6 +211,11 @@ void InlineCacheProfiler::dumpInfoOfSourceLocation(
 void InlineCacheProfiler::dumpRankedInlineCachingMisses(
     Runtime &runtime,
     llvh::raw_ostream &ostream) {
+  ostream << "Inline caching totals: hits: " << totalHits_
+          << ", polymorphic hits: " << totalPolymorphicHits_
+          << ", misses: " << totalMisses_
+          << ", megamorphic misses: " << totalMegamorphicMisses_ << "\n\n";
+
   // rank the inline caching misses
   std::shared_ptr<InlineCacheProfiler::ICMissList> icInfoList =
       getRankedInlineCachingMisses();
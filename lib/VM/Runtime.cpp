@@ -256,6 +256,7 @@ Runtime::Runtime(
       hasES6Proxy_(runtimeConfig.getES6Proxy()),
       hasES6Class_(runtimeConfig.getES6Class()),
       hasIntl_(runtimeConfig.getIntl()),
+      regExpEngine_(runtimeConfig.getRegExpEngine()),
       hasArrayBuffer_(runtimeConfig.getArrayBuffer()),
       hasMicrotaskQueue_(runtimeConfig.getMicrotaskQueue()),
       shouldRandomizeMemoryLayout_(runtimeConfig.getRandomizeMemoryLayout()),
@@ -665,6 +666,8 @@ void Runtime::markWeakRoots(WeakRootAcceptor &acceptor, bool markLongLived) {
     for (auto &entry : fixedPropCache_) {
       acceptor.acceptWeak(entry.clazz);
     }
+    megamorphicReadPropCache_.markWeakRoots(acceptor);
+    megamorphicWritePropCache_.markWeakRoots(acceptor);
     for (auto &rm : runtimeModuleList_)
       rm.markLongLivedWeakRoots(acceptor);
   }
@@ -2154,17 +2157,26 @@ void Runtime::recordHiddenClass(
     const Inst *cacheMissInst,
     SymbolID symbolID,
     HiddenClass *objectHiddenClass,
-    HiddenClass *cachedHiddenClass) {
+    PropertyCacheEntry *cacheEntry) {
   auto offset = codeBlock->getOffsetOf(cacheMissInst);
+  CompressedPointer clazzPtr =
+      CompressedPointer::encodeNonNull(objectHiddenClass, *this);
 
-  // inline caching hit
-  if (objectHiddenClass == cachedHiddenClass) {
-    inlineCacheProfiler_.insertICHit(codeBlock, offset);
+  // inline caching hit, either in the inline entry or in one of the
+  // polymorphic entries.
+  if (cacheEntry->clazz == clazzPtr) {
+    inlineCacheProfiler_.insertICHit(codeBlock, offset, false);
+    return;
+  }
+  auto *polyCache = codeBlock->findPolymorphicCacheEntry(cacheEntry);
+  if (polyCache && polyCache->find(clazzPtr)) {
+    inlineCacheProfiler_.insertICHit(codeBlock, offset, true);
     return;
   }
 
   // inline caching miss
   assert(objectHiddenClass != nullptr && "object hidden class should exist");
+  HiddenClass *cachedHiddenClass = cacheEntry->clazz.get(*this, getHeap());
   // prevent object hidden class from being GC-ed
   preventHCGC(objectHiddenClass);
   ClassId objectHiddenClassId = getHeap().getObjectID(objectHiddenClass);
@@ -2177,7 +2189,12 @@ void Runtime::recordHiddenClass(
   }
   // add the record to inline caching profiler
   inlineCacheProfiler_.insertICMiss(
-      codeBlock, offset, symbolID, objectHiddenClassId, cachedHiddenClassId);
+      codeBlock,
+      offset,
+      symbolID,
+      objectHiddenClassId,
+      cachedHiddenClassId,
+      polyCache && polyCache->megamorphic);
 }
 
 void Runtime::getInlineCacheProfilerInfo(llvh::raw_ostream &ostream) {
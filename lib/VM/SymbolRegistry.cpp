@@ -31,10 +31,10 @@ void SymbolRegistry::markRoots(RootAcceptor &acceptor) {
 CallResult<SymbolID> SymbolRegistry::getSymbolForKey(
     Runtime &runtime,
     Handle<StringPrimitive> key) {
-  HashMapEntry *it = OrderedHashMap::find(
+  HermesValue existing = OrderedHashMap::get(
       Handle<OrderedHashMap>::vmcast(&stringMap_), runtime, key);
-  if (it) {
-    return it->value.getSymbol();
+  if (existing.isSymbol()) {
+    return existing.getSymbol();
   }
 
   auto symbolRes =
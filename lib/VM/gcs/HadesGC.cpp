@@ -19,6 +19,7 @@
 #include "hermes/VM/SmallHermesValue-inline.h"
 
 #include <array>
+#include <chrono>
 #include <functional>
 #include <stack>
 
@@ -402,11 +403,18 @@ template <bool CompactionEnabled>
 class HadesGC::EvacAcceptor final : public RootAndSlotAcceptor,
                                     public WeakRootAcceptor {
  public:
-  EvacAcceptor(HadesGC &gc)
+  /// \param parallel If set, this is one of several acceptors evacuating the
+  ///   YG at the same time for \p parallel.
+  EvacAcceptor(HadesGC &gc, ParallelEvacuator *parallel = nullptr)
       : gc{gc},
         pointerBase_{gc.getPointerBase()},
         copyListHead_{nullptr},
-        isTrackingIDs_{gc.isTrackingIDs()} {}
+        isTrackingIDs_{gc.isTrackingIDs()},
+        parallel_{parallel} {
+    assert(
+        !(parallel && isTrackingIDs_) &&
+        "Object IDs cannot be tracked by several threads");
+  }
 
   ~EvacAcceptor() override {}
 
@@ -464,6 +472,8 @@ class HadesGC::EvacAcceptor final : public RootAndSlotAcceptor,
   LLVM_NODISCARD T forwardCell(GCCell *const cell) {
     assert(
         HeapSegment::getCellMarkBit(cell) && "Cannot forward unmarked object");
+    if (parallel_)
+      return forwardCellParallel<T>(cell);
     if (cell->hasMarkedForwardingPointer()) {
       // Get the forwarding pointer from the header of the object.
       CompressedPointer forwardedCell = cell->getMarkedForwardingPointer();
@@ -497,6 +507,41 @@ class HadesGC::EvacAcceptor final : public RootAndSlotAcceptor,
     return convertPtr<T>(pointerBase_, newCell);
   }
 
+  /// Like forwardCell, but for when other workers may be forwarding \p cell at
+  /// the same time. The copy is scanned later from localWorklist_, rather than
+  /// from the copy list, so that the old cell is never written except for its
+  /// header.
+  template <typename T>
+  LLVM_NODISCARD T forwardCellParallel(GCCell *const cell) {
+    KindAndSize kindAndSize;
+    if (const CompressedPointer forwardedCell =
+            cell->loadHeaderAtomic(kindAndSize))
+      return convertPtr<T>(pointerBase_, forwardedCell);
+    const uint32_t cellSize = kindAndSize.getSize();
+    GCCell *const newCell = allocPromoted(cellSize);
+    // Copy everything but the header, which may be replaced by a forwarding
+    // pointer at any point, and then write the header that was read above.
+    std::memcpy(
+        reinterpret_cast<char *>(newCell) + sizeof(KindAndSize),
+        reinterpret_cast<const char *>(cell) + sizeof(KindAndSize),
+        cellSize - sizeof(KindAndSize));
+    newCell->setKindAndSize(kindAndSize);
+    const CompressedPointer newCellCP =
+        CompressedPointer::encodeNonNull(newCell, pointerBase_);
+    const CompressedPointer forwardedCell =
+        cell->casMarkedForwardingPointer(kindAndSize, newCellCP);
+    if (forwardedCell != newCellCP) {
+      // Another worker copied the cell first, so use its copy instead.
+      undoPromotion(newCell, cellSize);
+      return convertPtr<T>(pointerBase_, forwardedCell);
+    }
+    assert(newCell->isValid() && "Cell was copied incorrectly");
+    evacuatedBytes_ += cellSize;
+    promoted_.push_back(newCell);
+    localWorklist_.push(newCell);
+    return convertPtr<T>(pointerBase_, newCell);
+  }
+
   void accept(GCCell *&ptr) override {
     ptr = acceptRoot(ptr);
   }
@@ -560,6 +605,12 @@ class HadesGC::EvacAcceptor final : public RootAndSlotAcceptor,
     return evacuatedBytes_;
   }
 
+  /// Set the mark bits of the cells copied by forwardCellParallel, and give
+  /// back the unused part of the promotion buffer. This must wait until all
+  /// the workers are done, since the mark bits of cells next to each other
+  /// share a word, which the OG allocator writes without synchronization.
+  void finishPromotion();
+
   CopyListCell *pop() {
     if (!copyListHead_) {
       return nullptr;
@@ -580,10 +631,40 @@ class HadesGC::EvacAcceptor final : public RootAndSlotAcceptor,
   const bool isTrackingIDs_;
   uint64_t evacuatedBytes_{0};
 
+  friend class HadesGC::ParallelEvacuator;
+
+  /// The evacuation this acceptor is part of, if it evacuates in parallel.
+  ParallelEvacuator *const parallel_;
+
+  /// Cells copied by forwardCellParallel that still have to be scanned.
+  std::stack<GCCell *, std::vector<GCCell *>> localWorklist_;
+
+  /// Cells copied by forwardCellParallel, whose mark bits are set by
+  /// finishPromotion().
+  std::vector<GCCell *> promoted_;
+
+  /// The promotion buffer, a region of the OG that only this acceptor copies
+  /// cells into. The space in [promotionLevel_, promotionEnd_) is unused.
+  char *promotionStart_{nullptr};
+  char *promotionLevel_{nullptr};
+  char *promotionEnd_{nullptr};
+
   void push(CopyListCell *cell) {
     cell->next_ = copyListHead_;
     copyListHead_ = CompressedPointer::encodeNonNull(cell, pointerBase_);
   }
+
+  /// Allocate \p sz bytes in the OG for forwardCellParallel to copy a cell
+  /// into, from the promotion buffer if it fits.
+  GCCell *allocPromoted(uint32_t sz);
+
+  /// Undo the allocation of the \p sz bytes at \p cell, which was the last one
+  /// made by allocPromoted.
+  void undoPromotion(GCCell *cell, uint32_t sz);
+
+  /// Give back the unused part of the promotion buffer, and start a new one on
+  /// the next allocation.
+  void retirePromotionBuffer();
 };
 
 class MarkWorklist {
@@ -694,13 +775,288 @@ class MarkWorklist {
   llvh::SmallVector<GCCell *, 0> worklist_;
 };
 
+/// A fixed set of helper threads that the thread holding gcMutex_ can use to
+/// run parts of a collection in parallel with itself.
+class HadesGC::WorkerPool {
+ public:
+  explicit WorkerPool(unsigned numHelpers);
+  ~WorkerPool();
+
+  unsigned numHelpers() const {
+    return threads_.size();
+  }
+
+  /// Call \p fn with every worker index in [0, numWorkers), and return once
+  /// all of the calls have returned. Index 0 runs on the calling thread, and
+  /// the rest run on the helper threads.
+  /// \pre numWorkers is at most numHelpers() + 1.
+  void run(llvh::function_ref<void(unsigned)> fn, unsigned numWorkers);
+
+#ifndef NDEBUG
+  /// \return true if the current thread is one of the helper threads.
+  bool isHelperThread() const;
+
+  /// \return the thread that called run() most recently.
+  std::thread::id callerThreadId() const {
+    return callerThreadId_;
+  }
+#endif
+
+ private:
+  /// Wait for tasks, and run them as the worker with index \p idx.
+  void helperMain(unsigned idx);
+
+  std::mutex mtx_;
+  /// Notified when a task is started, or the helpers should shut down.
+  std::condition_variable taskCV_;
+  /// Notified when a helper has finished the current task.
+  std::condition_variable doneCV_;
+  /// The current task. Only valid while run() is executing.
+  llvh::function_ref<void(unsigned)> *task_{nullptr};
+  /// The number of workers that run the current task.
+  unsigned numTaskWorkers_{0};
+  /// Incremented every time a task is started.
+  uint64_t numTasks_{0};
+  /// The number of helpers that have finished the current task.
+  unsigned numFinished_{0};
+  bool shutdown_{false};
+#ifndef NDEBUG
+  /// The thread that called run() most recently.
+  std::thread::id callerThreadId_;
+#endif
+
+  std::vector<std::thread> threads_;
+};
+
+/// Lets the workers in a WorkerPool share the cells they still have to scan.
+/// Every worker scans cells from its own local worklist. When a worker runs out
+/// of work it waits on the shared pool, and workers that still have work
+/// publish part of their local worklist to the pool for it to steal. The work
+/// is complete once every worker is waiting and the pool is empty.
+class HadesGC::SharedWorklist {
+ public:
+  using LocalWorklist = std::stack<GCCell *, std::vector<GCCell *>>;
+
+  /// Prepare for \p numWorkers workers to start sharing work.
+  /// \pre No work is left in the pool.
+  void reset(unsigned numWorkers);
+
+  /// \return true if some worker is waiting for work and the pool is empty.
+  /// Busy workers check this without taking a lock to decide when to publish.
+  bool hungry() const {
+    return hungry_.load(std::memory_order_relaxed);
+  }
+
+  /// \return true if a worker called stop().
+  bool stopped() const {
+    return stopped_.load(std::memory_order_relaxed);
+  }
+
+  /// Move up to half of \p local to the pool.
+  void publish(LocalWorklist &local);
+
+  /// Move up to kChunkSize cells from the pool into \p local, waiting for one
+  /// to be published if the pool is empty.
+  /// \return false if there is no more work, or the work was stopped.
+  bool steal(LocalWorklist &local);
+
+  /// Make every worker stop before all work is done, and move everything in
+  /// \p local to the pool.
+  void stop(LocalWorklist &local);
+
+  /// Move everything left in the pool after a stop() into \p local.
+  void takeAll(LocalWorklist &local);
+
+ private:
+  /// The largest number of cells moved between a local worklist and the pool
+  /// at once.
+  static constexpr size_t kChunkSize = 128;
+
+  /// Keep hungry_ in sync with the pool and the number of idle workers.
+  /// \pre mtx_ is held.
+  void updateHungry() {
+    hungry_.store(numIdle_ && pool_.empty(), std::memory_order_relaxed);
+  }
+
+  std::mutex mtx_;
+  /// Notified when cells are added to pool_, or the work ends.
+  std::condition_variable workCV_;
+  /// Cells that still need to be scanned, available to any worker.
+  std::vector<GCCell *> pool_;
+  unsigned numWorkers_{0};
+  /// The number of workers that are waiting for work.
+  unsigned numIdle_{0};
+  /// True once every worker ran out of work.
+  bool done_{false};
+
+  std::atomic<bool> hungry_{false};
+  std::atomic<bool> stopped_{false};
+};
+
+/// Evacuates the YG, and the compactee if there is one, using the WorkerPool.
+///
+/// This runs in two phases. First the workers split up the OG segments, and
+/// record the slots in their dirty cards that point into the YG or compactee.
+/// Then the workers update those slots and the roots, by copying the cells
+/// they point to, and scan the copies in turn. The copies that still have to
+/// be scanned are shared through a SharedWorklist. Recording the slots first
+/// means that no worker walks the cells of a segment while another is copying
+/// cells into it.
+///
+/// Each worker copies cells into its own promotion buffer, a region of the OG
+/// that only it allocates from, so that the workers only take a lock to get a
+/// new buffer. Several workers may find the same cell, so its forwarding
+/// pointer is set with a CAS, and the workers that lose the race give back the
+/// space they copied it into.
+class HadesGC::ParallelEvacuator {
+ public:
+  /// The size of a promotion buffer. Cells larger than a quarter of this are
+  /// allocated on their own, so that they don't waste much of a buffer.
+  static constexpr uint32_t kPromotionBufferSize = 32 * 1024;
+
+  ParallelEvacuator(HadesGC &gc, WorkerPool &pool, unsigned numHelpers)
+      : gc_{gc},
+        pool_{pool},
+        numHelpers_{numHelpers},
+        dirtySlots_(numHelpers + 1) {}
+
+  /// Evacuate the YG, and the compactee if \p doCompaction is true, and update
+  /// every pointer to them.
+  /// \return the number of bytes that were evacuated.
+  template <bool CompactionEnabled>
+  uint64_t evacuate(bool doCompaction);
+
+  /// Allocate \p sz bytes in the OG for one of the workers.
+  GCCell *alloc(uint32_t sz) {
+    std::lock_guard<std::mutex> lk{allocMtx_};
+    return gc_.oldGen_.alloc(sz);
+  }
+
+  /// Give back the \p sz bytes at \p addr, which are the unused end of a
+  /// region returned by alloc().
+  void freeUnusedBytes(void *addr, uint32_t sz) {
+    std::lock_guard<std::mutex> lk{allocMtx_};
+    gc_.oldGen_.freeUnusedBytes(addr, sz);
+  }
+
+ private:
+  /// A slot in a dirty card that points into the YG or compactee.
+  struct DirtySlot {
+    enum class Kind : uint8_t { Pointer, HermesValue, SmallHermesValue };
+    void *loc;
+    Kind kind;
+  };
+
+  template <bool CompactionEnabled>
+  class DirtySlotRecorder;
+
+  /// The number of dirty slots a worker claims at once.
+  static constexpr size_t kDirtySlotChunkSize = 256;
+
+  /// Update the dirty slots with indices in [begin, end) using \p acceptor.
+  /// The indices span the dirty slots of all of the workers.
+  template <bool CompactionEnabled>
+  void evacuateDirtySlots(
+      EvacAcceptor<CompactionEnabled> &acceptor,
+      size_t begin,
+      size_t end);
+
+  /// Evacuate using \p acceptor until there are no dirty slots left to claim,
+  /// and no copied cells left to scan.
+  template <bool CompactionEnabled>
+  void work(EvacAcceptor<CompactionEnabled> &acceptor, size_t numDirtySlots);
+
+  HadesGC &gc_;
+  WorkerPool &pool_;
+  const unsigned numHelpers_;
+
+  /// Serializes allocation in the OG by the workers.
+  std::mutex allocMtx_;
+
+  SharedWorklist worklist_;
+
+  /// The dirty slots recorded by each worker in the first phase.
+  std::vector<std::vector<DirtySlot>> dirtySlots_;
+
+  /// The index of the first slot of each entry of dirtySlots_, when the slots
+  /// of all of the workers are numbered one after the other.
+  std::vector<size_t> dirtySlotOffsets_;
+
+  /// The index of the next segment to scan in the first phase.
+  std::atomic<size_t> nextSegment_{0};
+
+  /// The index of the next dirty slot to update in the second phase.
+  std::atomic<size_t> nextDirtySlot_{0};
+};
+
+/// Drains the local worklist of oldGenMarker_ (the owner) in parallel, using
+/// the WorkerPool and a MarkAcceptor per helper.
+///
+/// A round of marking ends once all reachable cells have been scanned, or
+/// early if the round's byte budget is used up or the mutator asked for
+/// gcMutex_ by setting ogPaused_. The owner holds gcMutex_ for the whole
+/// round, so to the rest of the GC the helpers look like part of the thread
+/// holding the lock. Write barriers keep feeding the global worklist of the
+/// owner, which it drains at the start of every round as before.
+class HadesGC::ParallelMarker {
+ public:
+  ParallelMarker(HadesGC &gc, WorkerPool &pool, unsigned numHelpers)
+      : gc_{gc},
+        pool_{pool},
+        numHelpers_{numHelpers},
+        markTimes_(numHelpers + 1) {}
+
+  unsigned numHelpers() const {
+    return numHelpers_;
+  }
+
+  /// Drain the local worklist of \p owner together with the helpers, until
+  /// there is no work left or about \p markLimit bytes have been marked. Any
+  /// work not completed is put back on the local worklist of \p owner.
+  void drain(MarkAcceptor &owner, size_t markLimit);
+
+  /// \return the time in seconds each marker has spent marking, not counting
+  /// time spent waiting for work. The owner comes first, then the helpers.
+  llvh::ArrayRef<double> markTimes() const {
+    return markTimes_;
+  }
+
+ private:
+  /// How many bytes a marker may mark before charging them to the budget.
+  static constexpr int64_t kBudgetBatchBytes = 16 * 1024;
+
+  /// Mark using \p marker until the round ends.
+  /// \return the time spent marking, in seconds.
+  double work(MarkAcceptor &marker);
+
+  HadesGC &gc_;
+  WorkerPool &pool_;
+  const unsigned numHelpers_;
+  SharedWorklist worklist_;
+
+  /// The number of bytes left to mark in this round.
+  std::atomic<int64_t> budget_{0};
+
+  /// See markTimes(). Each worker only updates its own entry.
+  std::vector<double> markTimes_;
+};
+
 class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor {
  public:
-  MarkAcceptor(HadesGC &gc)
+  /// \param isHelper true if this marks on behalf of a parallel marker helper
+  ///   thread, rather than being oldGenMarker_ itself.
+  MarkAcceptor(HadesGC &gc, bool isHelper = false)
       : gc{gc},
         pointerBase_{gc.getPointerBase()},
         markedSymbols_{gc.gcCallbacks_.getSymbolsEnd()},
-        writeBarrierMarkedSymbols_{gc.gcCallbacks_.getSymbolsEnd()} {}
+        writeBarrierMarkedSymbols_{
+            isHelper ? 0 : gc.gcCallbacks_.getSymbolsEnd()},
+        parallel_{gc.parallelMarker_ != nullptr} {
+    if (parallel_ && !isHelper) {
+      for (unsigned i = 0, e = gc.parallelMarker_->numHelpers(); i < e; ++i)
+        helpers_.emplace_back(new MarkAcceptor{gc, /*isHelper*/ true});
+    }
+  }
 
   void acceptHeap(GCCell *cell, const void *heapLoc) {
     assert(cell && "Cannot pass null pointer to acceptHeap");
@@ -832,6 +1188,11 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor {
     // See the comment in setDrainRate for why the drain rate isn't used for
     // concurrent collections.
     constexpr size_t kConcurrentMarkLimit = 8192;
+    // A parallel round stops as soon as the mutator asks for gcMutex_, so it
+    // can use a larger limit to amortize the cost of waking the helpers.
+    constexpr size_t kParallelMarkLimitPerThread = kConcurrentMarkLimit * 32;
+    if (!helpers_.empty())
+      return drainSomeWork(kParallelMarkLimitPerThread * (helpers_.size() + 1));
     return drainSomeWork(kConcurrentGC ? kConcurrentMarkLimit : byteDrainRate_);
   }
 
@@ -861,8 +1222,13 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor {
       }
     }
 
-    size_t numMarkedBytes = 0;
     assert(markLimit && "markLimit must be non-zero!");
+    if (!helpers_.empty()) {
+      gc.parallelMarker_->drain(*this, markLimit);
+      return !localWorklist_.empty();
+    }
+
+    size_t numMarkedBytes = 0;
     while (!localWorklist_.empty() && numMarkedBytes < markLimit) {
       GCCell *const cell = localWorklist_.top();
       localWorklist_.pop();
@@ -897,12 +1263,16 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor {
   llvh::BitVector &markedSymbols() {
     assert(gc.gcMutex_ && "Cannot call markedSymbols without a lock");
     markedSymbols_ |= writeBarrierMarkedSymbols_;
+    for (const auto &helper : helpers_)
+      markedSymbols_ |= helper->markedSymbols_;
     // No need to clear writeBarrierMarkedSymbols_, or'ing it again won't change
     // the bit vector.
     return markedSymbols_;
   }
 
  private:
+  friend class HadesGC::ParallelMarker;
+
   HadesGC &gc;
   PointerBase &pointerBase_;
 
@@ -938,14 +1308,28 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor {
   /// The number of bytes that have been marked so far.
   uint64_t markedBytes_{0};
 
+  /// True if marking may run on several threads at once, see ParallelMarker.
+  const bool parallel_;
+
+  /// The acceptors used by the parallel marker's helper threads. Only
+  /// oldGenMarker_ has helpers, and they are only used from \c drainSomeWork.
+  std::vector<std::unique_ptr<MarkAcceptor>> helpers_;
+
   void push(GCCell *cell) {
-    assert(
-        !HeapSegment::getCellMarkBit(cell) &&
-        "A marked object should never be pushed onto a worklist");
     assert(
         !gc.inYoungGen(cell) &&
         "Shouldn't ever push a YG object onto the worklist");
-    HeapSegment::setCellMarkBit(cell);
+    if (parallel_) {
+      // Another marker may have marked the cell since the caller checked its
+      // mark bit. Only the one that actually sets the bit pushes the cell.
+      if (HeapSegment::testAndSetCellMarkBit(cell))
+        return;
+    } else {
+      assert(
+          !HeapSegment::getCellMarkBit(cell) &&
+          "A marked object should never be pushed onto a worklist");
+      HeapSegment::setCellMarkBit(cell);
+    }
     // There could be a race here: however, the mutator will never change a
     // cell's kind after initialization. The GC thread might to a free cell, but
     // only during sweeping, not concurrently with this operation. Therefore
@@ -1002,6 +1386,438 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor {
   }
 };
 
+HadesGC::WorkerPool::WorkerPool(unsigned numHelpers) {
+  for (unsigned i = 0; i < numHelpers; ++i)
+    threads_.emplace_back([this, i] { helperMain(i + 1); });
+}
+
+HadesGC::WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lk{mtx_};
+    shutdown_ = true;
+  }
+  taskCV_.notify_all();
+  for (std::thread &thread : threads_)
+    thread.join();
+}
+
+#ifndef NDEBUG
+bool HadesGC::WorkerPool::isHelperThread() const {
+  const auto id = std::this_thread::get_id();
+  for (const std::thread &thread : threads_)
+    if (thread.get_id() == id)
+      return true;
+  return false;
+}
+#endif
+
+void HadesGC::WorkerPool::run(
+    llvh::function_ref<void(unsigned)> fn,
+    unsigned numWorkers) {
+  assert(numWorkers && numWorkers <= numHelpers() + 1 && "Too many workers");
+  {
+    std::lock_guard<std::mutex> lk{mtx_};
+    task_ = &fn;
+    numTaskWorkers_ = numWorkers;
+#ifndef NDEBUG
+    callerThreadId_ = std::this_thread::get_id();
+#endif
+    numFinished_ = 0;
+    ++numTasks_;
+  }
+  taskCV_.notify_all();
+  fn(0);
+  std::unique_lock<std::mutex> lk{mtx_};
+  doneCV_.wait(lk, [this] { return numFinished_ == numHelpers(); });
+  task_ = nullptr;
+}
+
+void HadesGC::WorkerPool::helperMain(unsigned idx) {
+  oscompat::set_thread_name("hades-worker");
+  std::unique_lock<std::mutex> lk{mtx_};
+  // Start from 0 rather than numTasks_, so that a helper that starts up late
+  // still takes part in the first task.
+  uint64_t lastTask = 0;
+  while (true) {
+    taskCV_.wait(
+        lk, [this, lastTask] { return shutdown_ || numTasks_ != lastTask; });
+    if (shutdown_)
+      return;
+    lastTask = numTasks_;
+    if (idx < numTaskWorkers_) {
+      auto &task = *task_;
+      lk.unlock();
+      task(idx);
+      lk.lock();
+    }
+    if (++numFinished_ == numHelpers())
+      doneCV_.notify_one();
+  }
+}
+
+void HadesGC::SharedWorklist::reset(unsigned numWorkers) {
+  std::lock_guard<std::mutex> lk{mtx_};
+  assert(pool_.empty() && "Work left over from a previous use");
+  numWorkers_ = numWorkers;
+  numIdle_ = 0;
+  done_ = false;
+  hungry_.store(false, std::memory_order_relaxed);
+  stopped_.store(false, std::memory_order_relaxed);
+}
+
+void HadesGC::SharedWorklist::publish(LocalWorklist &local) {
+  std::lock_guard<std::mutex> lk{mtx_};
+  for (size_t i = 0, e = std::min(kChunkSize, local.size() / 2); i < e; ++i) {
+    pool_.push_back(local.top());
+    local.pop();
+  }
+  updateHungry();
+  workCV_.notify_all();
+}
+
+bool HadesGC::SharedWorklist::steal(LocalWorklist &local) {
+  std::unique_lock<std::mutex> lk{mtx_};
+  ++numIdle_;
+  while (true) {
+    if (stopped() || done_)
+      return false;
+    if (!pool_.empty()) {
+      for (size_t i = 0, e = std::min(kChunkSize, pool_.size()); i < e; ++i) {
+        local.push(pool_.back());
+        pool_.pop_back();
+      }
+      --numIdle_;
+      updateHungry();
+      return true;
+    }
+    if (numIdle_ == numWorkers_) {
+      // Nobody has any local work left, so nothing more can be published.
+      done_ = true;
+      workCV_.notify_all();
+      return false;
+    }
+    updateHungry();
+    workCV_.wait(lk);
+  }
+}
+
+void HadesGC::SharedWorklist::stop(LocalWorklist &local) {
+  std::lock_guard<std::mutex> lk{mtx_};
+  for (; !local.empty(); local.pop())
+    pool_.push_back(local.top());
+  stopped_.store(true, std::memory_order_relaxed);
+  workCV_.notify_all();
+}
+
+void HadesGC::SharedWorklist::takeAll(LocalWorklist &local) {
+  std::lock_guard<std::mutex> lk{mtx_};
+  for (GCCell *cell : pool_)
+    local.push(cell);
+  pool_.clear();
+}
+
+void HadesGC::ParallelMarker::drain(MarkAcceptor &owner, size_t markLimit) {
+  assert(gc_.gcMutex_ && "Must hold the GC lock while accessing mark bits.");
+  assert(
+      owner.helpers_.size() == numHelpers() &&
+      "Owner must have an acceptor for each helper");
+  worklist_.reset(numHelpers() + 1);
+  budget_.store(
+      std::min<size_t>(markLimit, std::numeric_limits<int64_t>::max()),
+      std::memory_order_relaxed);
+  pool_.run(
+      [this, &owner](unsigned idx) {
+        MarkAcceptor &marker = idx ? *owner.helpers_[idx - 1] : owner;
+        markTimes_[idx] += work(marker);
+      },
+      numHelpers() + 1);
+  // If the round stopped early, hand the remaining work back to the owner so
+  // the next round picks it up.
+  worklist_.takeAll(owner.localWorklist_);
+  for (const auto &helper : owner.helpers_) {
+    owner.markedBytes_ += helper->markedBytes_;
+    helper->markedBytes_ = 0;
+  }
+}
+
+double HadesGC::ParallelMarker::work(MarkAcceptor &marker) {
+  using Clock = std::chrono::steady_clock;
+  Clock::duration busy{};
+  auto busyStart = Clock::now();
+  // Bytes marked but not yet charged to the budget.
+  int64_t unchargedBytes = 0;
+  auto &local = marker.localWorklist_;
+  while (true) {
+    while (!local.empty()) {
+      if (worklist_.stopped() ||
+          gc_.ogPaused_.load(std::memory_order_relaxed)) {
+        worklist_.stop(local);
+        break;
+      }
+      if (worklist_.hungry() && local.size() > 1)
+        worklist_.publish(local);
+      GCCell *const cell = local.top();
+      local.pop();
+      assert(cell->isValid() && "Invalid cell in marking");
+      assert(HeapSegment::getCellMarkBit(cell) && "Discovered unmarked object");
+      assert(
+          !gc_.inYoungGen(cell) &&
+          "Shouldn't ever traverse a YG object in this loop");
+      HERMES_SLOW_ASSERT(
+          gc_.dbgContains(cell) && "Non-heap object discovered during marking");
+      const auto sz = cell->getAllocatedSize();
+      marker.markedBytes_ += sz;
+      unchargedBytes += sz;
+      gc_.markCell(cell, marker);
+      if (unchargedBytes >= kBudgetBatchBytes) {
+        const int64_t budgetLeft =
+            budget_.fetch_sub(unchargedBytes, std::memory_order_relaxed) -
+            unchargedBytes;
+        unchargedBytes = 0;
+        if (budgetLeft <= 0) {
+          worklist_.stop(local);
+          break;
+        }
+      }
+    }
+    busy += Clock::now() - busyStart;
+    if (!worklist_.steal(local))
+      break;
+    busyStart = Clock::now();
+  }
+  budget_.fetch_sub(unchargedBytes, std::memory_order_relaxed);
+  return std::chrono::duration<double>(busy).count();
+}
+
+/// Records the slots in dirty cards that ParallelEvacuator has to update,
+/// without changing them. Like EvacAcceptor, it dirties the cards of slots
+/// that point into a compactee that is still being prepared.
+template <bool CompactionEnabled>
+class HadesGC::ParallelEvacuator::DirtySlotRecorder final
+    : public SlotAcceptor {
+ public:
+  DirtySlotRecorder(HadesGC &gc, std::vector<DirtySlot> &slots)
+      : gc_{gc}, slots_{slots} {}
+
+  void accept(GCPointerBase &ptr) override {
+    record(CompressedPointer{ptr}, &ptr, DirtySlot::Kind::Pointer);
+  }
+
+  void accept(GCHermesValue &hv) override {
+    if (hv.isPointer())
+      record(
+          static_cast<GCCell *>(hv.getPointer()),
+          &hv,
+          DirtySlot::Kind::HermesValue);
+  }
+
+  void accept(GCSmallHermesValue &hv) override {
+    if (hv.isPointer())
+      record(hv.getPointer(), &hv, DirtySlot::Kind::SmallHermesValue);
+  }
+
+  void accept(const GCSymbolID &sym) override {}
+
+ private:
+  HadesGC &gc_;
+  std::vector<DirtySlot> &slots_;
+
+  template <typename Ptr>
+  void record(Ptr ptr, void *heapLoc, typename DirtySlot::Kind kind) {
+    if (gc_.inYoungGen(ptr) ||
+        (CompactionEnabled && gc_.compactee_.evacContains(ptr))) {
+      slots_.push_back({heapLoc, kind});
+    } else if (CompactionEnabled && gc_.compactee_.contains(ptr)) {
+      HeapSegment::cardTableCovering(heapLoc)->dirtyCardForAddress(heapLoc);
+    }
+  }
+};
+
+template <bool CompactionEnabled>
+uint64_t HadesGC::ParallelEvacuator::evacuate(bool doCompaction) {
+  assert(gc_.gcMutex_ && "Must hold the GC lock during a YG collection");
+  const unsigned numWorkers = numHelpers_ + 1;
+
+  // Find the dirty slots. As in scanDirtyCards, the compactee is only scanned
+  // while a compaction is being prepared, and the cards are only cleared
+  // otherwise.
+  const bool preparingCompaction =
+      CompactionEnabled && !gc_.compactee_.evacActive();
+  const size_t numSegments = gc_.oldGen_.numSegments();
+  const size_t numSegmentsToScan =
+      numSegments + (preparingCompaction ? 1 : 0);
+  nextSegment_.store(0, std::memory_order_relaxed);
+  pool_.run(
+      [this, numSegments, numSegmentsToScan, preparingCompaction](
+          unsigned idx) {
+        DirtySlotRecorder<CompactionEnabled> recorder{gc_, dirtySlots_[idx]};
+        SlotVisitor<DirtySlotRecorder<CompactionEnabled>> visitor{recorder};
+        for (size_t i;
+             (i = nextSegment_.fetch_add(1, std::memory_order_relaxed)) <
+             numSegmentsToScan;) {
+          HeapSegment &seg =
+              i < numSegments ? gc_.oldGen_[i] : *gc_.compactee_.segment;
+          gc_.scanDirtyCardsForSegment(visitor, seg);
+          if (!preparingCompaction)
+            seg.cardTable().clear();
+        }
+      },
+      numWorkers);
+
+  dirtySlotOffsets_.clear();
+  size_t numDirtySlots = 0;
+  for (const auto &slots : dirtySlots_) {
+    dirtySlotOffsets_.push_back(numDirtySlots);
+    numDirtySlots += slots.size();
+  }
+  nextDirtySlot_.store(0, std::memory_order_relaxed);
+
+  // Evacuate everything reachable from the roots and the dirty slots.
+  std::vector<std::unique_ptr<EvacAcceptor<CompactionEnabled>>> acceptors;
+  for (unsigned i = 0; i < numWorkers; ++i)
+    acceptors.push_back(
+        std::make_unique<EvacAcceptor<CompactionEnabled>>(gc_, this));
+  worklist_.reset(numWorkers);
+  pool_.run(
+      [this, &acceptors, numDirtySlots, doCompaction](unsigned idx) {
+        EvacAcceptor<CompactionEnabled> &acceptor = *acceptors[idx];
+        // Only the thread running the collection may visit the roots.
+        if (idx == 0)
+          gc_.youngGenEvacuateRoots(acceptor, doCompaction);
+        work(acceptor, numDirtySlots);
+      },
+      numWorkers);
+
+  uint64_t evacuatedBytes = 0;
+  for (const auto &acceptor : acceptors) {
+    acceptor->finishPromotion();
+    evacuatedBytes += acceptor->evacuatedBytes();
+  }
+  for (auto &slots : dirtySlots_)
+    slots.clear();
+
+  // We only need to update the long lived weak roots if we are evacuating part
+  // of the OG.
+  gc_.markWeakRoots(*acceptors[0], /*markLongLived*/ doCompaction);
+  return evacuatedBytes;
+}
+
+template <bool CompactionEnabled>
+void HadesGC::ParallelEvacuator::evacuateDirtySlots(
+    EvacAcceptor<CompactionEnabled> &acceptor,
+    size_t begin,
+    size_t end) {
+  // Find the worker whose slots contain begin.
+  size_t worker = std::upper_bound(
+                      dirtySlotOffsets_.begin(),
+                      dirtySlotOffsets_.end(),
+                      begin) -
+      dirtySlotOffsets_.begin() - 1;
+  for (size_t i = begin; i < end; ++i) {
+    while (i - dirtySlotOffsets_[worker] >= dirtySlots_[worker].size())
+      ++worker;
+    const DirtySlot &slot = dirtySlots_[worker][i - dirtySlotOffsets_[worker]];
+    switch (slot.kind) {
+      case DirtySlot::Kind::Pointer:
+        acceptor.accept(*static_cast<GCPointerBase *>(slot.loc));
+        break;
+      case DirtySlot::Kind::HermesValue:
+        acceptor.accept(*static_cast<GCHermesValue *>(slot.loc));
+        break;
+      case DirtySlot::Kind::SmallHermesValue:
+        acceptor.accept(*static_cast<GCSmallHermesValue *>(slot.loc));
+        break;
+    }
+  }
+}
+
+template <bool CompactionEnabled>
+void HadesGC::ParallelEvacuator::work(
+    EvacAcceptor<CompactionEnabled> &acceptor,
+    size_t numDirtySlots) {
+  auto &local = acceptor.localWorklist_;
+  while (true) {
+    while (!local.empty()) {
+      if (worklist_.hungry() && local.size() > 1)
+        worklist_.publish(local);
+      GCCell *const cell = local.top();
+      local.pop();
+      assert(cell->isValid() && "Invalid cell in evacuation");
+      gc_.markCell(cell, acceptor);
+    }
+    const size_t begin = nextDirtySlot_.fetch_add(
+        kDirtySlotChunkSize, std::memory_order_relaxed);
+    if (begin < numDirtySlots) {
+      evacuateDirtySlots(
+          acceptor,
+          begin,
+          std::min(begin + kDirtySlotChunkSize, numDirtySlots));
+      continue;
+    }
+    if (!worklist_.steal(local))
+      return;
+  }
+}
+
+template <bool CompactionEnabled>
+GCCell *HadesGC::EvacAcceptor<CompactionEnabled>::allocPromoted(uint32_t sz) {
+  // Keep the unused part of the buffer either empty, or large enough to be
+  // turned into a free cell.
+  const size_t unused = promotionEnd_ - promotionLevel_;
+  if (LLVM_LIKELY(sz == unused || sz + minAllocationSize() <= unused)) {
+    auto *cell = reinterpret_cast<GCCell *>(promotionLevel_);
+    promotionLevel_ += sz;
+    HeapSegment::setCellHead(cell, sz);
+    return cell;
+  }
+  if (sz > ParallelEvacuator::kPromotionBufferSize / 4)
+    return parallel_->alloc(sz);
+  retirePromotionBuffer();
+  promotionStart_ = reinterpret_cast<char *>(
+      parallel_->alloc(ParallelEvacuator::kPromotionBufferSize));
+  promotionLevel_ = promotionStart_;
+  promotionEnd_ = promotionStart_ + ParallelEvacuator::kPromotionBufferSize;
+  return allocPromoted(sz);
+}
+
+template <bool CompactionEnabled>
+void HadesGC::EvacAcceptor<CompactionEnabled>::undoPromotion(
+    GCCell *cell,
+    uint32_t sz) {
+  char *const addr = reinterpret_cast<char *>(cell);
+  if (addr >= promotionStart_ && addr < promotionEnd_) {
+    assert(addr + sz == promotionLevel_ && "Can only undo the last allocation");
+    promotionLevel_ = addr;
+    return;
+  }
+  // The cell was allocated on its own and can't be given back while other
+  // workers may be allocating, so leave a dead cell in its place.
+  constructCell<FillerCell>(cell, sz);
+}
+
+template <bool CompactionEnabled>
+void HadesGC::EvacAcceptor<CompactionEnabled>::retirePromotionBuffer() {
+  const uint32_t unused = promotionEnd_ - promotionLevel_;
+  if (unused) {
+    if (promotionLevel_ == promotionStart_) {
+      // The start of the buffer was marked when it was allocated, so it can't
+      // become a free cell. Leave a dead cell in its place instead.
+      constructCell<FillerCell>(promotionLevel_, unused);
+    } else {
+      parallel_->freeUnusedBytes(promotionLevel_, unused);
+    }
+  }
+  promotionStart_ = promotionLevel_ = promotionEnd_ = nullptr;
+}
+
+template <bool CompactionEnabled>
+void HadesGC::EvacAcceptor<CompactionEnabled>::finishPromotion() {
+  for (GCCell *cell : promoted_)
+    HeapSegment::setCellMarkBit(cell);
+  promoted_.clear();
+  retirePromotionBuffer();
+}
+
 /// Mark weak roots separately from the MarkAcceptor since this is done while
 /// the world is stopped.
 /// Don't use the default weak root acceptor because fine-grained control of
@@ -1260,6 +2076,14 @@ constexpr double kYGInitialSurvivalRatio = 0.3;
 
 HadesGC::OldGen::OldGen(HadesGC &gc) : gc_(gc) {}
 
+/// \return the number of helper threads needed by the parallel parts of a
+/// collection that are enabled in \p gcConfig.
+static unsigned numWorkerPoolHelpers(const GCConfig &gcConfig) {
+  return std::max(
+      kConcurrentGC ? gcConfig.getParallelMarkThreads() : 0,
+      gcConfig.getParallelYGThreads());
+}
+
 HadesGC::HadesGC(
     GCCallbacks &gcCallbacks,
     PointerBase &pointerBase,
@@ -1281,6 +2105,20 @@ HadesGC::HadesGC(
       oldGen_{*this},
       backgroundExecutor_{
           kConcurrentGC ? std::make_unique<Executor>() : nullptr},
+      workerPool_{
+          numWorkerPoolHelpers(gcConfig)
+              ? std::make_unique<WorkerPool>(numWorkerPoolHelpers(gcConfig))
+              : nullptr},
+      parallelMarker_{
+          kConcurrentGC && gcConfig.getParallelMarkThreads()
+              ? std::make_unique<ParallelMarker>(
+                    *this, *workerPool_, gcConfig.getParallelMarkThreads())
+              : nullptr},
+      parallelEvacuator_{
+          gcConfig.getParallelYGThreads()
+              ? std::make_unique<ParallelEvacuator>(
+                    *this, *workerPool_, gcConfig.getParallelYGThreads())
+              : nullptr},
       promoteYGToOG_{!gcConfig.getAllocInYoung()},
       revertToYGAtTTI_{gcConfig.getRevertToYGAtTTI()},
       overwriteDeadYGObjects_{gcConfig.getOverwriteDeadYGObjects()},
@@ -1442,6 +2280,13 @@ void HadesGC::printStats(JSONEmitter &json) {
   json.emitKey("stats");
   json.openDict();
   json.emitKeyValue("Num compactions", numCompactions_);
+  if (parallelMarker_) {
+    std::lock_guard<Mutex> lk{gcMutex_};
+    json.emitKey("Mark thread times");
+    json.openArray();
+    json.emitValues(parallelMarker_->markTimes());
+    json.closeArray();
+  }
   json.closeDict();
   json.closeDict();
 }
@@ -2171,9 +3016,18 @@ void HadesGC::ttiReached() {
 
 bool HadesGC::calledByBackgroundThread() const {
   // If the background thread is active, check if this thread matches the
-  // background thread.
-  return kConcurrentGC &&
-      backgroundExecutor_->getThreadId() == std::this_thread::get_id();
+  // background thread. Helper threads count as whichever thread they are
+  // running a collection for.
+  std::thread::id id = std::this_thread::get_id();
+  if (workerPool_ && workerPool_->isHelperThread())
+    id = workerPool_->callerThreadId();
+  return kConcurrentGC && backgroundExecutor_->getThreadId() == id;
+}
+
+bool HadesGC::holdsGCMutex() const {
+  // Helpers evacuating the YG allocate under a lock of their own, while the
+  // thread they are helping holds gcMutex_.
+  return gcMutex_ || (workerPool_ && workerPool_->isHelperThread());
 }
 
 bool HadesGC::validPointer(const void *p) const {
@@ -2232,7 +3086,8 @@ GCCell *HadesGC::OldGen::alloc(uint32_t sz) {
       "Should be aligned before entering this function");
   assert(sz >= minAllocationSize() && "Allocating too small of an object");
   assert(sz <= maxAllocationSize() && "Allocating too large of an object");
-  assert(gc_.gcMutex_ && "gcMutex_ must be held before calling oldGenAlloc");
+  assert(
+      gc_.holdsGCMutex() && "gcMutex_ must be held before calling oldGenAlloc");
   if (GCCell *cell = search(sz)) {
     return cell;
   }
@@ -2272,6 +3127,17 @@ GCCell *HadesGC::OldGen::alloc(uint32_t sz) {
   gc_.oom(seg.getError());
 }
 
+void HadesGC::OldGen::freeUnusedBytes(void *addr, uint32_t sz) {
+  for (size_t i = 0, e = segments_.size(); i < e; ++i) {
+    if (segments_[i].contains(addr)) {
+      addCellToFreelist(addr, sz, &segmentBuckets_[i][getFreelistBucket(sz)]);
+      incrementAllocatedBytes(-static_cast<int32_t>(sz));
+      return;
+    }
+  }
+  llvm_unreachable("Freed bytes are not in the old gen");
+}
+
 uint32_t HadesGC::OldGen::getFreelistBucket(uint32_t size) {
   // If the size corresponds to the "small" portion of the freelist, then the
   // bucket is just (size) / (heap alignment)
@@ -2381,22 +3247,25 @@ GCCell *HadesGC::OldGen::search(uint32_t sz) {
   return nullptr;
 }
 
+template <typename Acceptor>
+void HadesGC::youngGenEvacuateRoots(Acceptor &acceptor, bool doCompaction) {
+  DroppingAcceptor<Acceptor> nameAcceptor{acceptor};
+  markRoots(nameAcceptor, /*markLongLived*/ doCompaction);
+
+  // Mark the values in WeakMap entries as roots for the purposes of young gen
+  // collection. This is slightly suboptimal since some of the keys or maps
+  // may be dead, but we still end up evacuating their corresponding value.
+  // This is done for simplicity, since it lets us avoid needing to iterate to
+  // a fixed point as is done during a full collection.
+  weakMapEntrySlots_.forEach([&nameAcceptor](WeakMapEntrySlot &slot) {
+    nameAcceptor.accept(slot.mappedValue);
+  });
+}
+
 template <typename Acceptor>
 void HadesGC::youngGenEvacuateImpl(Acceptor &acceptor, bool doCompaction) {
   // Marking each object puts it onto an embedded free list.
-  {
-    DroppingAcceptor<Acceptor> nameAcceptor{acceptor};
-    markRoots(nameAcceptor, /*markLongLived*/ doCompaction);
-
-    // Mark the values in WeakMap entries as roots for the purposes of young gen
-    // collection. This is slightly suboptimal since some of the keys or maps
-    // may be dead, but we still end up evacuating their corresponding value.
-    // This is done for simplicity, since it lets us avoid needing to iterate to
-    // a fixed point as is done during a full collection.
-    weakMapEntrySlots_.forEach([&nameAcceptor](WeakMapEntrySlot &slot) {
-      nameAcceptor.accept(slot.mappedValue);
-    });
-  }
+  youngGenEvacuateRoots(acceptor, doCompaction);
   // Find old-to-young pointers, as they are considered roots for YG
   // collection.
   scanDirtyCards(acceptor);
@@ -2461,7 +3330,14 @@ void HadesGC::youngGenCollection(
   } else {
     auto &yg = youngGen();
 
-    if (compactee_.segment) {
+    // The parallel evacuator doesn't report object moves to the ID tracker,
+    // so collections that need them are always done on this thread.
+    const bool parallel = parallelEvacuator_ && !isTrackingIDs();
+    if (parallel && compactee_.segment) {
+      heapBytes.after = parallelEvacuator_->evacuate<true>(doCompaction);
+    } else if (parallel) {
+      heapBytes.after = parallelEvacuator_->evacuate<false>(false);
+    } else if (compactee_.segment) {
       EvacAcceptor<true> acceptor{*this};
       youngGenEvacuateImpl(acceptor, doCompaction);
       // The remaining bytes after the collection is just the number of bytes
@@ -2697,9 +3573,9 @@ void HadesGC::updateYoungGenSizeFactor() {
     ygSizeFactor_ = std::max(ygSizeFactor_ * 0.9, 0.25);
 }
 
-template <bool CompactionEnabled>
+template <typename Acceptor>
 void HadesGC::scanDirtyCardsForSegment(
-    SlotVisitor<EvacAcceptor<CompactionEnabled>> &visitor,
+    SlotVisitor<Acceptor> &visitor,
     HeapSegment &seg) {
   const auto &cardTable = seg.cardTable();
   // Use level instead of end in case the OG segment is still in bump alloc
@@ -2850,7 +3726,8 @@ void HadesGC::OldGen::incrementAllocatedBytes(int32_t incr) {
 }
 
 uint64_t HadesGC::OldGen::externalBytes() const {
-  assert(gc_.gcMutex_ && "OG external bytes must be accessed under gcMutex_.");
+  assert(
+      gc_.holdsGCMutex() && "OG external bytes must be accessed under gcMutex_.");
   return externalBytes_;
 }
 
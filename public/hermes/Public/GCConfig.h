@@ -190,6 +190,16 @@ enum class GCEventKind {
   /* Whether to use mprotect on GC metadata between GCs. */              \
   F(constexpr, bool, ProtectMetadata, false)                             \
                                                                          \
+  /* Number of helper threads that mark the old gen alongside the GC */  \
+  /* thread. 0 keeps marking single-threaded. Only used by Hades in */   \
+  /* concurrent mode. */                                                 \
+  F(constexpr, unsigned, ParallelMarkThreads, 0)                         \
+                                                                         \
+  /* Number of helper threads that evacuate the young gen alongside */    \
+  /* the thread that collects it. 0 keeps young gen collections */       \
+  /* single-threaded. Only used by Hades. */                             \
+  F(constexpr, unsigned, ParallelYGThreads, 0)                           \
+                                                                         \
   /* Callout for an analytics event. */                                  \
   F(HERMES_NON_CONSTEXPR,                                                \
     std::function<void(const GCAnalyticsEvent &)>,                       \
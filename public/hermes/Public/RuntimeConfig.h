@@ -31,6 +31,17 @@ enum class SynthTraceMode : int8_t {
   TracingAndReplaying,
 };
 
+/// Which executor runs regular expressions.
+enum class RegExpEngine : int8_t {
+  /// Backtrack, switching to the linear-time executor if backtracking gets
+  /// excessive and the regex has no backreferences or lookarounds.
+  Auto,
+  /// Always backtrack.
+  Backtracking,
+  /// Use the linear-time executor whenever the regex can run on it.
+  Linear,
+};
+
 class PinnedHermesValue;
 
 // Parameters for Runtime initialisation.  Check documentation in README.md
@@ -72,6 +83,9 @@ class PinnedHermesValue;
   /* Support for ECMA-402 Intl APIs. */                                \
   F(constexpr, bool, Intl, true)                                       \
                                                                        \
+  /* Which executor runs regular expressions. */                      \
+  F(constexpr, RegExpEngine, RegExpEngine, RegExpEngine::Auto)         \
+                                                                       \
   /* Support for ArrayBuffer, DataView and typed arrays. */            \
   F(constexpr, bool, ArrayBuffer, true)                                \
                                                                        \
@@ -94,7 +94,7 @@ function *args() {
 // CHECK-NEXT:    ToNumeric         r5, r5
 // CHECK-NEXT:    Inc               r7, r5
 // CHECK-NEXT:    StoreToEnvironment r6, 1, r7
-// CHECK-NEXT:    GetByVal          r3, r3, r5
+// CHECK-NEXT:    GetByVal          r3, r3, r5, 2
 // CHECK-NEXT:    SaveGenerator     L3
 // CHECK-NEXT:    Ret               r3
 // CHECK-NEXT:L3:
@@ -160,9 +160,9 @@ function *args() {
 // CHECK-NEXT:    bc 30: line 12 col 10 scope offset 0x0000 env none
 // CHECK-NEXT:    bc 47: line 13 col 14 scope offset 0x0000 env none
 // CHECK-NEXT:    bc 57: line 13 col 12 scope offset 0x0000 env none
-// CHECK-NEXT:    bc 61: line 13 col 5 scope offset 0x0000 env none
-// CHECK-NEXT:    bc 65: line 13 col 5 scope offset 0x0000 env none
-// CHECK-NEXT:    bc 76: line 12 col 10 scope offset 0x0000 env none
+// CHECK-NEXT:    bc 62: line 13 col 5 scope offset 0x0000 env none
+// CHECK-NEXT:    bc 66: line 13 col 5 scope offset 0x0000 env none
+// CHECK-NEXT:    bc 77: line 12 col 10 scope offset 0x0000 env none
 // CHECK-NEXT:  0x0050  function idx 4, starts at line 18 col 1
 // CHECK-NEXT:    bc 16: line 19 col 18 scope offset 0x0000 env none
 // CHECK-NEXT:    bc 20: line 19 col 3 scope offset 0x0000 env none
@@ -24,12 +24,12 @@ function foo(p) {
 //CHECK-NEXT:[@ {{.*}}] LoadConstUInt8 2<Reg8>, 1<UInt8>
 //CHECK-NEXT:[@ {{.*}}] PutNewOwnByIdShort 0<Reg8>, 2<Reg8>, 1<UInt8>
 //CHECK-NEXT:[@ {{.*}}] PutById 0<Reg8>, 2<Reg8>,  1<UInt8>, 1<UInt16>
-//CHECK-NEXT:[@ {{.*}}] PutByVal 0<Reg8>, 1<Reg8>, 2<Reg8>
+//CHECK-NEXT:[@ {{.*}}] PutByVal 0<Reg8>, 1<Reg8>, 2<Reg8>, 2<UInt8>
 //CHECK-NEXT:[@ {{.*}}] GetByIdShort 2<Reg8>, 0<Reg8>, 1<UInt8>, 1<UInt8>
-//CHECK-NEXT:[@ {{.*}}] PutById 0<Reg8>, 2<Reg8>, 2<UInt8>, 2<UInt16>
-//CHECK-NEXT:[@ {{.*}}] GetByVal 3<Reg8>, 0<Reg8>, 1<Reg8>
+//CHECK-NEXT:[@ {{.*}}] PutById 0<Reg8>, 2<Reg8>, 3<UInt8>, 2<UInt16>
+//CHECK-NEXT:[@ {{.*}}] GetByVal 3<Reg8>, 0<Reg8>, 1<Reg8>, 2<UInt8>
 //CHECK-NEXT:[@ {{.*}}] LoadConstUInt8 2<Reg8>, 2<UInt8>
-//CHECK-NEXT:[@ {{.*}}] PutByVal 0<Reg8>, 2<Reg8>, 3<Reg8>
+//CHECK-NEXT:[@ {{.*}}] PutByVal 0<Reg8>, 2<Reg8>, 3<Reg8>, 0<UInt8>
 //CHECK-NEXT:[@ {{.*}}] DelById 2<Reg8>, 0<Reg8>, 2<UInt16>
 //CHECK-NEXT:[@ {{.*}}] DelByVal 0<Reg8>, 0<Reg8>, 1<Reg8>
 //CHECK-NEXT:[@ {{.*}}] LoadConstUndefined 0<Reg8>
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O0 -reuse-prop-cache=false -dump-bytecode %s | %FileCheck %s
+// RUN: %hermes -O0 -reuse-prop-cache=false %s | %FileCheck --check-prefix=EXEC %s
+// RUN: %hermesc -O0 -reuse-prop-cache=false -emit-binary -out %t.hbc %s && %hbcdump %t.hbc -c "prop-cache;quit" | %FileCheck --check-prefix=DUMP %s
+
+// A function with more read caches than fit in a UInt8 operand. The read in
+// the loop is the hottest site and gets the first cache index, the 300 cold
+// reads take the remaining short indices and then long ones.
+function many(o) {
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p; o.p;
+  var sum = 0;
+  for (var i = 0; i < 10; ++i)
+    sum += o.hot;
+  return sum;
+}
+
+print(many({p: 1, hot: 2}));
+// EXEC: 20
+
+// CHECK-LABEL: Function<many>
+// CHECK:         GetByIdShort {{.*}}, 2, "p"
+// CHECK:         GetByIdShort {{.*}}, 255, "p"
+// CHECK:         GetByIdLong {{.*}}, 256, "p"
+// CHECK:         GetByIdLong {{.*}}, 301, "p"
+// CHECK:         GetByIdShort {{.*}}, 1, "hot"
+
+// DUMP:      "FunctionID": {{[0-9]+}},
+// DUMP-NEXT: "Name": "many",
+// DUMP-NEXT: "ReadCaches": 301,
+// DUMP-NEXT: "WriteCaches": 0,
+// DUMP-NEXT: "Sites": 301,
+// DUMP-NEXT: "SharedSites": 0,
+// DUMP-NEXT: "LongIndexSites": 46,
+// DUMP-NEXT: "UncachedSites": 0
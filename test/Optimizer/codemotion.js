@@ -202,17 +202,17 @@ function code_sinking_in_loop(x, y) {
 // CHECK-NEXT:%BB0:
 // CHECK-NEXT:  $Reg2 @0 [1...13) 	%0 = HBCLoadParamInst 3 : number
 // CHECK-NEXT:  $Reg0 @1 [2...3) 	%1 = HBCLoadParamInst 1 : number
-// CHECK-NEXT:  $Reg0 @2 [3...7) 	%2 = AsNumberInst %1
+// CHECK-NEXT:  $Reg0 @2 [3...6) 	%2 = AsNumberInst %1
 // CHECK-NEXT:  $Reg1 @3 [4...5) 	%3 = HBCLoadParamInst 2 : number
-// CHECK-NEXT:  $Reg4 @4 [5...9) 	%4 = AsNumberInst %3
-// CHECK-NEXT:  $Reg1 @5 [6...13) 	%5 = HBCLoadConstInst undefined : undefined
-// CHECK-NEXT:  $Reg3 @6 [7...10) 	%6 = UnaryOperatorInst '-', %2 : number
-// CHECK-NEXT:  $Reg0 @7 [8...9) 	%7 = HBCLoadConstInst 7 : number
-// CHECK-NEXT:  $Reg0 @8 [9...10) 	%8 = BinaryOperatorInst '+', %4 : number, %7 : number
-// CHECK-NEXT:  $Reg0 @9 [10...13) 	%9 = BinaryOperatorInst '*', %6 : number, %8 : number
+// CHECK-NEXT:  $Reg3 @4 [5...8) 	%4 = AsNumberInst %3
+// CHECK-NEXT:  $Reg1 @5 [6...9) 	%5 = UnaryOperatorInst '-', %2 : number
+// CHECK-NEXT:  $Reg0 @6 [7...8) 	%6 = HBCLoadConstInst 7 : number
+// CHECK-NEXT:  $Reg0 @7 [8...9) 	%7 = BinaryOperatorInst '+', %4 : number, %6 : number
+// CHECK-NEXT:  $Reg1 @8 [9...13) 	%8 = BinaryOperatorInst '*', %5 : number, %7 : number
+// CHECK-NEXT:  $Reg0 @9 [10...13) 	%9 = HBCLoadConstInst undefined : undefined
 // CHECK-NEXT:  $Reg3 @10 [empty]	%10 = BranchInst %BB1
 // CHECK-NEXT:%BB1:
-// CHECK-NEXT:  $Reg3 @11 [empty]	%11 = HBCCallNInst %0, undefined : undefined, %5 : undefined, %9 : number
+// CHECK-NEXT:  $Reg3 @11 [empty]	%11 = HBCCallNInst %0, undefined : undefined, %9 : undefined, %8 : number
 // CHECK-NEXT:  $Reg0 @12 [empty]	%12 = BranchInst %BB1
 // CHECK-NEXT:function_end
 
@@ -220,22 +220,22 @@ function code_sinking_in_loop(x, y) {
 // CHECK-NEXT:S{hoist_from_multiblock_loop#0#1()#2} = []
 // CHECK-NEXT:%BB0:
 // CHECK-NEXT:  $Reg0 @0 [1...2) 	%0 = HBCLoadParamInst 1 : number
-// CHECK-NEXT:  $Reg4 @1 [2...9) 	%1 = AsNumberInst %0
-// CHECK-NEXT:  $Reg3 @2 [3...16) 	%2 = HBCGetGlobalObjectInst
-// CHECK-NEXT:  $Reg2 @3 [4...16) 	%3 = HBCLoadConstInst undefined : undefined
-// CHECK-NEXT:  $Reg0 @4 [5...6) 	%4 = HBCLoadConstInst 3 : number
-// CHECK-NEXT:  $Reg0 @5 [6...7) 	%5 = BinaryOperatorInst '*', %4 : number, %1 : number
-// CHECK-NEXT:  $Reg1 @6 [7...16) 	%6 = BinaryOperatorInst '*', %5 : number, %1 : number
-// CHECK-NEXT:  $Reg0 @7 [8...9) 	%7 = HBCLoadConstInst 1 : number
-// CHECK-NEXT:  $Reg0 @8 [9...16) 	%8 = BinaryOperatorInst '-', %1 : number, %7 : number
+// CHECK-NEXT:  $Reg1 @1 [2...7) 	%1 = AsNumberInst %0
+// CHECK-NEXT:  $Reg0 @2 [3...4) 	%2 = HBCLoadConstInst 3 : number
+// CHECK-NEXT:  $Reg0 @3 [4...5) 	%3 = BinaryOperatorInst '*', %2 : number, %1 : number
+// CHECK-NEXT:  $Reg3 @4 [5...16) 	%4 = BinaryOperatorInst '*', %3 : number, %1 : number
+// CHECK-NEXT:  $Reg0 @5 [6...7) 	%5 = HBCLoadConstInst 1 : number
+// CHECK-NEXT:  $Reg2 @6 [7...16) 	%6 = BinaryOperatorInst '-', %1 : number, %5 : number
+// CHECK-NEXT:  $Reg1 @7 [8...16) 	%7 = HBCGetGlobalObjectInst
+// CHECK-NEXT:  $Reg0 @8 [9...16) 	%8 = HBCLoadConstInst undefined : undefined
 // CHECK-NEXT:  $Reg4 @9 [empty]	%9 = BranchInst %BB1
 // CHECK-NEXT:%BB1:
-// CHECK-NEXT:  $Reg4 @10 [11...12) 	%10 = TryLoadGlobalPropertyInst %2 : object, "print" : string
-// CHECK-NEXT:  $Reg4 @11 [empty]	%11 = HBCCallNInst %10, undefined : undefined, %3 : undefined, %6 : number
-// CHECK-NEXT:  $Reg4 @12 [empty]	%12 = CondBranchInst %8 : number, %BB2, %BB1
+// CHECK-NEXT:  $Reg4 @10 [11...12) 	%10 = TryLoadGlobalPropertyInst %7 : object, "print" : string
+// CHECK-NEXT:  $Reg4 @11 [empty]	%11 = HBCCallNInst %10, undefined : undefined, %8 : undefined, %4 : number
+// CHECK-NEXT:  $Reg4 @12 [empty]	%12 = CondBranchInst %6 : number, %BB2, %BB1
 // CHECK-NEXT:%BB2:
-// CHECK-NEXT:  $Reg4 @13 [14...15) 	%13 = TryLoadGlobalPropertyInst %2 : object, "print" : string
-// CHECK-NEXT:  $Reg4 @14 [empty]	%14 = HBCCallNInst %13, undefined : undefined, %3 : undefined, %6 : number
+// CHECK-NEXT:  $Reg4 @13 [14...15) 	%13 = TryLoadGlobalPropertyInst %7 : object, "print" : string
+// CHECK-NEXT:  $Reg4 @14 [empty]	%14 = HBCCallNInst %13, undefined : undefined, %8 : undefined, %4 : number
 // CHECK-NEXT:  $Reg0 @15 [empty]	%15 = BranchInst %BB1
 // CHECK-NEXT:function_end
 
@@ -244,20 +244,20 @@ function code_sinking_in_loop(x, y) {
 // CHECK-NEXT:%BB0:
 // CHECK-NEXT:  $Reg0 @0 [1...14) 	%0 = HBCLoadParamInst 2 : number
 // CHECK-NEXT:  $Reg1 @1 [2...3) 	%1 = HBCLoadParamInst 1 : number
-// CHECK-NEXT:  $Reg1 @2 [3...6) 	%2 = AsNumberInst %1
-// CHECK-NEXT:  $Reg3 @3 [4...13) 	%3 = HBCGetGlobalObjectInst
-// CHECK-NEXT:  $Reg2 @4 [5...13) 	%4 = HBCLoadConstInst undefined : undefined
-// CHECK-NEXT:  $Reg4 @5 [6...8) 	%5 = BinaryOperatorInst '*', %2 : number, %2 : number
-// CHECK-NEXT:  $Reg1 @6 [7...8) 	%6 = HBCLoadConstInst 3 : number
-// CHECK-NEXT:  $Reg1 @7 [8...13) 	%7 = BinaryOperatorInst '-', %5 : number, %6 : number
+// CHECK-NEXT:  $Reg1 @2 [3...4) 	%2 = AsNumberInst %1
+// CHECK-NEXT:  $Reg2 @3 [4...6) 	%3 = BinaryOperatorInst '*', %2 : number, %2 : number
+// CHECK-NEXT:  $Reg1 @4 [5...6) 	%4 = HBCLoadConstInst 3 : number
+// CHECK-NEXT:  $Reg3 @5 [6...13) 	%5 = BinaryOperatorInst '-', %3 : number, %4 : number
+// CHECK-NEXT:  $Reg2 @6 [7...13) 	%6 = HBCGetGlobalObjectInst
+// CHECK-NEXT:  $Reg1 @7 [8...13) 	%7 = HBCLoadConstInst undefined : undefined
 // CHECK-NEXT:  $Reg4 @8 [empty]	%8 = BranchInst %BB1
 // CHECK-NEXT:%BB1:
 // CHECK-NEXT:  $Reg4 @9 [empty]	%9 = CondBranchInst %0, %BB2, %BB3
 // CHECK-NEXT:%BB2:
 // CHECK-NEXT:  $Reg0 @13 [empty]	%10 = ReturnInst %0
 // CHECK-NEXT:%BB3:
-// CHECK-NEXT:  $Reg4 @10 [11...12) 	%11 = TryLoadGlobalPropertyInst %3 : object, "print" : string
-// CHECK-NEXT:  $Reg4 @11 [empty]	%12 = HBCCallNInst %11, undefined : undefined, %4 : undefined, %7 : number
+// CHECK-NEXT:  $Reg4 @10 [11...12) 	%11 = TryLoadGlobalPropertyInst %6 : object, "print" : string
+// CHECK-NEXT:  $Reg4 @11 [empty]	%12 = HBCCallNInst %11, undefined : undefined, %7 : undefined, %5 : number
 // CHECK-NEXT:  $Reg1 @12 [empty]	%13 = BranchInst %BB1
 // CHECK-NEXT:function_end
 
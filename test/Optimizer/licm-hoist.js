@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir %s | %FileCheckOrRegen --match-full-lines %s
+
+// Arithmetic on values defined outside the loop is computed once.
+function hoist_arith(n, x) {
+  var t = 0;
+  var k = x | 0;
+  for (var i = 0; i < n; i++) {
+    t = (t + ((k * 3) | 0)) | 0;
+  }
+  return t;
+}
+
+// Own properties of an object literal and the length of an array literal
+// that never escape are loaded once.
+function hoist_literal_props(n) {
+  var o = {scale: 3, bias: 1};
+  var a = [1, 2, 3];
+  var t = 0;
+  for (var i = 0; i < n; i++) {
+    t = (t + o.scale * a.length + o.bias) | 0;
+  }
+  return t;
+}
+
+// A variable of the enclosing function can't change in a loop without calls.
+function hoist_outer_load(k, f) {
+  f(function () {
+    var t = 0;
+    for (var i = 0; i < 10; i++) {
+      if (k) ++t;
+    }
+    return t;
+  });
+  k = 2;
+}
+
+// Auto-generated content below. Please do not modify manually.
+
+// CHECK:function global#0()#1 : undefined
+// CHECK-NEXT:globals = [hoist_arith, hoist_literal_props, hoist_outer_load]
+// CHECK-NEXT:S{global#0()#1} = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{global#0()#1}
+// CHECK-NEXT:  %1 = CreateFunctionInst %hoist_arith#0#1()#2 : number, %0
+// CHECK-NEXT:  %2 = StorePropertyInst %1 : closure, globalObject : object, "hoist_arith" : string
+// CHECK-NEXT:  %3 = CreateFunctionInst %hoist_literal_props#0#1()#3 : number, %0
+// CHECK-NEXT:  %4 = StorePropertyInst %3 : closure, globalObject : object, "hoist_literal_props" : string
+// CHECK-NEXT:  %5 = CreateFunctionInst %hoist_outer_load#0#1()#4 : undefined, %0
+// CHECK-NEXT:  %6 = StorePropertyInst %5 : closure, globalObject : object, "hoist_outer_load" : string
+// CHECK-NEXT:  %7 = ReturnInst undefined : undefined
+// CHECK-NEXT:function_end
+
+// CHECK:function hoist_arith#0#1(n, x)#2 : number
+// CHECK-NEXT:S{hoist_arith#0#1()#2} = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{hoist_arith#0#1()#2}
+// CHECK-NEXT:  %1 = AsInt32Inst %x
+// CHECK-NEXT:  %2 = BinaryOperatorInst '<', 0 : number, %n
+// CHECK-NEXT:  %3 = BinaryOperatorInst '*', %1 : number, 3 : number
+// CHECK-NEXT:  %4 = CondBranchInst %2 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %5 = PhiInst 0 : number, %BB0, %9 : number, %BB1
+// CHECK-NEXT:  %6 = PhiInst 0 : number, %BB0, %10 : number|bigint, %BB1
+// CHECK-NEXT:  %7 = AsInt32Inst %3 : number
+// CHECK-NEXT:  %8 = BinaryOperatorInst '+', %5 : number, %7 : number
+// CHECK-NEXT:  %9 = AsInt32Inst %8 : number
+// CHECK-NEXT:  %10 = UnaryOperatorInst '++', %6 : number|bigint
+// CHECK-NEXT:  %11 = BinaryOperatorInst '<', %10 : number|bigint, %n
+// CHECK-NEXT:  %12 = CondBranchInst %11 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %13 = PhiInst 0 : number, %BB0, %9 : number, %BB1
+// CHECK-NEXT:  %14 = ReturnInst %13 : number
+// CHECK-NEXT:function_end
+
+// CHECK:function hoist_literal_props#0#1(n)#3 : number
+// CHECK-NEXT:S{hoist_literal_props#0#1()#3} = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{hoist_literal_props#0#1()#3}
+// CHECK-NEXT:  %1 = AllocObjectInst 2 : number, empty
+// CHECK-NEXT:  %2 = StoreNewOwnPropertyInst 3 : number, %1 : object, "scale" : string, true : boolean
+// CHECK-NEXT:  %3 = StoreNewOwnPropertyInst 1 : number, %1 : object, "bias" : string, true : boolean
+// CHECK-NEXT:  %4 = AllocArrayInst 3 : number, 1 : number, 2 : number, 3 : number
+// CHECK-NEXT:  %5 = BinaryOperatorInst '<', 0 : number, %n
+// CHECK-NEXT:  %6 = LoadPropertyInst %1 : object, "scale" : string
+// CHECK-NEXT:  %7 = LoadPropertyInst %4 : object, "length" : string
+// CHECK-NEXT:  %8 = LoadPropertyInst %1 : object, "bias" : string
+// CHECK-NEXT:  %9 = CondBranchInst %5 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %10 = PhiInst 0 : number, %BB0, %15 : number, %BB1
+// CHECK-NEXT:  %11 = PhiInst 0 : number, %BB0, %16 : number|bigint, %BB1
+// CHECK-NEXT:  %12 = BinaryOperatorInst '*', %6, %7
+// CHECK-NEXT:  %13 = BinaryOperatorInst '+', %10 : number, %12 : number|bigint
+// CHECK-NEXT:  %14 = BinaryOperatorInst '+', %13 : number, %8
+// CHECK-NEXT:  %15 = AsInt32Inst %14 : string|number
+// CHECK-NEXT:  %16 = UnaryOperatorInst '++', %11 : number|bigint
+// CHECK-NEXT:  %17 = BinaryOperatorInst '<', %16 : number|bigint, %n
+// CHECK-NEXT:  %18 = CondBranchInst %17 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %19 = PhiInst 0 : number, %BB0, %15 : number, %BB1
+// CHECK-NEXT:  %20 = ReturnInst %19 : number
+// CHECK-NEXT:function_end
+
+// CHECK:function hoist_outer_load#0#1(k, f)#4 : undefined
+// CHECK-NEXT:S{hoist_outer_load#0#1()#4} = [k#4]
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{hoist_outer_load#0#1()#4}
+// CHECK-NEXT:  %1 = StoreFrameInst %k, [k#4], %0
+// CHECK-NEXT:  %2 = CreateFunctionInst %""#1#4()#5 : number|bigint, %0
+// CHECK-NEXT:  %3 = CallInst %f, undefined : undefined, undefined : undefined, %2 : closure
+// CHECK-NEXT:  %4 = StoreFrameInst 2 : number, [k#4], %0
+// CHECK-NEXT:  %5 = ReturnInst undefined : undefined
+// CHECK-NEXT:function_end
+
+// CHECK:function ""#1#4()#5 : number|bigint
+// CHECK-NEXT:S{""#1#4()#5} = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{""#1#4()#5}
+// CHECK-NEXT:  %1 = LoadFrameInst [k#4@hoist_outer_load], %0
+// CHECK-NEXT:  %2 = BranchInst %BB1
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %3 = PhiInst 0 : number, %BB0, %7 : number|bigint, %BB2
+// CHECK-NEXT:  %4 = PhiInst 0 : number, %BB0, %8 : number|bigint, %BB2
+// CHECK-NEXT:  %5 = CondBranchInst %1, %BB3, %BB2
+// CHECK-NEXT:%BB4:
+// CHECK-NEXT:  %6 = ReturnInst %7 : number|bigint
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %7 = PhiInst %11 : number|bigint, %BB3, %3 : number|bigint, %BB1
+// CHECK-NEXT:  %8 = UnaryOperatorInst '++', %4 : number|bigint
+// CHECK-NEXT:  %9 = BinaryOperatorInst '<', %8 : number|bigint, 10 : number
+// CHECK-NEXT:  %10 = CondBranchInst %9 : boolean, %BB1, %BB4
+// CHECK-NEXT:%BB3:
+// CHECK-NEXT:  %11 = UnaryOperatorInst '++', %3 : number|bigint
+// CHECK-NEXT:  %12 = BranchInst %BB2
+// CHECK-NEXT:function_end
@@ -0,0 +1,198 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir %s | %FileCheckOrRegen --match-full-lines %s
+
+// The call may write the variable through the closure it escapes to.
+function no_hoist_past_call(n, f) {
+  var k = 1;
+  f(function (v) {
+    k = v;
+  });
+  var t = 0;
+  for (var i = 0; i < n; i++) {
+    t = (t + k) | 0;
+    f(i);
+  }
+  return t;
+}
+
+// The loop stores the property it loads.
+function no_hoist_clobbered_prop(n) {
+  var o = {x: 1};
+  for (var i = 0; i < n; i++) {
+    o.x = o.x + 1;
+  }
+  return o.x;
+}
+
+// Storing an element may change the length of the array.
+function no_hoist_array_length(n) {
+  var a = [1, 2];
+  for (var i = 0; i < n; i++) {
+    a[i] = a.length;
+  }
+  return a[0];
+}
+
+// The object escapes to the call, which may change its properties.
+function no_hoist_escaping_object(n, f) {
+  var o = {x: 1};
+  f(o);
+  var t = 0;
+  for (var i = 0; i < n; i++) {
+    t = (t + o.x) | 0;
+    f();
+  }
+  return t;
+}
+
+// Loading a property of a parameter may throw or run a getter, so it must not
+// run if the loop doesn't.
+function no_hoist_throwing_load(n, o) {
+  var t = 0;
+  for (var i = 0; i < n; i++) {
+    t = (t + o.x) | 0;
+  }
+  return t;
+}
+
+// Auto-generated content below. Please do not modify manually.
+
+// CHECK:function global#0()#1 : undefined
+// CHECK-NEXT:globals = [no_hoist_past_call, no_hoist_clobbered_prop, no_hoist_array_length, no_hoist_escaping_object, no_hoist_throwing_load]
+// CHECK-NEXT:S{global#0()#1} = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{global#0()#1}
+// CHECK-NEXT:  %1 = CreateFunctionInst %no_hoist_past_call#0#1()#2 : number, %0
+// CHECK-NEXT:  %2 = StorePropertyInst %1 : closure, globalObject : object, "no_hoist_past_call" : string
+// CHECK-NEXT:  %3 = CreateFunctionInst %no_hoist_clobbered_prop#0#1()#4, %0
+// CHECK-NEXT:  %4 = StorePropertyInst %3 : closure, globalObject : object, "no_hoist_clobbered_prop" : string
+// CHECK-NEXT:  %5 = CreateFunctionInst %no_hoist_array_length#0#1()#5, %0
+// CHECK-NEXT:  %6 = StorePropertyInst %5 : closure, globalObject : object, "no_hoist_array_length" : string
+// CHECK-NEXT:  %7 = CreateFunctionInst %no_hoist_escaping_object#0#1()#6 : number, %0
+// CHECK-NEXT:  %8 = StorePropertyInst %7 : closure, globalObject : object, "no_hoist_escaping_object" : string
+// CHECK-NEXT:  %9 = CreateFunctionInst %no_hoist_throwing_load#0#1()#7 : number, %0
+// CHECK-NEXT:  %10 = StorePropertyInst %9 : closure, globalObject : object, "no_hoist_throwing_load" : string
+// CHECK-NEXT:  %11 = ReturnInst undefined : undefined
+// CHECK-NEXT:function_end
+
+// CHECK:function no_hoist_past_call#0#1(n, f)#2 : number
+// CHECK-NEXT:S{no_hoist_past_call#0#1()#2} = [k#2]
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{no_hoist_past_call#0#1()#2}
+// CHECK-NEXT:  %1 = StoreFrameInst 1 : number, [k#2], %0
+// CHECK-NEXT:  %2 = CreateFunctionInst %""#1#2()#3 : undefined, %0
+// CHECK-NEXT:  %3 = CallInst %f, undefined : undefined, undefined : undefined, %2 : closure
+// CHECK-NEXT:  %4 = BinaryOperatorInst '<', 0 : number, %n
+// CHECK-NEXT:  %5 = CondBranchInst %4 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %6 = PhiInst 0 : number, %BB0, %10 : number, %BB1
+// CHECK-NEXT:  %7 = PhiInst 0 : number, %BB0, %12 : number|bigint, %BB1
+// CHECK-NEXT:  %8 = LoadFrameInst [k#2], %0
+// CHECK-NEXT:  %9 = BinaryOperatorInst '+', %6 : number, %8
+// CHECK-NEXT:  %10 = AsInt32Inst %9 : string|number
+// CHECK-NEXT:  %11 = CallInst %f, undefined : undefined, undefined : undefined, %7 : number|bigint
+// CHECK-NEXT:  %12 = UnaryOperatorInst '++', %7 : number|bigint
+// CHECK-NEXT:  %13 = BinaryOperatorInst '<', %12 : number|bigint, %n
+// CHECK-NEXT:  %14 = CondBranchInst %13 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %15 = PhiInst 0 : number, %BB0, %10 : number, %BB1
+// CHECK-NEXT:  %16 = ReturnInst %15 : number
+// CHECK-NEXT:function_end
+
+// CHECK:function ""#1#2(v)#3 : undefined
+// CHECK-NEXT:S{""#1#2()#3} = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{""#1#2()#3}
+// CHECK-NEXT:  %1 = StoreFrameInst %v, [k#2@no_hoist_past_call], %0
+// CHECK-NEXT:  %2 = ReturnInst undefined : undefined
+// CHECK-NEXT:function_end
+
+// CHECK:function no_hoist_clobbered_prop#0#1(n)#4
+// CHECK-NEXT:S{no_hoist_clobbered_prop#0#1()#4} = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{no_hoist_clobbered_prop#0#1()#4}
+// CHECK-NEXT:  %1 = AllocObjectInst 1 : number, empty
+// CHECK-NEXT:  %2 = StoreNewOwnPropertyInst 1 : number, %1 : object, "x" : string, true : boolean
+// CHECK-NEXT:  %3 = BinaryOperatorInst '<', 0 : number, %n
+// CHECK-NEXT:  %4 = CondBranchInst %3 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %5 = PhiInst 0 : number, %BB0, %9 : number|bigint, %BB1
+// CHECK-NEXT:  %6 = LoadPropertyInst %1 : object, "x" : string
+// CHECK-NEXT:  %7 = BinaryOperatorInst '+', %6, 1 : number
+// CHECK-NEXT:  %8 = StorePropertyInst %7 : string|number, %1 : object, "x" : string
+// CHECK-NEXT:  %9 = UnaryOperatorInst '++', %5 : number|bigint
+// CHECK-NEXT:  %10 = BinaryOperatorInst '<', %9 : number|bigint, %n
+// CHECK-NEXT:  %11 = CondBranchInst %10 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %12 = LoadPropertyInst %1 : object, "x" : string
+// CHECK-NEXT:  %13 = ReturnInst %12
+// CHECK-NEXT:function_end
+
+// CHECK:function no_hoist_array_length#0#1(n)#5
+// CHECK-NEXT:S{no_hoist_array_length#0#1()#5} = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{no_hoist_array_length#0#1()#5}
+// CHECK-NEXT:  %1 = AllocArrayInst 2 : number, 1 : number, 2 : number
+// CHECK-NEXT:  %2 = BinaryOperatorInst '<', 0 : number, %n
+// CHECK-NEXT:  %3 = CondBranchInst %2 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %4 = PhiInst 0 : number, %BB0, %7 : number|bigint, %BB1
+// CHECK-NEXT:  %5 = LoadPropertyInst %1 : object, "length" : string
+// CHECK-NEXT:  %6 = StorePropertyInst %5, %1 : object, %4 : number|bigint
+// CHECK-NEXT:  %7 = UnaryOperatorInst '++', %4 : number|bigint
+// CHECK-NEXT:  %8 = BinaryOperatorInst '<', %7 : number|bigint, %n
+// CHECK-NEXT:  %9 = CondBranchInst %8 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %10 = LoadPropertyInst %1 : object, 0 : number
+// CHECK-NEXT:  %11 = ReturnInst %10
+// CHECK-NEXT:function_end
+
+// CHECK:function no_hoist_escaping_object#0#1(n, f)#6 : number
+// CHECK-NEXT:S{no_hoist_escaping_object#0#1()#6} = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{no_hoist_escaping_object#0#1()#6}
+// CHECK-NEXT:  %1 = AllocObjectInst 1 : number, empty
+// CHECK-NEXT:  %2 = StoreNewOwnPropertyInst 1 : number, %1 : object, "x" : string, true : boolean
+// CHECK-NEXT:  %3 = CallInst %f, undefined : undefined, undefined : undefined, %1 : object
+// CHECK-NEXT:  %4 = BinaryOperatorInst '<', 0 : number, %n
+// CHECK-NEXT:  %5 = CondBranchInst %4 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %6 = PhiInst 0 : number, %BB0, %10 : number, %BB1
+// CHECK-NEXT:  %7 = PhiInst 0 : number, %BB0, %12 : number|bigint, %BB1
+// CHECK-NEXT:  %8 = LoadPropertyInst %1 : object, "x" : string
+// CHECK-NEXT:  %9 = BinaryOperatorInst '+', %6 : number, %8
+// CHECK-NEXT:  %10 = AsInt32Inst %9 : string|number
+// CHECK-NEXT:  %11 = CallInst %f, undefined : undefined, undefined : undefined
+// CHECK-NEXT:  %12 = UnaryOperatorInst '++', %7 : number|bigint
+// CHECK-NEXT:  %13 = BinaryOperatorInst '<', %12 : number|bigint, %n
+// CHECK-NEXT:  %14 = CondBranchInst %13 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %15 = PhiInst 0 : number, %BB0, %10 : number, %BB1
+// CHECK-NEXT:  %16 = ReturnInst %15 : number
+// CHECK-NEXT:function_end
+
+// CHECK:function no_hoist_throwing_load#0#1(n, o)#7 : number
+// CHECK-NEXT:S{no_hoist_throwing_load#0#1()#7} = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CreateScopeInst %S{no_hoist_throwing_load#0#1()#7}
+// CHECK-NEXT:  %1 = BinaryOperatorInst '<', 0 : number, %n
+// CHECK-NEXT:  %2 = CondBranchInst %1 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %3 = PhiInst 0 : number, %BB0, %7 : number, %BB1
+// CHECK-NEXT:  %4 = PhiInst 0 : number, %BB0, %8 : number|bigint, %BB1
+// CHECK-NEXT:  %5 = LoadPropertyInst %o, "x" : string
+// CHECK-NEXT:  %6 = BinaryOperatorInst '+', %3 : number, %5
+// CHECK-NEXT:  %7 = AsInt32Inst %6 : string|number
+// CHECK-NEXT:  %8 = UnaryOperatorInst '++', %4 : number|bigint
+// CHECK-NEXT:  %9 = BinaryOperatorInst '<', %8 : number|bigint, %n
+// CHECK-NEXT:  %10 = CondBranchInst %9 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %11 = PhiInst 0 : number, %BB0, %7 : number, %BB1
+// CHECK-NEXT:  %12 = ReturnInst %11 : number
+// CHECK-NEXT:function_end
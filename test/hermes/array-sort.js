@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -gc-sanitize-handles=1 %s | %FileCheck --match-full-lines %s
+
+print('sort-default');
+// CHECK-LABEL: sort-default
+
+// Numbers are compared as strings.
+print([10, 9, 1, 100, -5, -10, 2.5, 25, 1e21, 1e-7, 0].sort().join());
+// CHECK-NEXT: -10,-5,0,1,10,100,1e+21,1e-7,2.5,25,9
+print([NaN, Infinity, -Infinity, 3, 'x'.length].sort().join());
+// CHECK-NEXT: -Infinity,1,3,Infinity,NaN
+
+// Elements with equal string representations keep their order.
+var a = [0, 1, -0, 1, 0, -0].sort();
+print(a.map(function (x) { return Object.is(x, -0) ? '-0' : x; }).join());
+// CHECK-NEXT: 0,-0,0,-0,1,1
+
+// Strings, including ones that are not ASCII.
+print(['b', 'a', 'ab', 'é', 'A', '', 'zĀ', 'z'].sort().join('|'));
+// CHECK-NEXT: |A|a|ab|b|z|zĀ|é
+
+// Number arrays that are too long to convert natively take the generic path.
+var long = [];
+for (var i = 0; i < 70000; ++i) long.push((i * 7919) % 70000);
+long.sort();
+var ordered = true;
+for (var i = 1; i < long.length; ++i) {
+  if (String(long[i - 1]) > String(long[i])) ordered = false;
+}
+print(long.length, ordered, long[0], long[1], long[long.length - 1]);
+// CHECK-NEXT: 70000 true 0 1 9999
+
+// Mixed element types and holes take the generic path.
+print([3, '20', 1, undefined, , 'a', true].sort().join());
+// CHECK-NEXT: 1,20,3,a,true,,
+
+// Arrays that can't be written directly take the generic path.
+var frozen = Object.freeze([2, 1]);
+try {
+  frozen.sort();
+} catch (e) {
+  print('caught', e.name);
+}
+// CHECK-NEXT: caught TypeError
+var sealed = Object.seal(['b', 'a']);
+print(sealed.sort().join());
+// CHECK-NEXT: a,b
+var withGetter = [3, 2, 1];
+Object.defineProperty(withGetter, 1, {
+  get: function () {
+    print('getter');
+    return 2;
+  },
+  set: function (v) {},
+});
+print(withGetter.sort().join());
+// CHECK: getter
+// CHECK: 1,2,3
+
+// Large inputs with existing runs, compared with and without a comparator.
+function check(name, a) {
+  var copy = a.slice();
+  copy.sort(function (x, y) {
+    return x.key - y.key;
+  });
+  var ok = true;
+  for (var i = 1; i < copy.length; i++) {
+    var p = copy[i - 1];
+    var c = copy[i];
+    if (p.key > c.key || (p.key === c.key && p.idx > c.idx)) ok = false;
+  }
+  var keys = a.map(function (x) {
+    return x.key;
+  });
+  var byString = keys.slice().sort();
+  var expected = keys
+    .map(String)
+    .sort()
+    .join();
+  print(name, ok, byString.join() === expected);
+}
+function make(n, f) {
+  var a = [];
+  for (var i = 0; i < n; i++) a.push({key: f(i), idx: i});
+  return a;
+}
+var seed = 1;
+function random() {
+  seed = (seed * 16807) % 2147483647;
+  return seed;
+}
+check('random', make(5000, function () { return random() % 500; }));
+// CHECK-NEXT: random true true
+check('sorted', make(5000, function (i) { return i >> 2; }));
+// CHECK-NEXT: sorted true true
+check('reversed', make(5000, function (i) { return 5000 - i; }));
+// CHECK-NEXT: reversed true true
+check('reversed-dups', make(5000, function (i) { return (5000 - i) >> 3; }));
+// CHECK-NEXT: reversed-dups true true
+check('sawtooth', make(5000, function (i) { return i % 97; }));
+// CHECK-NEXT: sawtooth true true
+check('mostly-sorted', make(5000, function (i) {
+  return random() % 50 === 0 ? random() % 5000 : i;
+}));
+// CHECK-NEXT: mostly-sorted true true
+
+// Exceptions thrown by the comparator propagate.
+try {
+  make(100, function (i) { return i; }).sort(function (x, y) {
+    if (x.key === 50) throw new Error('cmp');
+    return y.key - x.key;
+  });
+} catch (e) {
+  print('caught', e.message);
+}
+// CHECK-NEXT: caught cmp
+
+// Typed arrays sort numerically by default, with -0 before +0 and NaN last.
+function show(ta) {
+  return Array.prototype.map.call(ta, function (x) {
+    return Object.is(x, -0) ? '-0' : String(x);
+  }).join();
+}
+var f64 = new Float64Array([3, NaN, 0, -0, -Infinity, 1.5, NaN, -2, -0]);
+print(show(f64.sort()));
+// CHECK-NEXT: -Infinity,-2,-0,-0,0,1.5,3,NaN,NaN
+print(show(new Float32Array([0.5, NaN, -0, 0, -1]).sort()));
+// CHECK-NEXT: -1,-0,0,0.5,NaN
+print(show(new Int8Array([100, -100, 10, -1, 0]).sort()));
+// CHECK-NEXT: -100,-1,0,10,100
+print(show(new Uint32Array([4000000000, 5, 300]).sort()));
+// CHECK-NEXT: 5,300,4000000000
+print(show(new BigInt64Array([5n, -3n, 0n]).sort()));
+// CHECK-NEXT: -3,0,5
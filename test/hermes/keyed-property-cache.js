@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// Exercise the property caches of GetByVal/PutByVal with string, symbol and
+// index keys.
+
+function get(o, k) {
+  return o[k];
+}
+function put(o, k, v) {
+  o[k] = v;
+}
+
+var keys = ['a', 'b', 'c', 'd', 'e', 'f'];
+var o = {a: 1, b: 2, c: 3, d: 4, e: 5, f: 6};
+var sum = 0;
+for (var iter = 0; iter < 3; ++iter) {
+  for (var i = 0; i < keys.length; ++i) {
+    put(o, keys[i], o[keys[i]] + 1);
+    sum += get(o, keys[i]);
+  }
+}
+print(sum);
+// CHECK: 99
+
+// Keys built at runtime are not uniqued until used as a property name.
+var dyn = 'a' + String(1 + 1);
+var o2 = {a2: 'dyn'};
+print(get(o2, dyn), get(o2, dyn));
+// CHECK-NEXT: dyn dyn
+
+// Symbols.
+var sym = Symbol('s');
+var o3 = {};
+o3[sym] = 'sym';
+print(get(o3, sym));
+// CHECK-NEXT: sym
+put(o3, sym, 'sym2');
+print(get(o3, sym));
+// CHECK-NEXT: sym2
+
+// The same key on objects with different classes.
+var p = {x: 'p'};
+var q = {y: 0, x: 'q'};
+print(get(p, 'x'), get(q, 'x'), get(p, 'x'));
+// CHECK-NEXT: p q p
+
+// Properties from the prototype are found but writes create own properties.
+var proto = {inherited: 'proto'};
+var child = Object.create(proto);
+print(get(child, 'inherited'));
+// CHECK-NEXT: proto
+put(child, 'inherited', 'own');
+print(get(child, 'inherited'), get(proto, 'inherited'));
+// CHECK-NEXT: own proto
+
+// Non-writable properties must not be written through the cache.
+var ro = {v: 1};
+put(ro, 'v', 2);
+Object.defineProperty(ro, 'v', {writable: false});
+put(ro, 'v', 3);
+print(get(ro, 'v'));
+// CHECK-NEXT: 2
+
+// Accessors are called every time.
+var count = 0;
+var acc = {
+  get g() {
+    return ++count;
+  },
+};
+print(get(acc, 'g'), get(acc, 'g'));
+// CHECK-NEXT: 1 2
+
+// Index keys on arrays, including holes, frozen arrays and typed arrays.
+var arr = [1, , 3];
+Array.prototype[1] = 'hole';
+print(get(arr, 0), get(arr, 1), get(arr, 2), get(arr, '2'));
+// CHECK-NEXT: 1 hole 3 3
+delete Array.prototype[1];
+put(arr, 0, 10);
+put(arr, 1, 20);
+print(arr.join());
+// CHECK-NEXT: 10,20,3
+Object.freeze(arr);
+put(arr, 0, 100);
+print(get(arr, 0));
+// CHECK-NEXT: 10
+var ta = new Int8Array([5, 6]);
+put(ta, 1, 300);
+print(get(ta, 0), get(ta, 1), get(ta, 2));
+// CHECK-NEXT: 5 44 undefined
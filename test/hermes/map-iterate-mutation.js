@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -gc-sanitize-handles=1 %s | %FileCheck --match-full-lines %s
+
+// Iterators must keep their position while the map is mutated, including
+// when deletions make it compact its storage or it is cleared.
+
+print('iterate-mutation');
+// CHECK-LABEL: iterate-mutation
+
+function range(n) {
+  var m = new Map();
+  for (var i = 0; i < n; i++) m.set(i, i);
+  return m;
+}
+
+// Delete everything ahead of a paused iterator except a few entries, which
+// compacts the storage.
+(function () {
+  var m = range(100);
+  var it = m.keys();
+  print(it.next().value, it.next().value);
+  for (var i = 2; i < 100; i++) {
+    if (i % 30 !== 0) m.delete(i);
+  }
+  var rest = [];
+  for (var k of it) rest.push(k);
+  print(rest.join(','));
+})();
+// CHECK-NEXT: 0 1
+// CHECK-NEXT: 30,60,90
+
+// Delete the entries behind a paused iterator.
+(function () {
+  var m = range(64);
+  var it = m.values();
+  for (var i = 0; i < 40; i++) it.next();
+  for (var i = 0; i < 40; i++) m.delete(i);
+  m.set('x', 'x');
+  var sum = 0;
+  var last;
+  for (var v of it) {
+    if (typeof v === 'number') sum += v;
+    last = v;
+  }
+  print(sum, last, m.size);
+})();
+// CHECK-NEXT: 1236 x 25
+
+// Entries added during iteration are visited, deleted ones are not.
+(function () {
+  var s = new Set([1, 2, 3]);
+  var seen = [];
+  s.forEach(function (v) {
+    seen.push(v);
+    if (v < 20) s.add(v * 10);
+    s.delete(v + 1);
+  });
+  print(seen.join(','));
+})();
+// CHECK-NEXT: 1,3,10,30,100
+
+// Clearing restarts paused iterators at the new entries.
+(function () {
+  var m = range(10);
+  var it1 = m.entries();
+  var it2 = m.keys();
+  it1.next();
+  it1.next();
+  m.clear();
+  m.set('a', 1).set('b', 2);
+  print(JSON.stringify(it1.next().value), it2.next().value);
+  m.clear();
+  print(it1.next().done, it2.next().done);
+  m.set('c', 3);
+  print(it1.next().done, it2.next().done);
+})();
+// CHECK-NEXT: ["a",1] a
+// CHECK-NEXT: true true
+// CHECK-NEXT: true true
+
+// A paused iterator survives several compactions.
+(function () {
+  var s = new Set();
+  for (var i = 0; i < 1000; i++) s.add(i);
+  var it = s.values();
+  for (var i = 0; i < 500; i++) it.next();
+  for (var round = 0; round < 5; round++) {
+    for (var i = 0; i < 1000; i++) {
+      if (i % 2 === round % 2) s.delete(i);
+      else s.add(i + 1000 * (round + 1));
+    }
+  }
+  var count = 0;
+  var first;
+  for (var v of it) {
+    if (first === undefined) first = v;
+    count++;
+  }
+  print(first, count, s.size);
+})();
+// CHECK-NEXT: 1001 2500 2500
+
+// Interleave deletes and inserts on a large map while iterating it.
+(function () {
+  var m = range(20000);
+  var visited = 0;
+  var sum = 0;
+  for (var [k, v] of m) {
+    visited++;
+    sum += v;
+    if (k < 20000) {
+      m.delete(k);
+      if (k % 4 === 0) m.set(k + 20000, k);
+    }
+  }
+  print(visited, sum, m.size);
+})();
+// CHECK-NEXT: 25000 249980000 5000
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// Exercise property access sites that observe several hidden classes, so that
+// they go through the polymorphic and megamorphic cache states.
+
+function getX(o) {
+  return o.x;
+}
+function setX(o, v) {
+  o.x = v;
+}
+
+// Objects with 'x' at different slots.
+var shapes = [
+  {x: 0},
+  {a: 1, x: 0},
+  {a: 1, b: 2, x: 0},
+  {a: 1, b: 2, c: 3, x: 0},
+  {a: 1, b: 2, c: 3, d: 4, x: 0},
+  {a: 1, b: 2, c: 3, d: 4, e: 5, x: 0},
+];
+
+function run(n) {
+  var sum = 0;
+  for (var iter = 0; iter < 3; ++iter) {
+    for (var i = 0; i < n; ++i) {
+      setX(shapes[i], i + 1);
+      sum += getX(shapes[i]);
+    }
+  }
+  return sum;
+}
+
+print(run(2));
+// CHECK: 9
+print(run(4));
+// CHECK-NEXT: 30
+// More shapes than fit in the per-site cache.
+print(run(6));
+// CHECK-NEXT: 63
+
+// Every object must still read its own value.
+print(shapes.map(getX).join());
+// CHECK-NEXT: 1,2,3,4,5,6
+
+// A non-writable property must not be written through a cached slot.
+var frozen = {a: 1, b: 2, c: 3, d: 4, e: 5, f: 6, x: 'frozen'};
+Object.freeze(frozen);
+setX(frozen, 'changed');
+print(getX(frozen));
+// CHECK-NEXT: frozen
+
+// Prototype lookups mixed with own lookups at the same site.
+var proto = {x: 'proto'};
+var child = Object.create(proto);
+print(getX(child));
+// CHECK-NEXT: proto
+child.x = 'own';
+print(getX(child));
+// CHECK-NEXT: own
+print(getX(shapes[0]));
+// CHECK-NEXT: 1
+
+// Accessors must not be cached.
+var withGetter = {
+  get x() {
+    return 'getter';
+  },
+};
+print(getX(withGetter));
+// CHECK-NEXT: getter
@@ -6,6 +6,7 @@
  */
 
 // RUN: LC_ALL=en_US.UTF-8 %hermes -non-strict -O -target=HBC %s | %FileCheck --match-full-lines %s
+// RUN: LC_ALL=en_US.UTF-8 %hermes -Xregex-engine=linear -non-strict -O -target=HBC %s | %FileCheck --match-full-lines %s
 
 print('RegExp icase');
 // CHECK-LABEL: RegExp icase
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -Xregex-engine=linear %s | %FileCheck --match-full-lines %s
+
+// The linear-time executor must find the same matches and captures as the
+// backtracking executor, which runs these by default. Patterns that backtrack
+// excessively switch to the linear-time executor.
+
+print('linear');
+// CHECK-LABEL: linear
+
+function show(re, str) {
+  re.lastIndex = 0;
+  return JSON.stringify(re.exec(str));
+}
+
+// Priority of alternatives and greediness.
+print(show(/a|ab/, 'abc'));
+// CHECK-NEXT: ["a"]
+print(show(/ab|a/, 'abc'));
+// CHECK-NEXT: ["ab"]
+print(show(/(a*)(a*)/, 'aaa'));
+// CHECK-NEXT: ["aaa","aaa",""]
+print(show(/(a*?)(a*)/, 'aaa'));
+// CHECK-NEXT: ["aaa","","aaa"]
+print(show(/(a+?)(a*?)b/, 'xaaab'));
+// CHECK-NEXT: ["aaab","a","aa"]
+print(show(/(\d+)\.(\d+)?/, 'v12.'));
+// CHECK-NEXT: ["12.","12",null]
+print(show(/x*y+$/, 'xxyyxyy'));
+// CHECK-NEXT: ["xyy"]
+
+// Captures inside loops are reset on each iteration.
+print(show(/(?:(a)|b)+/, 'ab'));
+// CHECK-NEXT: ["ab",null]
+print(show(/(z)((a+)?(b+)?(c))*/, 'zaacbbbcac'));
+// CHECK-NEXT: ["zaacbbbcac","z","ac","a",null,"c"]
+print(show(/(a|ab)(c|bcd)(d*)/, 'abcd'));
+// CHECK-NEXT: ["abcd","a","bcd",""]
+
+// Counted loops.
+print(show(/(?:ab){2,3}/, 'abababab'));
+// CHECK-NEXT: ["ababab"]
+print(show(/(?:ab){2,3}?/, 'abababab'));
+// CHECK-NEXT: ["abab"]
+print(show(/a{3}/, 'aab aaab'));
+// CHECK-NEXT: ["aaa"]
+print(show(/^(?:a{2})*$/, 'aaaaa'));
+// CHECK-NEXT: null
+
+// Loops whose body can match the empty string.
+print(show(/(a*)*b/, 'aab'));
+// CHECK-NEXT: ["aab","aa"]
+print(show(/(a|)+b/, 'aab'));
+// CHECK-NEXT: ["aab","a"]
+print(show(/(?:a?)*?x/, 'aax'));
+// CHECK-NEXT: ["aax"]
+print(show(/(?:|a)*/, 'aaa'));
+// CHECK-NEXT: ["aaa"]
+
+// Anchors and word boundaries.
+print(show(/^b/m, 'a\nb'));
+// CHECK-NEXT: ["b"]
+print(show(/a$/m, 'a\nb'));
+// CHECK-NEXT: ["a"]
+print(show(/\bfoo\b/, 'foobar foo'));
+// CHECK-NEXT: ["foo"]
+print(show(/\Bo+/, 'foo'));
+// CHECK-NEXT: ["oo"]
+
+// Multi-unit instructions, case folding and Unicode.
+print(show(/hello world/i, 'say HELLO WORLD'));
+// CHECK-NEXT: ["HELLO WORLD"]
+print(show(/.b/u, '\u{1F600}b'));
+// CHECK-NEXT: ["😀b"]
+print(show(/[\u{1F600}-\u{1F64F}]+/u, 'x\u{1F600}\u{1F601}y'));
+// CHECK-NEXT: ["😀😁"]
+print(show(/\u{1F600}|x/u, '\u{1F600}'));
+// CHECK-NEXT: ["😀"]
+print(show(/[^a]/u, '\u{1F600}'));
+// CHECK-NEXT: ["😀"]
+
+// Sticky and global searches.
+var sticky = /a+/y;
+sticky.lastIndex = 1;
+print(JSON.stringify(sticky.exec('baab')), sticky.lastIndex);
+// CHECK-NEXT: ["aa"] 3
+print(JSON.stringify('xaxaax'.match(/a+/g)));
+// CHECK-NEXT: ["a","aa"]
+print('a1b22c333'.replace(/(\d)+/g, '<$1>'));
+// CHECK-NEXT: a<1>b<2>c<3>
+
+// Patterns that backtrack exponentially run in linear time.
+var as = 'a'.repeat(40);
+print(show(/(a+)+b/, as));
+// CHECK-NEXT: null
+print(show(/^(a|aa)*$/, as + 'b'));
+// CHECK-NEXT: null
+print(show(/(x+x+)+y/, 'x'.repeat(40) + 'y'));
+// CHECK-NEXT: ["xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxy","xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"]
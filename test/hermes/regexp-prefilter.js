@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Matches must be found at the same positions when the executor skips start
+// positions that can't match.
+
+print('prefilter');
+// CHECK-LABEL: prefilter
+
+function show(re, str) {
+  re.lastIndex = 0;
+  var m = re.exec(str);
+  return m ? m.index + ':' + JSON.stringify(m[0]) : 'null';
+}
+
+var long = 'x'.repeat(1000);
+
+// Literal prefixes.
+print(show(/foo\d+/, long + 'fo foo foo12 foo3'));
+// CHECK-NEXT: 1007:"foo12"
+print(show(/foo\d+/, long + 'foo'));
+// CHECK-NEXT: null
+print(show(/abc/, 'ab'));
+// CHECK-NEXT: null
+print(show(/(a(b))c/, 'aababc'));
+// CHECK-NEXT: 3:"abc"
+print(show(/été/, 'ete été'));
+// CHECK-NEXT: 4:"été"
+print(show(/a+b/, 'a aab'));
+// CHECK-NEXT: 2:"aab"
+
+// First character sets.
+print(show(/[a-z]+@example/, long.toUpperCase() + ' joe@example'));
+// CHECK-NEXT: 1001:"joe@example"
+print(show(/\d{2}|x\d/, 'ab1 x2 34'));
+// CHECK-NEXT: 4:"x2"
+print(show(/(?:ab|cd)+/, 'xxcdab'));
+// CHECK-NEXT: 2:"cdab"
+print(show(/\s+z/, 'a\u00a0z').length);
+// CHECK-NEXT: 6
+print(show(/\w\w/, '!!éa_b'));
+// CHECK-NEXT: 3:"a_"
+
+// Patterns that can match the empty string match at the start.
+print(show(/a*/, 'bbb'));
+// CHECK-NEXT: 0:""
+print(show(/(?:a|)b?/, 'ccc'));
+// CHECK-NEXT: 0:""
+print(show(/$/, 'abc'));
+// CHECK-NEXT: 3:""
+print(show(/(a)?\1b/, 'xxb'));
+// CHECK-NEXT: 2:"b"
+
+// Zero-width assertions don't consume.
+print(show(/(?<=a)b/, 'bbab'));
+// CHECK-NEXT: 3:"b"
+print(show(/(?=b)\w/, 'aab'));
+// CHECK-NEXT: 2:"b"
+print(show(/\bfoo/, 'afoo foo'));
+// CHECK-NEXT: 5:"foo"
+print(show(/^b/m, 'a\nb'));
+// CHECK-NEXT: 2:"b"
+
+// Case insensitivity.
+print(show(/FOO/i, 'xxfOo'));
+// CHECK-NEXT: 2:"fOo"
+print(show(/[a-c]x/i, 'yyBX'));
+// CHECK-NEXT: 2:"BX"
+print(show(/k/iu, 'ab\u212a').length);
+// CHECK-NEXT: 5
+print(show(/ſ/iu, 'abS'));
+// CHECK-NEXT: 2:"S"
+print(show(/ſ/i, 'abS'));
+// CHECK-NEXT: null
+print(show(/[a-z]/iu, '!ſ'));
+// CHECK-NEXT: 1:"ſ"
+
+// Surrogate pairs in unicode mode.
+print(show(/\udc00/u, '𐀀\udc00'));
+// CHECK-NEXT: 2:"\udc00"
+print(show(/\udc00/, '𐀀'));
+// CHECK-NEXT: 1:"\udc00"
+print(show(/[\u{10000}-\u{10010}]x/u, 'x\u{10001}x'));
+// CHECK-NEXT: 1:"𐀁x"
+
+// Global and sticky searches start at lastIndex.
+var re = /ab/g;
+re.lastIndex = 3;
+print(show(re, 'ab ab ab'), re.exec('ab ab ab').index);
+// CHECK-NEXT: 0:"ab" 3
+var sticky = /ab/y;
+sticky.lastIndex = 1;
+print(sticky.exec('xxab'), sticky.lastIndex);
+// CHECK-NEXT: null 0
+sticky.lastIndex = 2;
+print(sticky.exec('xxab'), sticky.lastIndex);
+// CHECK-NEXT: ab 4
+print('a1b22c333'.replace(/\d+/g, '#'));
+// CHECK-NEXT: a#b#c#
+print('aXbXc'.split(/X/).join());
+// CHECK-NEXT: a,b,c
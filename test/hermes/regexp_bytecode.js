@@ -13,6 +13,7 @@ print(/a\x01\u017f/i);
 // CHECK: RegExp Bytecodes:
 // CHECK:       0: /a\x01\u017f/i
 // CHECK-NEXT:    Header: marked: 0 loops: 0 flags: 1 constraints: 5
+// CHECK-NEXT:    Prefilter: first chars [Aa]
 // CHECK-NEXT:    0000  MatchCharICase8: 'A'
 // CHECK-NEXT:    0002  MatchCharICase8: 0x01
 // CHECK-NEXT:    0004  MatchCharICase16: 0x17f
@@ -21,6 +22,7 @@ print(/a\x01\u017f/i);
 print(/^a\u017f\x01$/);
 // CHECK:       1: /^a\u017f\x01$/
 // CHECK-NEXT:    Header: marked: 0 loops: 0 flags: 0 constraints: 7
+// CHECK-NEXT:    Prefilter: first chars [a] prefix 'a0x17f0x01'
 // CHECK-NEXT:    0000  LeftAnchor
 // CHECK-NEXT:    0001  MatchChar8: 'a'
 // CHECK-NEXT:    0003  MatchChar16: 0x17f
@@ -31,6 +33,7 @@ print(/^a\u017f\x01$/);
 print(/^a|b/);
 // CHECK:       2: /^a|b/
 // CHECK-NEXT:    Header: marked: 0 loops: 0 flags: 0 constraints: 4
+// CHECK-NEXT:    Prefilter: first chars [a-b]
 // CHECK-NEXT:    0000  Alternation: Target 0x0f, constraints 6,4
 // CHECK-NEXT:    0007  LeftAnchor
 // CHECK-NEXT:    0008  MatchChar8: 'a'
@@ -41,6 +44,7 @@ print(/^a|b/);
 print(/[a-z][^A-Z0-9_\d][\s][abc]/);
 // CHECK:       3: /[a-z][^A-Z0-9_\d][\s][abc]/
 // CHECK-NEXT:    Header: marked: 0 loops: 0 flags: 0 constraints: 4
+// CHECK-NEXT:    Prefilter: first chars [a-z]
 // CHECK-NEXT:  0000  Bracket: [a-z]
 // CHECK-NEXT:  000e  Bracket: [^\d0-9A-Z_]
 // CHECK-NEXT:  002c  Bracket: [\s]
@@ -50,6 +54,7 @@ print(/[a-z][^A-Z0-9_\d][\s][abc]/);
 print(/a(b(c)(d))e\1\2/);
 // CHECK:       4: /a(b(c)(d))e\1\2/
 // CHECK-NEXT:    Header: marked: 3 loops: 0 flags: 0 constraints: 4
+// CHECK-NEXT:    Prefilter: first chars [a] prefix 'abcde'
 // CHECK-NEXT:    0000  MatchChar8: 'a'
 // CHECK-NEXT:    0002  BeginMarkedSubexpression: 0
 // CHECK-NEXT:    0005  MatchChar8: 'b'
@@ -74,6 +79,7 @@ print(/\b\B/);
 
 print(/abc(?=^)(?!def)/i);
 // CHECK: Header: marked: 0 loops: 0 flags: 1 constraints: 6
+// CHECK-NEXT: Prefilter: first chars [Aa]
 // CHECK-NEXT: 0000  MatchNCharICase8: 'ABC'
 // CHECK-NEXT: 0005  Lookaround: = (constraints: 2, marked expressions=[0,0), continuation 0x13)
 // CHECK-NEXT: 0011  LeftAnchor
@@ -86,6 +92,7 @@ print(/abc(?=^)(?!def)/i);
 print(/ab*c+d{3,5}/);
 // CHECK:        7: /ab*c+d{3,5}/
 // CHECK-NEXT:    Header: marked: 0 loops: 3 flags: 0 constraints: 4
+// CHECK-NEXT:    Prefilter: first chars [a] prefix 'a'
 // CHECK-NEXT:    0000  MatchChar8: 'a'
 // CHECK-NEXT:    0002  Width1Loop: 0 greedy {0, 4294967295}
 // CHECK-NEXT:    0014  MatchChar8: 'b'
@@ -98,6 +105,7 @@ print(/ab*c+d{3,5}/);
 print(/a((b+){3})*/);
 // CHECK:        8: /a((b+){3})*/
 // CHECK-NEXT:    Header: marked: 2 loops: 3 flags: 0 constraints: 4
+// CHECK-NEXT:    Prefilter: first chars [a] prefix 'a'
 // CHECK-NEXT:     0000  MatchChar8: 'a'
 // CHECK-NEXT:     0002  BeginLoop: 2 greedy {0, 4294967295} (constraints: 4)
 // CHECK-NEXT:     0019  BeginMarkedSubexpression: 0
@@ -114,6 +122,7 @@ print(/a((b+){3})*/);
 print(/(^b)+(c)*?/);
 // CHECK:        9: /(^b)+(c)*?/
 // CHECK-NEXT:    Header: marked: 2 loops: 2 flags: 0 constraints: 6
+// CHECK-NEXT:    Prefilter: first chars [b] prefix 'b'
 // CHECK-NEXT:     0000  BeginLoop: 0 greedy {1, 4294967295} (constraints: 6)
 // CHECK-NEXT:     0017  BeginMarkedSubexpression: 0
 // CHECK-NEXT:     001a  LeftAnchor
@@ -130,6 +139,7 @@ print(/(^b)+(c)*?/);
 print(/[\u017f]/i);
 // CHECK:        10: /[\u017f]/i
 // CHECK-NEXT:    Header: marked: 0 loops: 0 flags: 1 constraints: 5
+// CHECK-NEXT:    Prefilter: first chars [0x80-0xffff]
 // CHECK-NEXT:     0000  Bracket: [0x17f]
 // CHECK-NEXT:     000e  Goal
 
@@ -143,6 +153,7 @@ print(/a*/);
 print(/a+/);
 // CHECK:        12: /a+/
 // CHECK-NEXT:    Header: marked: 0 loops: 1 flags: 0 constraints: 4
+// CHECK-NEXT:    Prefilter: first chars [a] prefix 'a'
 // CHECK-NEXT:    0000  Width1Loop: 0 greedy {1, 4294967295}
 // CHECK-NEXT:    0012  MatchChar8: 'a'
 // CHECK-NEXT:    0014  Goal
@@ -189,6 +200,7 @@ print(/a*/i);
 print(/(a)(?=(.))/i);
 // CHECK:        18: /(a)(?=(.))/i
 // CHECK-NEXT:   Header: marked: 2 loops: 0 flags: 1 constraints: 4
+// CHECK-NEXT:   Prefilter: first chars [Aa]
 // CHECK-NEXT:   0000  BeginMarkedSubexpression: 0
 // CHECK-NEXT:   0003  MatchCharICase8: 'A'
 // CHECK-NEXT:   0005  EndMarkedSubexpression: 0
@@ -202,6 +214,7 @@ print(/(a)(?=(.))/i);
 print(/(a)(?<!(.))/i);
 // CHECK:        19: /(a)(?<!(.))/i
 // CHECK-NEXT:   Header: marked: 2 loops: 0 flags: 1 constraints: 4
+// CHECK-NEXT:   Prefilter: first chars [Aa]
 // CHECK-NEXT:   0000  BeginMarkedSubexpression: 0
 // CHECK-NEXT:   0003  MatchCharICase8: 'A'
 // CHECK-NEXT:   0005  EndMarkedSubexpression: 0
@@ -216,6 +229,7 @@ print(/(a)(?<!(.))/i);
 print(/aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaoverflow/);
 // CHECK:        20: /{{a{255}overflow}}/
 // CHECK-NEXT:   Header: marked: 0 loops: 0 flags: 0 constraints: 4
+// CHECK-NEXT:   Prefilter: first chars [a] prefix 'aaaaaaaa'
 // CHECK-NEXT:   0000  MatchNChar8: {{'a{255}'}}
 // CHECK-NEXT:   0101  MatchNChar8: 'overflow'
 // CHECK-NEXT:   010b  Goal
@@ -223,6 +237,7 @@ print(/aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa
 print(/aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaoverflow/i);
 // CHECK:        21: /{{a{255}overflow}}/i
 // CHECK-NEXT:   Header: marked: 0 loops: 0 flags: 1 constraints: 4
+// CHECK-NEXT:   Prefilter: first chars [Aa]
 // CHECK-NEXT:   0000  MatchNCharICase8: {{'A{255}'}}
 // CHECK-NEXT:   0101  MatchNCharICase8: 'OVERFLOW'
 // CHECK-NEXT:   010b  Goal
@@ -254,6 +269,7 @@ print(/./us);
 print(/a|b|c|d|e|f/);
 // CHECK:       26: /a|b|c|d|e|f/
 // CHECK-NEXT:    Header: marked: 0 loops: 0 flags: 0 constraints: 4
+// CHECK-NEXT:    Prefilter: first chars [a-f]
 // CHECK-NEXT:    0000  Alternation: Target 0x0e, constraints 4,4
 // CHECK-NEXT:    0007  MatchChar8: 'a'
 // CHECK-NEXT:    0009  Jump32: 0x48
@@ -275,6 +291,7 @@ print(/a|b|c|d|e|f/);
 print(/(abc|def)/);
 // CHECK:       27: /(abc|def)/
 // CHECK-NEXT:    Header: marked: 1 loops: 0 flags: 0 constraints: 4
+// CHECK-NEXT:    Prefilter: first chars [ad]
 // CHECK-NEXT:    0000  BeginMarkedSubexpression: 0
 // CHECK-NEXT:    0003  Alternation: Target 0x14, constraints 4,4
 // CHECK-NEXT:    000a  MatchNChar8: 'abc'
@@ -9,9 +9,13 @@
 #include "hermes/BCGen/HBC/BytecodeDisassembler.h"
 #include "hermes/BCGen/HBC/BytecodeStream.h"
 #include "hermes/BCGen/HBC/HBC.h"
+#include "hermes/Inst/InstDecode.h"
 #include "hermes/Parser/JSONParser.h"
 
+#include "llvh/ADT/DenseMap.h"
+
 #include <set>
+#include <tuple>
 #include <vector>
 
 // Allow using inst::OpCode as key in unordered_map.
@@ -888,6 +892,133 @@ void ProfileAnalyzer::dumpFunctionInfo(uint32_t funcId, JSONEmitter &json) {
   json.closeDict();
 }
 
+PropertyCacheStatistics ProfileAnalyzer::computePropertyCacheStatistics(
+    uint32_t funcId) {
+  auto bcProvider = hbcParser_.getBCProvider();
+  auto header = bcProvider->getFunctionHeader(funcId);
+
+  PropertyCacheStatistics stats;
+  stats.funcId = funcId;
+  stats.readCaches = header.highestReadCacheIndex();
+  stats.writeCaches = header.highestWriteCacheIndex();
+
+  // Number of sites using each cache, keyed by (isWrite << 16 | index).
+  llvh::DenseMap<uint32_t, uint32_t> cacheUsers;
+  const uint8_t *bytecodeStart = bcProvider->getBytecode(funcId);
+  const uint8_t *bytecodeEnd = bytecodeStart + header.bytecodeSizeInBytes();
+  for (const uint8_t *ip = bytecodeStart; ip < bytecodeEnd;) {
+    auto decoded =
+        inst::decodeInstruction(reinterpret_cast<const inst::Inst *>(ip));
+    ip += decoded.meta.size;
+
+    bool isWrite;
+    bool isNamed = true;
+    unsigned cacheOperand = 2;
+    switch (decoded.meta.opCode) {
+      case OpCode::GetByIdShort:
+      case OpCode::GetById:
+      case OpCode::GetByIdLong:
+      case OpCode::TryGetById:
+      case OpCode::TryGetByIdLong:
+        isWrite = false;
+        break;
+      case OpCode::PutById:
+      case OpCode::PutByIdLong:
+      case OpCode::TryPutById:
+      case OpCode::TryPutByIdLong:
+        isWrite = true;
+        break;
+      case OpCode::GetByVal:
+        isWrite = false;
+        isNamed = false;
+        cacheOperand = 3;
+        break;
+      case OpCode::PutByVal:
+        isWrite = true;
+        isNamed = false;
+        cacheOperand = 3;
+        break;
+      default:
+        continue;
+    }
+
+    auto cacheIdx = decoded.operandValue[cacheOperand].integer;
+    if (cacheIdx == PROPERTY_CACHING_DISABLED) {
+      // Keyed sites also go without a cache when the key is a number, so only
+      // named sites are reported.
+      if (isNamed) {
+        ++stats.sites;
+        ++stats.uncachedSites;
+      }
+      continue;
+    }
+    ++stats.sites;
+    if (cacheIdx > PROPERTY_CACHE_SHORT_INDEX_MAX)
+      ++stats.longIndexSites;
+    ++cacheUsers[(uint32_t)isWrite << 16 | cacheIdx];
+  }
+
+  for (const auto &entry : cacheUsers) {
+    if (entry.second > 1)
+      stats.sharedSites += entry.second;
+  }
+  return stats;
+}
+
+void ProfileAnalyzer::emitPropertyCacheStatistics(
+    const PropertyCacheStatistics &stats,
+    JSONEmitter &json) {
+  auto bcProvider = hbcParser_.getBCProvider();
+  json.openDict();
+  json.emitKeyValue("FunctionID", stats.funcId);
+  json.emitKeyValue(
+      "Name",
+      bcProvider->getStringRefFromID(
+          bcProvider->getFunctionHeader(stats.funcId).functionName()));
+  json.emitKeyValue("ReadCaches", stats.readCaches);
+  json.emitKeyValue("WriteCaches", stats.writeCaches);
+  json.emitKeyValue("Sites", stats.sites);
+  json.emitKeyValue("SharedSites", stats.sharedSites);
+  json.emitKeyValue("LongIndexSites", stats.longIndexSites);
+  json.emitKeyValue("UncachedSites", stats.uncachedSites);
+  json.closeDict();
+}
+
+void ProfileAnalyzer::dumpPropertyCacheStats(
+    uint32_t funcId,
+    JSONEmitter &json) {
+  if (funcId >= hbcParser_.getBCProvider()->getFunctionCount()) {
+    os_ << "FunctionID " << funcId << " is invalid.\n";
+    return;
+  }
+  emitPropertyCacheStatistics(computePropertyCacheStatistics(funcId), json);
+}
+
+void ProfileAnalyzer::dumpAllPropertyCacheStats(JSONEmitter &json) {
+  std::vector<PropertyCacheStatistics> affected;
+  for (uint32_t i = 0, e = hbcParser_.getBCProvider()->getFunctionCount();
+       i < e;
+       ++i) {
+    auto stats = computePropertyCacheStatistics(i);
+    if (stats.sharedSites || stats.longIndexSites || stats.uncachedSites)
+      affected.push_back(stats);
+  }
+  // Missing caches hurt the most, followed by sites evicting each other.
+  std::stable_sort(
+      affected.begin(),
+      affected.end(),
+      [](const PropertyCacheStatistics &a, const PropertyCacheStatistics &b) {
+        return std::make_tuple(
+                   a.uncachedSites, a.sharedSites, a.longIndexSites) >
+            std::make_tuple(b.uncachedSites, b.sharedSites, b.longIndexSites);
+      });
+
+  json.openArray();
+  for (const auto &stats : affected)
+    emitPropertyCacheStatistics(stats, json);
+  json.closeArray();
+}
+
 llvh::Optional<uint32_t> ProfileAnalyzer::getFunctionFromVirtualOffset(
     uint32_t virtualOffset) {
   auto *bcProvider = hbcParser_.getBCProvider().get();
@@ -44,6 +44,22 @@ struct FunctionRuntimeStatistics {
   std::unordered_map<uint16_t, uint64_t> basicBlockStats;
 };
 
+// Static property cache usage of a function.
+struct PropertyCacheStatistics {
+  uint32_t funcId{0};
+  // Number of read and write caches allocated for the function.
+  uint32_t readCaches{0};
+  uint32_t writeCaches{0};
+  // Instructions that use a property cache.
+  uint32_t sites{0};
+  // Sites whose cache is also used by other sites.
+  uint32_t sharedSites{0};
+  // Sites with a cache index that doesn't fit in 8 bits.
+  uint32_t longIndexSites{0};
+  // *ById sites that were left without a cache.
+  uint32_t uncachedSites{0};
+};
+
 /// Analyzer for basic block profile trace.
 class ProfileAnalyzer {
  private:
@@ -95,6 +111,14 @@ class ProfileAnalyzer {
   /// Build and cache each function's runtime statistics map if not built yet.
   void buildFunctionRuntimeStatisticsMapIfNeeded();
 
+  /// Compute the property cache usage of function \p funcId from its bytecode.
+  PropertyCacheStatistics computePropertyCacheStatistics(uint32_t funcId);
+
+  /// Print \p stats as a JSON dictionary.
+  void emitPropertyCacheStatistics(
+      const PropertyCacheStatistics &stats,
+      JSONEmitter &json);
+
   /// Check if  funcId has any basic block number overflow(more than 2^16
   /// blocks) and report it.
   void checkAndReportAccuracyForFunction(unsigned funcId);
@@ -167,6 +191,11 @@ class ProfileAnalyzer {
     }
     json.closeArray();
   }
+  // Print property cache usage for \p funcId.
+  void dumpPropertyCacheStats(uint32_t funcId, JSONEmitter &json);
+  // Print property cache usage for all functions with shared or missing
+  // caches, most affected first.
+  void dumpAllPropertyCacheStats(JSONEmitter &json);
   // Return the ID of the function, if any, found at a given virtual offset.
   llvh::Optional<uint32_t> getFunctionFromVirtualOffset(uint32_t virtualOffset);
 
@@ -170,6 +170,11 @@ static void printHelp(llvh::Optional<llvh::StringRef> command = llvh::None) {
        "Display info about a specific function, or all functions\n\n"
        "USAGE: function-info [<FUNC_ID>]\n"
        "NOTE: Virtual offset is the offset from the beginning of the segment\n"},
+      {"prop-cache",
+       "Display property cache usage of a specific function, or of all "
+       "functions where caches are shared between instructions, need long "
+       "cache indices, or were unavailable.\n\n"
+       "USAGE: prop-cache [<FUNC_ID>]\n"},
       {"string",
        "Display string for ID\n\n"
        "USAGE: string <STRING_ID>\n"},
@@ -385,6 +390,21 @@ static bool executeCommand(
       printHelp(command);
       return false;
     }
+  } else if (command == "prop-cache") {
+    JSONEmitter json(os, /* pretty */ true);
+    if (commandTokens.size() == 1) {
+      analyzer.dumpAllPropertyCacheStats(json);
+    } else if (commandTokens.size() == 2) {
+      uint32_t funcId;
+      if (commandTokens[1].getAsInteger(0, funcId)) {
+        os << "Error: cannot parse func_id as integer.\n";
+        return false;
+      }
+      analyzer.dumpPropertyCacheStats(funcId, json);
+    } else {
+      printHelp(command);
+      return false;
+    }
   } else if (command == "io") {
     analyzer.dumpIO();
   } else if (command == "summary" || command == "sum") {
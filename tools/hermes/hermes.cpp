@@ -54,6 +54,19 @@ static opt<bool> GCRevertToYGAtTTI(
     cat(GCCategory),
     init(false));
 
+static opt<unsigned> GCParallelMarkThreads(
+    "gc-parallel-mark-threads",
+    desc("Number of helper threads used for concurrent old generation "
+         "marking"),
+    cat(GCCategory),
+    init(0));
+
+static opt<unsigned> GCParallelYGThreads(
+    "gc-parallel-yg-threads",
+    desc("Number of helper threads used for young generation collections"),
+    cat(GCCategory),
+    init(0));
+
 static opt<bool> GCBeforeStats(
     "gc-before-stats",
     desc("Perform a full GC just before printing statistics at exit"),
@@ -95,6 +108,8 @@ static int executeHBCBytecodeFromCL(
                             .withShouldReleaseUnused(vm::kReleaseUnusedNone)
                             .withAllocInYoung(cl::GCAllocYoung)
                             .withRevertToYGAtTTI(cl::GCRevertToYGAtTTI)
+                            .withParallelMarkThreads(cl::GCParallelMarkThreads)
+                            .withParallelYGThreads(cl::GCParallelYGThreads)
                             .build())
           .withEnableBlockScoping(cl::EnableBlockScoping)
           .withEnableEval(cl::EnableEval)
@@ -106,6 +121,8 @@ static int executeHBCBytecodeFromCL(
           .withES6Proxy(cl::ES6Proxy)
           .withES6Class(cl::ES6Class)
           .withIntl(cl::Intl)
+      .withRegExpEngine(cl::RegExpEngine)
+          .withRegExpEngine(cl::RegExpEngine)
           .withMicrotaskQueue(cl::MicrotaskQueue)
           .withEnableSampleProfiling(cl::SampleProfiling)
           .withRandomizeMemoryLayout(cl::RandomizeMemoryLayout)
@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This benchmark tests the speed of property reads and writes where the key
+// is a string only known at runtime, as in reducers and translation tables.
+var KEYS = ['title', 'subtitle', 'label', 'placeholder'];
+
+function readKeys(o, keys) {
+    var len = 0;
+    for (var i = 0; i < keys.length; i++) {
+        len += o[keys[i]].length;
+    }
+    return len;
+}
+
+function writeKeys(o, keys, n) {
+    for (var i = 0; i < keys.length; i++) {
+        o[keys[i]] = n;
+    }
+}
+
+function run(numTimes) {
+    var strings = {
+        title: 'Title',
+        subtitle: 'Subtitle',
+        label: 'Label',
+        placeholder: 'Placeholder',
+    };
+    var counters = {title: 0, subtitle: 0, label: 0, placeholder: 0};
+    var total = 0;
+    for (var i = 0; i < numTimes; i++) {
+        total += readKeys(strings, KEYS);
+        writeKeys(counters, KEYS, i);
+    }
+    return total + counters.title;
+}
+
+print(run(2000000));
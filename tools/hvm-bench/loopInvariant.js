@@ -0,0 +1,33 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+// Loops whose bodies read values that don't change across iterations: the
+// properties of a local configuration object, the length of a local array and
+// variables of the enclosing function. Compile with -O to hoist them.
+
+function makeKernel(scale, bias) {
+  return function (n) {
+    var cfg = {step: 3, mask: 0xffff};
+    var table = [1, 2, 3, 4, 5, 6, 7, 8];
+    var acc = 0;
+    for (var i = 0; i < n; i++) {
+      acc = (acc + i * cfg.step + table.length) & cfg.mask;
+      if (scale) acc = (acc * 3 + 1) & 0xffff;
+      if (bias) acc = acc ^ 0x5a5a;
+    }
+    return acc;
+  };
+}
+
+var kernel = makeKernel(true, true);
+var result = 0;
+for (var i = 0; i < 200; i++) {
+  result = (result + kernel(100000)) | 0;
+}
+print(result);
@@ -0,0 +1,33 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This benchmark tests the speed of Map lookups with object and string keys
+// in a large Map, as used by caches.
+function run(numTimes, size) {
+    var objKeys = [];
+    var strKeys = [];
+    var m = new Map();
+    for (var i = 0; i < size; i++) {
+        objKeys.push({id: i});
+        strKeys.push('key' + i);
+        m.set(objKeys[i], i);
+        m.set(strKeys[i], i);
+    }
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        for (var j = 0; j < size; j++) {
+            sum += m.get(objKeys[j]);
+            sum += m.get(strKeys[j]);
+            if (m.has(j)) {
+                sum++;
+            }
+        }
+    }
+    return sum;
+}
+
+print(run(50, 100000));
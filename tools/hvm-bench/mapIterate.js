@@ -0,0 +1,31 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This benchmark tests the speed of iterating over a large Map with for-of,
+// forEach and the keys() iterator.
+function run(numTimes, size) {
+    var m = new Map();
+    for (var i = 0; i < size; i++) {
+        m.set(i, i * 2);
+    }
+    var sum = 0;
+    var add = function (v) {
+        sum += v;
+    };
+    for (var i = 0; i < numTimes; i++) {
+        for (var entry of m) {
+            sum += entry[1];
+        }
+        m.forEach(add);
+        for (var k of m.keys()) {
+            sum += k;
+        }
+    }
+    return sum;
+}
+
+print(run(50, 100000));
@@ -0,0 +1,26 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This benchmark tests the speed of inserting into and deleting from a Map,
+// which has to grow its storage and later drop the deleted entries.
+function run(numTimes, size) {
+    var total = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var m = new Map();
+        for (var j = 0; j < size; j++) {
+            m.set(j, j);
+            m.set('k' + j, j);
+        }
+        for (var j = 0; j < size; j += 2) {
+            m.delete(j);
+        }
+        total += m.size;
+    }
+    return total;
+}
+
+print(run(40, 100000));
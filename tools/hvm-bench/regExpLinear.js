@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+// Compare the regex executors by running this with -Xregex-engine=backtracking,
+// -Xregex-engine=linear and the default, which backtracks until it is
+// excessive. The pathological patterns backtrack exponentially in the length
+// of the input, so keep it short enough for the backtracking executor to
+// finish.
+
+(function() {
+  var numIter = 20;
+  var len = 2000;
+  var text = 'lorem ipsum dolor sit amet, user42@example.com '.repeat(len);
+  var typical = [/\w+@\w+\.com/g, /(\d+)-(\d+)/, /(?:sit|amet),\s+(\w+)/g];
+
+  var as = 'a'.repeat(20);
+  var pathological = [
+    [/(a+)+b/, as],
+    [/^(a|aa)*$/, as + 'b'],
+    [/(\w+\s?)+$/, 'word '.repeat(4) + '!'],
+  ];
+
+  for (var i = 0; i < numIter; i++) {
+    for (var j = 0; j < typical.length; j++) {
+      typical[j].lastIndex = 0;
+      while (typical[j].exec(text) && typical[j].global);
+    }
+    for (var j = 0; j < pathological.length; j++) {
+      pathological[j][0].exec(pathological[j][1]);
+    }
+  }
+
+  print('done');
+})();
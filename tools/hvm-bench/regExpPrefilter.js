@@ -0,0 +1,23 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 2000;
+  var len = 2000;
+  var s = 'abcd'.repeat(len) + 'foo123 bob@example';
+  var literal = /foo\d+/;
+  var firstChar = /[A-Z]+@example/i;
+
+  for (var i = 0; i < numIter; i++) {
+    literal.exec(s);
+    firstChar.exec(s);
+  }
+
+  print('done');
+})();
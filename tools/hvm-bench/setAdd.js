@@ -0,0 +1,22 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This benchmark tests the speed of adding to a Set, including duplicates.
+function run(numTimes, size) {
+    var total = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var s = new Set();
+        for (var j = 0; j < size; j++) {
+            s.add(j);
+            s.add(j >> 1);
+        }
+        total += s.size;
+    }
+    return total;
+}
+
+print(run(50, 100000));
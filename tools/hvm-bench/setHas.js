@@ -0,0 +1,29 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This benchmark tests the speed of Set membership tests, half of which miss.
+function run(numTimes, size) {
+    var s = new Set();
+    for (var i = 0; i < size; i++) {
+        s.add('item' + i);
+    }
+    var probes = [];
+    for (var i = 0; i < size * 2; i++) {
+        probes.push('item' + i);
+    }
+    var hits = 0;
+    for (var i = 0; i < numTimes; i++) {
+        for (var j = 0; j < probes.length; j++) {
+            if (s.has(probes[j])) {
+                hits++;
+            }
+        }
+    }
+    return hits;
+}
+
+print(run(50, 50000));
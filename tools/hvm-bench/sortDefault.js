@@ -0,0 +1,33 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This benchmark tests Array.prototype.sort without a comparator on random
+// numbers and strings.
+function run(numTimes, size) {
+    var seed = 1;
+    function random() {
+        seed = (seed * 16807) % 2147483647;
+        return seed;
+    }
+    var numbers = [];
+    var strings = [];
+    for (var i = 0; i < size; i++) {
+        numbers.push(random() % size);
+        strings.push('s' + (random() % size));
+    }
+    var total = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var a = numbers.slice();
+        a.sort();
+        var b = strings.slice();
+        b.sort();
+        total += a[size >> 1] + b[size >> 1].length;
+    }
+    return total;
+}
+
+print(run(20, 50000));
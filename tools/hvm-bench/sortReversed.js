@@ -0,0 +1,31 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This benchmark tests Array.prototype.sort with a comparator on numbers in
+// descending order.
+function run(numTimes, size) {
+    var seed = 1;
+    function random() {
+        seed = (seed * 16807) % 2147483647;
+        return seed;
+    }
+    var input = [];
+    for (var i = 0; i < size; i++) {
+        input.push(size - i);
+    }
+    var total = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var a = input.slice();
+        a.sort(function (x, y) {
+            return x - y;
+        });
+        total += a[size >> 1];
+    }
+    return total;
+}
+
+print(run(20, 50000));
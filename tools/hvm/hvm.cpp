@@ -141,6 +141,7 @@ int main(int argc, char **argv) {
           .withES6Proxy(cl::ES6Proxy)
           .withES6Class(ES6Class)
           .withIntl(cl::Intl)
+          .withRegExpEngine(cl::RegExpEngine)
           .withMicrotaskQueue(cl::MicrotaskQueue)
           .withTrackIO(cl::TrackBytecodeIO)
           .withEnableHermesInternal(cl::EnableHermesInternal)
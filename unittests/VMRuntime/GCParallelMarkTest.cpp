@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifdef HERMESVM_GC_HADES
+
+#include "TestHelpers.h"
+#include "gtest/gtest.h"
+#include "hermes/VM/DummyObject.h"
+#include "hermes/VM/GC.h"
+#include "hermes/VM/GCPointer-inline.h"
+#include "hermes/VM/Handle.h"
+
+#include "llvh/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+using namespace hermes::vm;
+
+namespace {
+
+using testhelpers::DummyObject;
+
+constexpr size_t kNumChains = 2048;
+constexpr size_t kChainLength = 4;
+
+/// Create a linked list of kChainLength DummyObjects, each of which increments
+/// \p numFinalized when it is finalized.
+static DummyObject *createChain(DummyRuntime &rt, int *numFinalized) {
+  GCScopeMarkerRAII marker{rt};
+  MutableHandle<DummyObject> head{rt};
+  for (size_t i = 0; i < kChainLength; ++i) {
+    auto *obj = DummyObject::create(rt.getHeap(), rt);
+    obj->finalizerCallback.set(
+        rt.getHeap(), new DummyObject::Callback([numFinalized]() mutable {
+          (*numFinalized)++;
+        }));
+    obj->setPointer(rt.getHeap(), head.get());
+    head = obj;
+  }
+  return head.get();
+}
+
+TEST(GCParallelMarkTest, MarksEverythingReachable) {
+  int liveFinalized = 0;
+  int deadFinalized = 0;
+  auto runtime = DummyRuntime::create(
+      GCConfig::Builder(kTestGCConfigBaseBuilder)
+          .withInitHeapSize(kInitHeapLarge)
+          .withMaxHeapSize(kMaxHeapLarge)
+          .withParallelMarkThreads(3)
+          .withShouldRecordStats(true)
+          .build());
+  DummyRuntime &rt = *runtime;
+  // One handle for each chain.
+  GCScope scope{rt, "GCParallelMarkTest", 2 * kNumChains + 8};
+
+  // Many small roots, so that there is work to share between the markers.
+  std::vector<Handle<DummyObject>> live;
+  for (size_t i = 0; i < kNumChains; ++i)
+    live.push_back(rt.makeHandle(createChain(rt, &liveFinalized)));
+  {
+    GCScopeMarkerRAII marker{rt};
+    for (size_t i = 0; i < kNumChains; ++i)
+      rt.makeHandle(createChain(rt, &deadFinalized));
+    // Move everything into the old gen while it is still reachable.
+    rt.collect();
+  }
+  ASSERT_EQ(0, deadFinalized);
+  rt.collect();
+
+  EXPECT_EQ(0, liveFinalized);
+  EXPECT_EQ(static_cast<int>(kNumChains * kChainLength), deadFinalized);
+  for (Handle<DummyObject> chain : live) {
+    size_t length = 0;
+    for (DummyObject *obj = *chain; obj; obj = obj->other.get(rt))
+      ++length;
+    EXPECT_EQ(kChainLength, length);
+  }
+
+  std::string stats;
+  llvh::raw_string_ostream os{stats};
+  rt.getHeap().printAllCollectedStats(os);
+  EXPECT_NE(std::string::npos, os.str().find("Mark thread times"));
+}
+
+} // namespace
+
+#endif // HERMESVM_GC_HADES
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifdef HERMESVM_GC_HADES
+
+#include "TestHelpers.h"
+#include "gtest/gtest.h"
+#include "hermes/VM/DummyObject.h"
+#include "hermes/VM/GC.h"
+#include "hermes/VM/GCPointer-inline.h"
+#include "hermes/VM/Handle.h"
+
+#include "llvh/Support/Format.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace hermes::vm;
+
+namespace {
+
+using testhelpers::DummyObject;
+
+/// The number of objects the workload keeps alive at any time.
+constexpr size_t kNumLive = 4096;
+/// The number of objects the workload allocates.
+constexpr size_t kNumAllocs = 120000;
+
+/// Run an allocation-heavy workload that keeps a fixed number of recently
+/// allocated objects alive, so that every young gen collection has survivors
+/// to copy and dirty cards to scan.
+/// \return the duration in milliseconds of every allocation that collected
+///   garbage.
+static std::vector<double> measurePauses(unsigned ygThreads) {
+  using Clock = std::chrono::steady_clock;
+  auto runtime = DummyRuntime::create(
+      GCConfig::Builder(kTestGCConfigBaseBuilder)
+          .withInitHeapSize(kInitHeapLarge)
+          .withMaxHeapSize(kMaxHeapLarge)
+          .withParallelYGThreads(ygThreads)
+          .build());
+  DummyRuntime &rt = *runtime;
+  GCScope scope{rt, "GCPauseBenchmarkTest", kNumLive + 8};
+
+  // Old objects that each point at a recently allocated one.
+  std::vector<Handle<DummyObject>> holders;
+  for (size_t i = 0; i < kNumLive; ++i)
+    holders.push_back(rt.makeHandle(DummyObject::create(rt.getHeap(), rt)));
+  rt.collect();
+
+  std::minstd_rand rng;
+  std::vector<double> pauses;
+  for (size_t i = 0; i < kNumAllocs; ++i) {
+    const unsigned numGCs = rt.getHeap().getNumGCs();
+    const auto start = Clock::now();
+    DummyObject *obj = DummyObject::create(rt.getHeap(), rt);
+    const auto end = Clock::now();
+    if (rt.getHeap().getNumGCs() != numGCs)
+      pauses.push_back(
+          std::chrono::duration<double, std::milli>(end - start).count());
+    if (i % 8 == 0)
+      holders[rng() % kNumLive]->setPointer(rt.getHeap(), obj);
+    // Compact the old gen part way through, so that the young gen collections
+    // that follow also evacuate the compactee.
+    if (i == kNumAllocs / 2)
+      rt.collect();
+  }
+
+  for (Handle<DummyObject> holder : holders) {
+    DummyObject *obj = holder->other.get(rt);
+    EXPECT_TRUE(!obj || obj->other.get(rt) == nullptr);
+  }
+  return pauses;
+}
+
+/// Print the distribution of \p pauses, labelled with \p name.
+static void printPauses(const char *name, std::vector<double> pauses) {
+  std::sort(pauses.begin(), pauses.end());
+  auto percentile = [&pauses](double p) {
+    return pauses[std::min(
+        pauses.size() - 1, static_cast<size_t>(p * pauses.size()))];
+  };
+  llvh::outs() << llvh::format(
+      "%-12s collections: %3zu  p50: %7.3fms  p90: %7.3fms  p99: %7.3fms  "
+      "max: %7.3fms\n",
+      name,
+      pauses.size(),
+      percentile(0.5),
+      percentile(0.9),
+      percentile(0.99),
+      pauses.back());
+}
+
+TEST(GCPauseBenchmarkTest, YoungGenPauses) {
+  const std::vector<double> serial = measurePauses(0);
+  const std::vector<double> parallel = measurePauses(3);
+  ASSERT_FALSE(serial.empty());
+  ASSERT_FALSE(parallel.empty());
+  printPauses("serial", serial);
+  printPauses("3 helpers", parallel);
+}
+
+} // namespace
+
+#endif // HERMESVM_GC_HADES
@@ -971,7 +971,7 @@ TEST_F(JSLibTest, SmallSortTest) {
        "seven",
        "eight",
        "nine"});
-  ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&sbl, 0, sbl.v.size()));
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&sbl, 0, sbl.v.size()));
   std::vector<std::string> expected = {
       "one",
       "two",
@@ -991,7 +991,7 @@ TEST_F(JSLibTest, SmallSortTest) {
     vs[i] = std::string(i, 'x');
   do {
     StringByLength sm(vs);
-    ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&sm, 0, vs.size()));
+    ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&sm, 0, vs.size()));
     for (unsigned i = 0; i < vs.size(); ++i)
       EXPECT_EQ(i, sm.v[i].size());
   } while (std::next_permutation(vs.begin(), vs.end()));
@@ -1020,7 +1020,7 @@ TEST_F(JSLibTest, HugeSortTest) {
   for (uint64_t i = 0; i < size; ++i)
     v[i] |= i;
   Uint64ByHigh32 ubh(v);
-  ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&ubh, 0, ubh.v.size()));
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&ubh, 0, ubh.v.size()));
   for (uint64_t i = 0; i < size; ++i) {
     auto cur = ubh.v[i];
     EXPECT_EQ(i / 10, cur >> 32);
@@ -1044,7 +1044,129 @@ TEST_F(JSLibTest, HugeSortTest) {
     }
   };
   RandomLess rl;
-  ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&rl, 0, 1000 * 1000));
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&rl, 0, 1000 * 1000));
+}
+
+TEST_F(JSLibTest, SortRunsTest) {
+  // Pairs of (key, original index), compared by key only.
+  struct CountingModel : public SortModel {
+    std::vector<std::pair<int, uint32_t>> v;
+    uint32_t swaps = 0;
+    uint32_t compares = 0;
+    CountingModel(const std::vector<int> &keys) {
+      for (uint32_t i = 0; i < keys.size(); ++i)
+        v.emplace_back(keys[i], i);
+    }
+    ExecutionStatus swap(uint32_t a, uint32_t b) override {
+      ++swaps;
+      std::swap(v[a], v[b]);
+      return ExecutionStatus::RETURNED;
+    }
+    CallResult<int> compare(uint32_t a, uint32_t b) override {
+      ++compares;
+      return v[a].first < v[b].first ? -1 : (v[a].first > v[b].first ? 1 : 0);
+    }
+    void expectSortedAndStable() {
+      for (uint32_t i = 1; i < v.size(); ++i) {
+        EXPECT_LE(v[i - 1].first, v[i].first);
+        if (v[i - 1].first == v[i].first)
+          EXPECT_LT(v[i - 1].second, v[i].second);
+      }
+    }
+  };
+  const uint32_t size = 10000;
+
+  // Sorted input is a single run.
+  std::vector<int> keys(size);
+  for (uint32_t i = 0; i < size; ++i)
+    keys[i] = i / 3;
+  CountingModel sorted(keys);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&sorted, 0, size));
+  sorted.expectSortedAndStable();
+  EXPECT_EQ(0u, sorted.swaps);
+  EXPECT_EQ(size - 1, sorted.compares);
+
+  // Strictly descending input is reversed in place.
+  for (uint32_t i = 0; i < size; ++i)
+    keys[i] = size - i;
+  CountingModel reversed(keys);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&reversed, 0, size));
+  reversed.expectSortedAndStable();
+  EXPECT_EQ(size / 2, reversed.swaps);
+  EXPECT_EQ(size - 1, reversed.compares);
+
+  // Descending with duplicates, which can't simply be reversed.
+  for (uint32_t i = 0; i < size; ++i)
+    keys[i] = (size - i) / 4;
+  CountingModel descendingDups(keys);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&descendingDups, 0, size));
+  descendingDups.expectSortedAndStable();
+
+  // A mix of ascending and descending runs of varying lengths, with
+  // duplicates across runs.
+  std::mt19937 rng;
+  keys.clear();
+  while (keys.size() < size) {
+    uint32_t len = rng() % 200 + 1;
+    int base = rng() % 100;
+    bool ascending = rng() % 2;
+    for (uint32_t i = 0; i < len; ++i)
+      keys.push_back(ascending ? base + i : base - i);
+  }
+  CountingModel runs(keys);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&runs, 0, keys.size()));
+  runs.expectSortedAndStable();
+
+  // The same with temporary slots, merging through them instead of by
+  // swapping.
+  struct TempModel : public CountingModel {
+    uint32_t copies = 0;
+    using CountingModel::CountingModel;
+    CallResult<hermes::OptValue<uint32_t>> reserveTemp(
+        uint32_t count) override {
+      uint32_t base = v.size();
+      v.resize(base + count);
+      return hermes::OptValue<uint32_t>{base};
+    }
+    ExecutionStatus copy(uint32_t from, uint32_t to) override {
+      ++copies;
+      v[to] = v[from];
+      return ExecutionStatus::RETURNED;
+    }
+  };
+  TempModel tempRuns(keys);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&tempRuns, 0, keys.size()));
+  tempRuns.v.resize(keys.size());
+  tempRuns.expectSortedAndStable();
+  EXPECT_NE(0u, tempRuns.copies);
+
+  // Random input with many duplicates.
+  for (auto &key : keys)
+    key = rng() % 50;
+  TempModel tempRandom(keys);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&tempRandom, 0, keys.size()));
+  tempRandom.v.resize(keys.size());
+  tempRandom.expectSortedAndStable();
+
+  // Mostly sorted input merges a few stray elements into long runs by
+  // galloping, which takes far fewer comparisons than merging one at a time.
+  keys.resize(size);
+  for (uint32_t i = 0; i < size; ++i)
+    keys[i] = i % 100 == 0 ? rng() % size : i;
+  TempModel mostlySorted(keys);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&mostlySorted, 0, size));
+  mostlySorted.v.resize(size);
+  mostlySorted.expectSortedAndStable();
+  EXPECT_GT(size * 3, mostlySorted.compares);
+
+  // Sorting a subrange leaves the rest alone.
+  std::vector<int> sub = {9, 8, 3, 1, 2, 0, -1};
+  CountingModel subrange(sub);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&subrange, 2, 5));
+  std::vector<int> subKeys;
+  for (auto &p : subrange.v)
+    subKeys.push_back(p.first);
+  EXPECT_EQ((std::vector<int>{9, 8, 1, 2, 3, 0, -1}), subKeys);
 }
 
 class JSLibMockedEnvironmentTest : public RuntimeTestFixtureBase {